@@ -170,6 +170,9 @@ int_pltfrm km_check_key(t_context *p_ctx, e_km_keyid key_id)
 	}
 	else
 	{
+#ifdef _WITH_SBRM_PROFILING_
+		sbrm_prof_mark(N_SBRM_PROF_KM_CHECK_KEY);
+#endif /* _WITH_SBRM_PROFILING_ */
 		/** First check the descriptor */
 		switch( key_id )
 		{
@@ -296,6 +299,9 @@ int_pltfrm km_check_key(t_context *p_ctx, e_km_keyid key_id)
 km_check_key_out:
 	/** Zero-ize buffer */
 	memset((void*)&key_data, 0x00, sizeof(t_key_data));
+#ifdef _WITH_SBRM_PROFILING_
+	sbrm_prof_mark(N_SBRM_PROF_KM_CHECK_KEY_END);
+#endif /* _WITH_SBRM_PROFILING_ */
 	/** End Of Function */
 	return err;
 }
@@ -57,6 +57,10 @@ extern uint_pltfrm __sbrm_free_start_addr;
 extern uint_pltfrm __sbrm_free_end_addr;
 extern uint_pltfrm __fake_otp_size;
 extern uint_pltfrm __otp_start;
+#ifdef _WITH_SBRM_PROFILING_
+/** Ring is overlaid on profile area : no scalar type for its start */
+extern uint8_t __sbr_profile_start_addr[];
+#endif /* _WITH_SBRM_PROFILING_ */
 #ifdef _FPGA_SPECIFIC_
 #endif /** _FPGA_SPECIFIC_ */
 /** Local declarations */
@@ -158,6 +162,83 @@ sbrm_init_out:
 	return err;
 }
 
+#ifdef _WITH_SBRM_PROFILING_
+/******************************************************************************/
+/** Reset profile : called first thing in main, cold or warm */
+void sbrm_prof_init(void)
+{
+	volatile t_sbrm_prof_ring					*p_ring = sbrm_prof_get_ring();
+
+	/** Initialize header */
+	p_ring->magic = C_SBRM_PROF_MAGIC;
+	p_ring->nb_entries = C_SBRM_PROF_ENTRY_NB;
+	p_ring->count = 0;
+	p_ring->reserved = 0;
+	/** First mark : time spent before main */
+	sbrm_prof_mark(N_SBRM_PROF_RESET);
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+/** Record counters at stage boundary */
+void sbrm_prof_mark(e_sbrm_prof_stage stage)
+{
+	volatile t_sbrm_prof_ring					*p_ring = sbrm_prof_get_ring();
+	volatile t_sbrm_prof_entry					*p_entry;
+	uint_pltfrm									hartid;
+	uint32_t									slot;
+	uint64_t									cycle;
+	uint64_t									instret;
+#if __riscv_xlen == 32
+	uint32_t									lo;
+	uint32_t									hi;
+	uint32_t									hi2;
+
+	/** High word must not change while low word is read */
+	do
+	{
+		M_CSR_READ(mcycleh, hi);
+		M_CSR_READ(mcycle, lo);
+		M_CSR_READ(mcycleh, hi2);
+	} while( hi != hi2 );
+	cycle = ( (uint64_t)hi << 32 ) | lo;
+	do
+	{
+		M_CSR_READ(minstreth, hi);
+		M_CSR_READ(minstret, lo);
+		M_CSR_READ(minstreth, hi2);
+	} while( hi != hi2 );
+	instret = ( (uint64_t)hi << 32 ) | lo;
+#else
+	M_CSR_READ(mcycle, cycle);
+	M_CSR_READ(minstret, instret);
+#endif /* __riscv_xlen */
+	M_CSR_READ(mhartid, hartid);
+	/** Profile not initialized yet : drop mark */
+	if( C_SBRM_PROF_MAGIC != p_ring->magic )
+	{
+		return;
+	}
+	/** Harts may mark at once : each one claims its own slot */
+	slot = __atomic_fetch_add(&p_ring->count, 1, __ATOMIC_RELAXED);
+	p_entry = &p_ring->entry[slot % C_SBRM_PROF_ENTRY_NB];
+	p_entry->stage = (uint32_t)stage;
+	p_entry->hartid = (uint32_t)hartid;
+	p_entry->mcycle = cycle;
+	p_entry->minstret = instret;
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+volatile t_sbrm_prof_ring *sbrm_prof_get_ring(void)
+{
+	/** Fixed location, shared with FSBL */
+	return (volatile t_sbrm_prof_ring*)__sbr_profile_start_addr;
+}
+#endif /* _WITH_SBRM_PROFILING_ */
+
 /******************************************************************************/
 __attribute__((noreturn)) void sbrm_shutdown(void *p_ctx)
 {
@@ -341,7 +422,7 @@ int_pltfrm sbrm_get_sbr_ref_version(uint32_t *p_version)
 }
 
 /******************************************************************************/
-__attribute__((naked)) void sbrm_platform_reset(t_context *p_ctx)
+M_NAKED void sbrm_platform_reset(t_context *p_ctx)
 {
 	/** Zero-ize contexts */
 	if ( !p_ctx )
@@ -349,7 +430,10 @@ __attribute__((naked)) void sbrm_platform_reset(t_context *p_ctx)
 		sbrm_erase_contexts(p_ctx);
 	}
 	/** Ask for platform reset */
-
+#ifdef _HOST_NATIVE_
+	/** Host build : process ends, as platform would restart */
+	metal_host_reset();
+#endif /* _HOST_NATIVE_ */
 	/** Endless loop - shouldn't be needed */
 	while( 1 );
 	/** End Of Function */
@@ -357,7 +441,7 @@ __attribute__((naked)) void sbrm_platform_reset(t_context *p_ctx)
 }
 
 /******************************************************************************/
-__attribute__((naked)) void sbrm_platform_shutdown(t_context *p_ctx)
+M_NAKED void sbrm_platform_shutdown(t_context *p_ctx)
 {
 	/** Zero-ize contexts */
 	if ( !p_ctx )
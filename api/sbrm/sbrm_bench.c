@@ -0,0 +1,678 @@
+/******************************************************************************
+ *
+ * Secure BootRom (SBR)
+ *
+ ******************************************************************************
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+
+/**
+ * @file sbrm_bench.c
+ * @brief Microbenchmarks of cryptographic and I/O primitives
+ *
+ * @copyright Copyright (c) 2020 SiFive, Inc
+ * @copyright SPDX-License-Identifier: MIT
+ */
+
+
+/** Global includes */
+#include <stdio.h>
+#include <string.h>
+#include <common.h>
+#include <errors.h>
+#include <memory.h>
+/** Other includes */
+#include <api/scl_api.h>
+#include <api/hardware/scl_hca.h>
+#include <api/hash/sha.h>
+#include <km.h>
+#include <sp.h>
+#include <sp_internal.h>
+#include <slbv.h>
+#include <slbv_internal.h>
+/** Local includes */
+#include <sbrm.h>
+#include <sbrm_internal.h>
+
+#ifdef _WITH_SBRM_BENCH_
+/** External declarations */
+extern t_slbv_context slbv_context;
+extern t_sp_context sp_context;
+extern uint32_t __qspi_start;
+/** Local declarations */
+/** Benchmark root key and public key chain - ECDSA384 ***********************/
+/** Generated with openssl, secp384r1 curve and SHA-384 : each certificate is
+ * public key X||Y then signature R||S of X||Y by previous key */
+__attribute__((section(".rodata"))) const uint8_t bench_root_key[2 * C_EDCSA384_SIZE] =
+{
+	0x69, 0xef, 0xb4, 0xfb, 0x9f, 0xd4, 0xe8, 0x47, 0xd6, 0x10, 0x45, 0x27,
+	0x47, 0x8a, 0x13, 0x39, 0x0f, 0xf1, 0x1c, 0xcf, 0x4b, 0x6d, 0x44, 0xcc,
+	0x92, 0x89, 0xe3, 0x60, 0x63, 0xfb, 0x53, 0x8e, 0xba, 0x7c, 0x2c, 0x0d,
+	0xf9, 0x94, 0xed, 0x69, 0x08, 0x33, 0x2f, 0xc1, 0x61, 0x51, 0x89, 0x3d,
+	0xe4, 0x88, 0x65, 0xc1, 0xd2, 0xf6, 0x3e, 0xb7, 0x65, 0x1c, 0x02, 0xaf,
+	0x77, 0x6f, 0x3b, 0xb6, 0x3e, 0xf4, 0xc7, 0xc2, 0x25, 0xeb, 0x6c, 0xb3,
+	0xb9, 0x74, 0x2e, 0x88, 0xc5, 0xd6, 0x84, 0xb3, 0x34, 0x38, 0x97, 0x09,
+	0xbe, 0xa3, 0x97, 0x89, 0x73, 0x81, 0xa9, 0xe8, 0xfa, 0x02, 0x47, 0x42
+};
+__attribute__((section(".rodata"))) const uint8_t bench_pkchain[C_SBRM_BENCH_PKCHAIN_NB * 4 * C_EDCSA384_SIZE] =
+{
+	0x2f, 0xa2, 0x84, 0x80, 0x99, 0xbd, 0x42, 0xea, 0x9f, 0x54, 0x76, 0xfd,
+	0xbc, 0xd9, 0x26, 0xc0, 0x66, 0x59, 0x6e, 0x01, 0xad, 0xc8, 0x8d, 0x8e,
+	0xd7, 0xa2, 0x4b, 0xe7, 0xce, 0x2c, 0x44, 0x10, 0x3d, 0x94, 0x6e, 0x49,
+	0xee, 0x07, 0x24, 0xdb, 0x65, 0xa6, 0x38, 0x3f, 0xa7, 0xaf, 0xaa, 0x43,
+	0xd5, 0x09, 0xef, 0x3c, 0x7b, 0x39, 0x89, 0x63, 0x3c, 0xe3, 0xdc, 0xa6,
+	0xc6, 0x00, 0x7c, 0x96, 0x7f, 0xd9, 0x02, 0x67, 0x90, 0x3f, 0x8a, 0x5f,
+	0xc1, 0x4c, 0x33, 0x46, 0x59, 0xeb, 0x18, 0xc6, 0x25, 0x10, 0xb1, 0xf4,
+	0x03, 0x88, 0xeb, 0x04, 0x34, 0x6f, 0xc9, 0x84, 0xa3, 0x54, 0x2f, 0x28,
+	0x41, 0x24, 0xb5, 0xec, 0x2d, 0xfd, 0x2e, 0xfc, 0xf9, 0x09, 0xb6, 0x83,
+	0x51, 0xf0, 0xfd, 0xb9, 0xf5, 0x30, 0x99, 0x99, 0xa3, 0xf6, 0x77, 0xc4,
+	0x8f, 0xfa, 0xe9, 0x71, 0x9a, 0xec, 0x5a, 0x9f, 0xab, 0x27, 0x5f, 0xc1,
+	0x3f, 0xa7, 0x36, 0x84, 0x40, 0x70, 0x28, 0x1d, 0x68, 0x42, 0xe4, 0xd8,
+	0x6b, 0x78, 0x74, 0x70, 0xd1, 0x9e, 0xe3, 0x86, 0x0d, 0xd4, 0x27, 0xdf,
+	0x2e, 0x7d, 0x69, 0xfa, 0x86, 0x82, 0x4b, 0xd0, 0x0e, 0x7e, 0x2a, 0x5a,
+	0x60, 0xb4, 0x52, 0xf1, 0x0e, 0x19, 0x8c, 0xd6, 0x33, 0x02, 0xc5, 0xf2,
+	0x02, 0x53, 0x9b, 0xcf, 0x7b, 0x37, 0xb4, 0x8a, 0x6d, 0xd3, 0x27, 0x03,
+	0x1f, 0x18, 0x44, 0x9f, 0x68, 0x30, 0x62, 0xf2, 0xe7, 0x00, 0x16, 0xfc,
+	0x03, 0xcd, 0x9e, 0x22, 0x2e, 0x2c, 0xe3, 0xad, 0x76, 0x10, 0x7c, 0x47,
+	0xe6, 0xfb, 0x9f, 0x4e, 0xfb, 0x0d, 0xfe, 0xc6, 0x48, 0xf9, 0x46, 0xc2,
+	0xfa, 0xbe, 0xb4, 0x2a, 0x29, 0x82, 0x43, 0x95, 0x67, 0xd1, 0x20, 0x84,
+	0x3b, 0x0e, 0x37, 0x58, 0xd7, 0x88, 0x71, 0x20, 0x5e, 0xed, 0x89, 0x03,
+	0x86, 0x48, 0x0d, 0x06, 0xbc, 0x1c, 0xf1, 0x6f, 0x6f, 0xa9, 0x5d, 0xc7,
+	0xfb, 0x81, 0xc1, 0x34, 0xf7, 0x4f, 0x75, 0x6a, 0xe9, 0xad, 0x16, 0x89,
+	0x3e, 0x77, 0x57, 0x2d, 0xb7, 0x29, 0x92, 0x97, 0x0c, 0x6f, 0x80, 0x48,
+	0x5a, 0x22, 0xee, 0x82, 0x38, 0xc3, 0x15, 0xf3, 0x3f, 0xab, 0x01, 0xc2,
+	0x59, 0x16, 0x5f, 0x41, 0xc0, 0xb6, 0xb3, 0xe7, 0xef, 0x38, 0xeb, 0x15,
+	0x7e, 0x6f, 0x3e, 0xe4, 0x12, 0x31, 0x4c, 0x38, 0xb6, 0x57, 0xba, 0xf0,
+	0x10, 0x09, 0x3c, 0xce, 0xef, 0x6a, 0xb4, 0xd1, 0x32, 0x33, 0x70, 0xc7,
+	0xc3, 0x47, 0xd7, 0x27, 0x0e, 0x52, 0xea, 0xf3, 0x05, 0xa7, 0x3f, 0x60,
+	0x84, 0xf9, 0x75, 0xfd, 0x52, 0xc6, 0xea, 0x8d, 0x10, 0x63, 0xf2, 0x84,
+	0xec, 0xf4, 0x11, 0x40, 0x73, 0x28, 0x34, 0x57, 0x6e, 0x98, 0x8c, 0x30,
+	0xe3, 0x46, 0x16, 0x76, 0x88, 0xdc, 0x27, 0xdb, 0x36, 0xc2, 0x0e, 0xd5,
+	0x9a, 0x18, 0xfc, 0x92, 0x88, 0xaf, 0x0e, 0x7c, 0xa5, 0xb7, 0x67, 0xf2,
+	0xc9, 0x73, 0x46, 0x36, 0x12, 0xe6, 0xee, 0xb7, 0x00, 0x3d, 0x27, 0x2a,
+	0x84, 0x3f, 0xe5, 0xe6, 0x23, 0x31, 0xb3, 0x01, 0xa0, 0xe1, 0xf2, 0xf3,
+	0x1f, 0x63, 0x1d, 0xff, 0x2a, 0x23, 0x1f, 0x19, 0xd9, 0xdb, 0x95, 0x6c,
+	0x1a, 0x94, 0x8c, 0xd2, 0x3a, 0x30, 0x09, 0xae, 0x15, 0xc3, 0x12, 0x83,
+	0x02, 0x92, 0x6e, 0xe4, 0x8f, 0x88, 0x4d, 0x97, 0x3d, 0xd9, 0x7b, 0x7f,
+	0x41, 0xdc, 0xb9, 0xb1, 0x34, 0x93, 0x70, 0xa0, 0xfc, 0x67, 0x1d, 0xe5,
+	0xe7, 0xbb, 0x03, 0xa7, 0x9f, 0x10, 0x16, 0x40, 0x50, 0x9e, 0x54, 0x5d,
+	0xa9, 0xb5, 0x90, 0xc5, 0xfd, 0x2e, 0x36, 0x99, 0x2c, 0x14, 0xbd, 0x90,
+	0x3c, 0xff, 0x9b, 0x6e, 0x16, 0x8d, 0x42, 0x7f, 0x40, 0x6c, 0x0d, 0xe3,
+	0xe4, 0x49, 0xbf, 0x09, 0x4f, 0x8c, 0x10, 0x0a, 0xcd, 0xe7, 0x36, 0x25,
+	0xf7, 0xf9, 0x7c, 0xfe, 0xfc, 0xde, 0x09, 0x4f, 0x74, 0x59, 0xc0, 0x95,
+	0xf5, 0xba, 0xcf, 0xbb, 0xd6, 0xd7, 0x2c, 0xf2, 0x67, 0x96, 0x57, 0x22,
+	0x8f, 0xcd, 0xd2, 0x26, 0x15, 0x75, 0xb6, 0x52, 0x2c, 0xc7, 0x1c, 0x3d,
+	0xcb, 0x91, 0x00, 0x11, 0x50, 0xe7, 0xd6, 0xe8, 0x00, 0x63, 0x91, 0x7a,
+	0x75, 0x52, 0x23, 0x88, 0x0a, 0xca, 0xa7, 0x00, 0x05, 0xca, 0x76, 0x60
+};
+/** Variants names */
+__attribute__((section(".rodata"))) const char *const bench_key_name[C_SBRM_BENCH_SIGN_KEY_NB] =
+{
+	"root",
+	"ssk",
+	"csk"
+};
+__attribute__((section(".rodata"))) const char *const bench_pkchain_name[C_SBRM_BENCH_PKCHAIN_NB] =
+{
+	"1cert",
+	"2certs",
+	"3certs"
+};
+
+/******************************************************************************/
+uint64_t sbrm_bench_now(void)
+{
+	uint64_t									cycle;
+#if __riscv_xlen == 32
+	uint32_t									lo;
+	uint32_t									hi;
+	uint32_t									hi2;
+
+	/** High word must not change while low word is read */
+	do
+	{
+		M_CSR_READ(mcycleh, hi);
+		M_CSR_READ(mcycle, lo);
+		M_CSR_READ(mcycleh, hi2);
+	} while( hi != hi2 );
+	cycle = ( (uint64_t)hi << 32 ) | lo;
+#else
+	M_CSR_READ(mcycle, cycle);
+#endif /* __riscv_xlen */
+	/** End Of Function */
+	return cycle;
+}
+
+/******************************************************************************/
+void sbrm_bench_init(t_sbrm_bench_measure *p_measure, const char *p_name, const char *p_variant, uint32_t size)
+{
+	/** Check input pointer */
+	if( p_measure )
+	{
+		/** No sample yet */
+		memset((void*)p_measure, 0x00, sizeof(t_sbrm_bench_measure));
+		p_measure->p_name = p_name;
+		p_measure->p_variant = p_variant;
+		p_measure->size = size;
+		p_measure->err = GENERIC_ERR_UNKNOWN;
+	}
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+void sbrm_bench_add(t_sbrm_bench_measure *p_measure, uint64_t start, uint64_t stop)
+{
+	/** Check input pointer, and keep first samples only */
+	if( p_measure && ( C_SBRM_BENCH_ITER_NB > p_measure->nb ) )
+	{
+		/** Append sample */
+		p_measure->sample[p_measure->nb] = stop - start;
+		p_measure->nb++;
+	}
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+uint64_t sbrm_bench_percentile(t_sbrm_bench_measure *p_measure, uint32_t percent)
+{
+	uint32_t									rank;
+
+	/** Check input pointer */
+	if( !p_measure || !p_measure->nb )
+	{
+		/** Nothing measured */
+		return 0;
+	}
+	/** Nearest rank, samples are sorted */
+	rank = ( ( percent * p_measure->nb ) + 99 ) / 100;
+	if( !rank )
+	{
+		/** Lowest sample */
+		rank = 1;
+	}
+	/** End Of Function */
+	return p_measure->sample[rank - 1];
+}
+
+/******************************************************************************/
+char *sbrm_bench_u64_to_str(uint64_t value, char *p_str)
+{
+	char										*p_digit = p_str + C_SBRM_BENCH_U64_DIGITS - 1;
+
+	/** Terminate string, then fill from least significant digit */
+	*p_digit = '\0';
+	do
+	{
+		*(--p_digit) = (char)( '0' + ( value % 10 ) );
+		value /= 10;
+	} while( value );
+	/** End Of Function */
+	return p_digit;
+}
+
+/******************************************************************************/
+void sbrm_bench_report(t_sbrm_bench_measure *p_measure)
+{
+	uint32_t									i;
+	uint32_t									j;
+	uint64_t									tmp;
+	uint64_t									p50;
+	/** No 64 bits conversion in printf of nano library, values are printed as strings */
+	char										str[6][C_SBRM_BENCH_U64_DIGITS];
+
+	/** Check input pointer */
+	if( !p_measure )
+	{
+		return;
+	}
+	/** Sort samples - insertion sort, there are only a few of them */
+	for( i = 1;i < p_measure->nb;i++ )
+	{
+		tmp = p_measure->sample[i];
+		for( j = i;j && ( p_measure->sample[j - 1] > tmp );j-- )
+		{
+			p_measure->sample[j] = p_measure->sample[j - 1];
+		}
+		p_measure->sample[j] = tmp;
+	}
+	p50 = sbrm_bench_percentile(p_measure, 50);
+	/** One JSON record per line */
+	printf("{\"bench\":\"%s\",\"variant\":\"%s\",\"size\":%u,\"nb\":%u,\"err\":%ld,\"unit\":\"%s\","
+			"\"min\":%s,\"p50\":%s,\"p90\":%s,\"p99\":%s,\"max\":%s,\"per_byte_x100\":%s}\n",
+			p_measure->p_name,
+			p_measure->p_variant,
+			(unsigned int)p_measure->size,
+			(unsigned int)p_measure->nb,
+			(long)p_measure->err,
+			C_SBRM_BENCH_UNIT,
+			sbrm_bench_u64_to_str(sbrm_bench_percentile(p_measure, 0), str[0]),
+			sbrm_bench_u64_to_str(p50, str[1]),
+			sbrm_bench_u64_to_str(sbrm_bench_percentile(p_measure, 90), str[2]),
+			sbrm_bench_u64_to_str(sbrm_bench_percentile(p_measure, 99), str[3]),
+			sbrm_bench_u64_to_str(sbrm_bench_percentile(p_measure, 100), str[4]),
+			sbrm_bench_u64_to_str(p_measure->size ? ( ( 100 * p50 ) / p_measure->size ) : 0, str[5]));
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+int_pltfrm sbrm_bench_crc(t_context *p_ctx)
+{
+	uint32_t									i;
+	uint32_t									size;
+	uint32_t									crc;
+	uint64_t									start;
+	uint8_t										*p_buffer;
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	t_sbrm_bench_measure						measure;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto sbrm_bench_crc_out;
+	}
+	else if( ( p_ctx->free_ram_end - p_ctx->free_ram_start ) < C_SBRM_BENCH_BUF_SIZE_MAX )
+	{
+		/** Not enough room for buffer */
+		err = GENERIC_ERR_INVAL;
+		goto sbrm_bench_crc_out;
+	}
+	/** Data buffer in free RAM */
+	p_buffer = (uint8_t*)p_ctx->free_ram_start;
+	for( i = 0;i < C_SBRM_BENCH_BUF_SIZE_MAX;i++ )
+	{
+		p_buffer[i] = (uint8_t)i;
+	}
+	for( size = C_SBRM_BENCH_BUF_SIZE_MIN;size <= C_SBRM_BENCH_BUF_SIZE_MAX;size <<= 2 )
+	{
+		sbrm_bench_init(&measure, "crc32", "table", size);
+		for( i = 0;i < C_SBRM_BENCH_ITER_NB;i++ )
+		{
+			start = sbrm_bench_now();
+			measure.err = sbrm_compute_crc(&crc, p_buffer, size);
+			sbrm_bench_add(&measure, start, sbrm_bench_now());
+		}
+		sbrm_bench_report(&measure);
+	}
+	/** No error */
+	err = NO_ERROR;
+sbrm_bench_crc_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm sbrm_bench_hash(t_context *p_ctx)
+{
+	uint32_t									i;
+	uint32_t									size;
+	size_t										hash_len;
+	uint64_t									start;
+	uint8_t										*p_buffer;
+	uint8_t										hash[C_EDCSA384_SIZE];
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	t_sbrm_bench_measure						measure;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto sbrm_bench_hash_out;
+	}
+	else if( ( p_ctx->free_ram_end - p_ctx->free_ram_start ) < C_SBRM_BENCH_BUF_SIZE_MAX )
+	{
+		/** Not enough room for buffer */
+		err = GENERIC_ERR_INVAL;
+		goto sbrm_bench_hash_out;
+	}
+	/** Data buffer in free RAM, filled by CRC benchmark */
+	p_buffer = (uint8_t*)p_ctx->free_ram_start;
+	for( size = C_SBRM_BENCH_BUF_SIZE_MIN;size <= C_SBRM_BENCH_BUF_SIZE_MAX;size <<= 2 )
+	{
+		sbrm_bench_init(&measure, "km_verify_hash", "sha384", size);
+		/** Expected hash, so that verification goes up to comparison */
+		hash_len = sizeof(hash);
+		measure.err = scl_sha((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+								SCL_HASH_SHA384,
+								p_buffer,
+								size,
+								hash,
+								&hash_len);
+		for( i = 0;( SCL_OK == measure.err ) && ( i < C_SBRM_BENCH_ITER_NB );i++ )
+		{
+			start = sbrm_bench_now();
+			measure.err = km_verify_hash(p_ctx, p_buffer, size, hash);
+			sbrm_bench_add(&measure, start, sbrm_bench_now());
+		}
+		sbrm_bench_report(&measure);
+	}
+	/** No error */
+	err = NO_ERROR;
+sbrm_bench_hash_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm sbrm_bench_signature(t_context *p_ctx)
+{
+	uint32_t									i;
+	uint32_t									k;
+	uint32_t									tmp;
+	uint64_t									start;
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	t_km_key									key;
+	t_key_data									key_data;
+	t_sbrm_bench_measure						measure;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto sbrm_bench_signature_out;
+	}
+	/** First certificate of chain is message and signature, for all keys : only
+	 * bench root key verifies it, other ones fail at same cost */
+	for( k = 0;k < C_SBRM_BENCH_SIGN_KEY_NB;k++ )
+	{
+		/** Initialize key buffer */
+		memset((void*)&key_data, 0x00, sizeof(t_key_data));
+		/** Assign pointers */
+		key.p_descriptor = (uint32_t*)&key_data.algo;
+		key.ecdsa.p_x = (uint8_t*)key_data.key;
+		key.ecdsa.p_y = key.ecdsa.p_x + C_EDCSA384_SIZE;
+		key.certificate.p_x = (uint8_t*)key_data.certificate;
+		key.certificate.p_y = key.certificate.p_x + C_EDCSA384_SIZE;
+		sbrm_bench_init(&measure, "km_verify_signature", bench_key_name[k], 2 * C_EDCSA384_SIZE);
+		switch( k )
+		{
+			case 0:
+				memcpy((void*)key_data.key, (const void*)bench_root_key, sizeof(bench_root_key));
+				measure.err = NO_ERROR;
+				break;
+			case 1:
+				measure.err = km_get_key(p_ctx, N_KM_KEYID_SSK, &key, &tmp);
+				break;
+			case 2:
+				measure.err = km_get_key(p_ctx, N_KM_KEYID_CSK, &key, &tmp);
+				break;
+			default:
+				err = GENERIC_ERR_CRITICAL;
+				goto sbrm_bench_signature_out;
+		}
+		/** Key not available : reported as is */
+		if( NO_ERROR == measure.err )
+		{
+			for( i = 0;i < C_SBRM_BENCH_ITER_SLOW_NB;i++ )
+			{
+				start = sbrm_bench_now();
+				measure.err = km_verify_signature(p_ctx,
+													(uint8_t*)bench_pkchain,
+													(uint32_t)( 2 * C_EDCSA384_SIZE ),
+													(uint8_t*)&bench_pkchain[2 * C_EDCSA384_SIZE],
+													N_KM_ALGO_ECDSA384,
+													key);
+				sbrm_bench_add(&measure, start, sbrm_bench_now());
+			}
+		}
+		sbrm_bench_report(&measure);
+	}
+	/** No error */
+	err = NO_ERROR;
+sbrm_bench_signature_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm sbrm_bench_pkchain(t_context *p_ctx)
+{
+	uint32_t									i;
+	uint32_t									nb_certs;
+	uint64_t									start;
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	t_km_key									key_cert;
+	t_sbrm_bench_measure						measure;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto sbrm_bench_pkchain_out;
+	}
+	for( nb_certs = 1;nb_certs <= C_SBRM_BENCH_PKCHAIN_NB;nb_certs++ )
+	{
+		sbrm_bench_init(&measure,
+						"sp_sup_check_pkchain",
+						bench_pkchain_name[nb_certs - 1],
+						nb_certs * 4 * C_EDCSA384_SIZE);
+		measure.err = NO_ERROR;
+		for( i = 0;( NO_ERROR == measure.err ) && ( i < C_SBRM_BENCH_ITER_SLOW_NB );i++ )
+		{
+			/** Chain is checked from bench root key, reference key is updated by call */
+			memset((void*)&key_cert, 0x00, sizeof(t_km_key));
+			key_cert.ecdsa.p_x = (uint8_t*)bench_root_key;
+			key_cert.ecdsa.p_y = key_cert.ecdsa.p_x + C_EDCSA384_SIZE;
+			start = sbrm_bench_now();
+			measure.err = sp_sup_check_pkchain(p_ctx, (uint8_t*)bench_pkchain, nb_certs, &key_cert);
+			sbrm_bench_add(&measure, start, sbrm_bench_now());
+		}
+		sbrm_bench_report(&measure);
+	}
+	/** No error */
+	err = NO_ERROR;
+sbrm_bench_pkchain_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm sbrm_bench_slb(t_context *p_ctx)
+{
+	uint32_t									i;
+	uint32_t									size;
+	uint64_t									start;
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	t_sbrm_bench_measure						measure;
+#ifdef _HOST_NATIVE_
+	uint_pltfrm									addr;
+	volatile t_secure_header					*p_hdr;
+#endif /* _HOST_NATIVE_ */
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto sbrm_bench_slb_out;
+	}
+	/** First call locates boot area */
+	(void)slbv_check_slb(p_ctx, N_SLBV_SLB_ID_E31);
+	if( !slbv_context.p_hdr )
+	{
+		/** No boot area */
+		err = N_SLBV_ERR_INVAL;
+		goto sbrm_bench_slb_out;
+	}
+#ifdef _HOST_NATIVE_
+	/** Boot device is RAM backed : images of increasing size are written at
+	 * boot address. Signature is not valid, so verification stops once image
+	 * is hashed, with CSK provisioned */
+	p_hdr = slbv_context.p_hdr;
+	for( size = C_SBRM_BENCH_SLB_SIZE_MIN;size <= C_SBRM_BENCH_SLB_SIZE_MAX;size <<= 1 )
+	{
+		/** Build XiP header */
+		memset((void*)p_hdr, C_PATTERN_VIRGIN_8BITS, sizeof(t_secure_header));
+		p_hdr->magic_word1 = C_SFLV_MAGIC_WORD1;
+		p_hdr->magic_word2 = C_SFLV_MAGIC_WORD2;
+		p_hdr->appli_type = N_SLBV_APP_TYPE_REGULAR;
+		p_hdr->address_size = C_SEC_HDR_ADDRESS_SIZE_64BITS;
+		p_hdr->secure_appli_image_size = size;
+		p_hdr->fimware_start_offset = sizeof(t_secure_header);
+		/** Execution address at beginning of boot device */
+		addr = (uint_pltfrm)&__qspi_start;
+		memcpy((void*)p_hdr->execution_address, (const void*)&addr, sizeof(uint_pltfrm));
+		p_hdr->algo = N_KM_ALGO_ECDSA384;
+		p_hdr->nb_signatures = C_SEC_HDR_ONE_SIGNATURE;
+		p_hdr->sign_keyid_1 = N_KM_KEYID_CSK;
+		p_hdr->signature_size_bits = C_EDCSA384_SIZE_BITS;
+		memcpy((void*)p_hdr->signature, (const void*)&bench_pkchain[2 * C_EDCSA384_SIZE], 2 * C_EDCSA384_SIZE);
+		sbrm_bench_init(&measure, "slbv_check_slb", "xip", size);
+		for( i = 0;i < C_SBRM_BENCH_ITER_SLOW_NB;i++ )
+		{
+			start = sbrm_bench_now();
+			measure.err = slbv_check_slb(p_ctx, N_SLBV_SLB_ID_E31);
+			sbrm_bench_add(&measure, start, sbrm_bench_now());
+		}
+		sbrm_bench_report(&measure);
+	}
+#else
+	/** Boot device is flash : image in place is measured */
+	size = ( C_SFLV_MAGIC_WORD1 == slbv_context.p_hdr->magic_word1 ) ? slbv_context.p_hdr->secure_appli_image_size : 0;
+	sbrm_bench_init(&measure, "slbv_check_slb", "in_place", size);
+	for( i = 0;i < C_SBRM_BENCH_ITER_SLOW_NB;i++ )
+	{
+		start = sbrm_bench_now();
+		measure.err = slbv_check_slb(p_ctx, N_SLBV_SLB_ID_E31);
+		sbrm_bench_add(&measure, start, sbrm_bench_now());
+	}
+	sbrm_bench_report(&measure);
+#endif /* _HOST_NATIVE_ */
+	/** No error */
+	err = NO_ERROR;
+sbrm_bench_slb_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm sbrm_bench_sup_rx(t_context *p_ctx)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+#if defined(_WITH_SUP_LOOPBACK_) && defined(_HOST_NATIVE_)
+	uint32_t									i;
+	uint32_t									size;
+	uint64_t									start;
+	uint8_t										*p_capture;
+	t_sbrm_bench_measure						measure;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto sbrm_bench_sup_rx_out;
+	}
+	/** Canned capture of SUP session, given as UART input */
+	size = metal_host_uart_rx(&p_capture);
+	sbrm_bench_init(&measure, "sp_sup_receive_packet", "capture", size);
+	if( !size )
+	{
+		/** Nothing to replay */
+		measure.err = GENERIC_ERR_INVAL;
+	}
+	else
+	{
+		/** Open loopback port */
+		measure.err = sp_sup_initialize_communication(p_ctx);
+	}
+	for( i = 0;( NO_ERROR == measure.err ) && ( i < C_SBRM_BENCH_ITER_NB );i++ )
+	{
+		/** Replay capture from its beginning : first packet is received */
+		sp_context.sup.first_pkt = TRUE;
+		sp_loopback_feed(p_capture, size);
+		start = sbrm_bench_now();
+		measure.err = sp_sup_receive_packet((void*)p_ctx);
+		sbrm_bench_add(&measure, start, sbrm_bench_now());
+	}
+	sbrm_bench_report(&measure);
+	/** No error */
+	err = NO_ERROR;
+sbrm_bench_sup_rx_out:
+#else
+	/** No way to feed a capture */
+	err = NO_ERROR;
+#endif /* _WITH_SUP_LOOPBACK_ && _HOST_NATIVE_ */
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm sbrm_bench_run(t_context *p_ctx)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto sbrm_bench_run_out;
+	}
+	/** Header record */
+	printf("{\"bench\":\"info\",\"rom\":\"%u.%u.%u\",\"unit\":\"%s\",\"iter\":%u,\"iter_slow\":%u}\n",
+			(unsigned int)SBR_VERSION_MAJOR,
+			(unsigned int)SBR_VERSION_MINOR,
+			(unsigned int)SBR_VERSION_EDIT,
+			C_SBRM_BENCH_UNIT,
+			(unsigned int)C_SBRM_BENCH_ITER_NB,
+			(unsigned int)C_SBRM_BENCH_ITER_SLOW_NB);
+	/** Primitives first, then boot image check and SUP reception */
+	err = sbrm_bench_crc(p_ctx);
+	if( err )
+	{
+		goto sbrm_bench_run_out;
+	}
+	err = sbrm_bench_hash(p_ctx);
+	if( err )
+	{
+		goto sbrm_bench_run_out;
+	}
+	err = sbrm_bench_signature(p_ctx);
+	if( err )
+	{
+		goto sbrm_bench_run_out;
+	}
+	err = sbrm_bench_pkchain(p_ctx);
+	if( err )
+	{
+		goto sbrm_bench_run_out;
+	}
+	err = sbrm_bench_slb(p_ctx);
+	if( err )
+	{
+		goto sbrm_bench_run_out;
+	}
+	err = sbrm_bench_sup_rx(p_ctx);
+sbrm_bench_run_out:
+	/** End Of Function */
+	return err;
+}
+#endif /* _WITH_SBRM_BENCH_ */
+
+/******************************************************************************/
+
+/* End Of File */
@@ -484,6 +484,16 @@ int_pltfrm sbrm_selftest(t_context *p_ctx)
 		err = GENERIC_ERR_NULL_PTR;
 		goto sbrm_selftest_out;
 	}
+#ifdef _WITH_SLBV_ENCRYPTED_IMAGE_
+	/** Known-answer tests of image decryption */
+	err = slbv_aes_selftest(p_ctx);
+	if ( err )
+	{
+		/** AES tests failed, can't trust platform */
+		err = N_SBRM_ERR_AES_TEST_FAILURE;
+		goto sbrm_selftest_out;
+	}
+#endif /* _WITH_SLBV_ENCRYPTED_IMAGE_ */
 //	/** Call KM module initialization function, it's where SCL initialization
 //	 * is located */
 //	err = p_ctx->p_km_fct_ptr->initialize_fct(p_ctx, NULL, 0);
@@ -41,12 +41,18 @@
 /** Other includes */
 #include <api/scl_api.h>
 #include <api/hardware/scl_hca.h>
+#ifdef _WITH_SLBV_MULTI_HART_
+#include <api/software/scl_soft.h>
+#endif /* _WITH_SLBV_MULTI_HART_ */
 #include <api/hash/sha.h>
 #include <api/asymmetric/ecc/ecc.h>
 #include <api/asymmetric/ecc/ecdsa.h>
 #include <scl/scl_ecdsa.h>
 #include <km.h>
 #include <sbrm.h>
+#ifdef _WITH_SLBV_AB_SLOTS_
+#include <sbrm_internal.h>
+#endif /* _WITH_SLBV_AB_SLOTS_ */
 #include <slbv.h>
 #include <slbv_internal.h>
 
@@ -56,9 +62,28 @@ extern uint32_t __qspi_start;
 extern uint32_t __qspi_size;
 extern uint32_t	__sbr_free_start_addr;
 extern uint32_t __sbr_free_end_addr;
+#if defined(_WITH_SLBV_INCREMENTAL_) || defined(_WITH_SLBV_WARM_RESET_)
+/** Records are overlaid on retention area : no scalar type for its bounds */
+extern uint8_t __sbr_retention_start_addr[];
+extern uint8_t __sbr_retention_end_addr[];
+#endif /* _WITH_SLBV_INCREMENTAL_ || _WITH_SLBV_WARM_RESET_ */
+#ifdef _WITH_SLBV_EMMC_
+/** RAM area eMMC image is staged into */
+extern uint32_t __emmc_stage_start_addr;
+extern uint32_t __emmc_stage_end_addr;
+#endif /* _WITH_SLBV_EMMC_ */
 
 /** Local declarations */
 __attribute__((section(".bss"))) t_slbv_context slbv_context;
+#ifdef _WITH_SLBV_MULTI_HART_
+/** Work descriptors, one per hart */
+__attribute__((section(".bss"))) volatile t_slbv_hart_work slbv_hart_work[C_SLBV_HART_NB_MAX];
+/** Harts that did not complete their share in time, left out for the rest of boot */
+__attribute__((section(".bss"))) volatile uint8_t slbv_hart_lost[C_SLBV_HART_NB_MAX];
+/** Per hart SHA contexts and shared software SCL configuration */
+__attribute__((section(".bss"),aligned(0x10))) scl_sha_ctx_t slbv_hart_sha_ctx[C_SLBV_HART_NB_MAX];
+__attribute__((section(".bss"))) metal_scl_t slbv_hart_scl;
+#endif /* _WITH_SLBV_MULTI_HART_ */
 
 /******************************************************************************/
 int_pltfrm slbv_init(void *p_ctx, void *p_in, uint32_t length_in)
@@ -100,6 +125,9 @@ int_pltfrm slbv_shutdown(void *p_ctx)
 int_pltfrm slbv_process(t_context *p_ctx)
 {
 	int32_t										err = GENERIC_ERR_UNKNOWN;
+#ifdef _WITH_SLBV_AB_SLOTS_
+	uint32_t									i;
+#endif /* _WITH_SLBV_AB_SLOTS_ */
 
 	/** Check input pointer */
 	if( !p_ctx )
@@ -109,10 +137,58 @@ int_pltfrm slbv_process(t_context *p_ctx)
 	}
 	else
 	{
+#ifdef _WITH_SLBV_WARM_RESET_
+		/** Cold path : former verified boot state is void until sealed again */
+		((volatile t_slbv_warm_record*)( (uint_pltfrm)__sbr_retention_end_addr - sizeof(t_slbv_warm_record) ))->magic = 0;
+#endif /* _WITH_SLBV_WARM_RESET_ */
+#ifdef _WITH_SLBV_AB_SLOTS_
+		/** Order slots, headers obviously wrong are discarded without hashing anything */
+		err = slbv_ab_select(p_ctx);
+		for( i = 0;( NO_ERROR == err ) && ( i < slbv_context.ab.nb_candidates );i++ )
+		{
+			/** Verify application header and its signature in this slot */
+			slbv_context.ab.current = slbv_context.ab.candidate[i];
+			err = slbv_check_slb(p_ctx, N_SLBV_SLB_ID_E31);
+			/** Keep track of attempt */
+			slbv_context.ab.attempt[slbv_context.ab.current].tried = TRUE;
+			slbv_context.ab.attempt[slbv_context.ab.current].err = err;
+			if( NO_ERROR == err )
+			{
+				/** Slot is genuine */
+				break;
+			}
+			/** Fall back on next candidate within this boot */
+			err = ( ( i + 1 ) < slbv_context.ab.nb_candidates ) ? NO_ERROR : err;
+		}
+		if( ( NO_ERROR == err ) && ( i == slbv_context.ab.nb_candidates ) )
+		{
+			/** No candidate at all */
+			err = N_SLBV_ERR_AB_NO_VALID_SLOT;
+		}
+#else
 		/** Verify application header and its signature */
 		err = slbv_check_slb(p_ctx, N_SLBV_SLB_ID_E31);
+#endif /* _WITH_SLBV_AB_SLOTS_ */
 		if( NO_ERROR == err )
 		{
+#if defined(_WITH_SLBV_MANIFEST_) && defined(_WITH_SLBV_MULTI_HART_)
+			/** Start other harts on their own segment, if any */
+			slbv_manifest_release_harts(p_ctx);
+#endif /* _WITH_SLBV_MANIFEST_ && _WITH_SLBV_MULTI_HART_ */
+#ifdef _WITH_SLBV_WARM_RESET_
+			/** Keep verified boot state for next warm reset */
+			slbv_warm_seal(p_ctx);
+#endif /* _WITH_SLBV_WARM_RESET_ */
+#ifdef _WITH_SLBV_LAZY_XIP_
+			if( TRUE == slbv_context.lazy.pending )
+			{
+				/** Fence off unverified chunks, they are checked on first fetch or load */
+				slbv_lazy_arm(p_ctx);
+			}
+#endif /* _WITH_SLBV_LAZY_XIP_ */
+#ifdef _WITH_SBRM_PROFILING_
+			sbrm_prof_mark(N_SBRM_PROF_JUMP);
+#endif /* _WITH_SBRM_PROFILING_ */
 			/** Jump into SLB/SFL */
 			slbv_context.jump_fct_ptr();
 		}
@@ -142,11 +218,18 @@ int_pltfrm slbv_get_boot_address(t_context *p_ctx, uint_pltfrm *p_addr)
 		slbv_context.bootdev = 0;
 		/** Retrieve parameter from OTP */
 #ifdef _WITH_SCR_REGISTERS_
-		slbv_context.bootdev = *((uint32_t*)C_REG_SCR_BASE_ADDRESS);
+		slbv_context.bootdev = *((uint32_t*)M_PLATFORM_ADDR(C_REG_SCR_BASE_ADDRESS));
 		err = NO_ERROR;
 #else
 		err = sbrm_read_otp(p_ctx, C_OTP_BOOTDEV_OFST, (uint8_t*)&slbv_context.bootdev, C_OTP_BOOTDEV_SIZE);
 #endif /* _WITH_SCR_REGISTERS_ */
+#ifdef _WITH_SLBV_BOOT_PROBE_
+		if( NO_ERROR == err )
+		{
+			/** All candidates are started together, first ready one in priority order replaces BOOTDEV */
+			err = slbv_probe_boot_devices(p_ctx);
+		}
+#endif /* _WITH_SLBV_BOOT_PROBE_ */
 		if( NO_ERROR == err )
 		{
 			/** Check boot address depending on BOOTDEV parameter */
@@ -167,7 +250,33 @@ int_pltfrm slbv_get_boot_address(t_context *p_ctx, uint_pltfrm *p_addr)
 				metal_qspi_init(slbv_context.boot.qspi, C_SLBV_QSPI_BAUDRATE);
 				/** QSPI is memory mapped, therefore it can be accessed directly with address */
 #endif /* _WITH_GPT_ */
+#ifdef _WITH_SLBV_QSPI_PERF_
+				if( FALSE == slbv_context.qspi_perf.done )
+				{
+					/** Switch boot flash to fastest reliable read mode, once per boot */
+					slbv_qspi_setup(p_ctx, *(uint_pltfrm*)p_addr);
+					slbv_context.qspi_perf.done = TRUE;
+				}
+#endif /* _WITH_SLBV_QSPI_PERF_ */
+			}
+#ifdef _WITH_SLBV_EMMC_
+			else if( C_OTP_BOOTDEV_EMMC_NOOFST == ( ( slbv_context.bootdev >> C_OTP_BOOTDEV_PATTERN_OFST ) & C_OTP_BOOTDEV_PATTERN_MASK_NOOFST ) )
+			{
+				/** eMMC is not memory mapped : image is staged in RAM, once per boot */
+				if( FALSE == slbv_context.emmc.loaded )
+				{
+					err = slbv_emmc_load(p_ctx,
+										(uint_pltfrm)&__emmc_stage_start_addr,
+										(uint32_t)( (uint_pltfrm)&__emmc_stage_end_addr - (uint_pltfrm)&__emmc_stage_start_addr ));
+					if( err )
+					{
+						slbv_context.boot_addr = 0;
+						goto slbv_get_boot_address_out;
+					}
+				}
+				*(uint_pltfrm*)p_addr = (uint_pltfrm)&__emmc_stage_start_addr;
 			}
+#endif /* _WITH_SLBV_EMMC_ */
 			else
 			{
 				/** Error */
@@ -181,482 +290,3702 @@ slbv_get_boot_address_out:
 	return err;
 }
 
+#ifdef _WITH_SLBV_QSPI_PERF_
 /******************************************************************************/
-int_pltfrm slbv_get_application_version(t_context *p_ctx, uint32_t *p_version)
+/** Control registers of boot QSPI, null if platform does not provide the port */
+volatile t_reg_qspi *slbv_qspi_get_regs(void)
+{
+	/** Port is looked up as for memory mapped accesses */
+	if( !metal_qspi_get_device(C_SLBV_QSPI_PORT_ID) )
+	{
+		return 0;
+	}
+	/** End Of Function */
+	return (volatile t_reg_qspi*)C_SLBV_QSPI_CTRL_BASE_ADDR;
+}
+
+/******************************************************************************/
+/** One byte full duplex transfer, in direct mode */
+int_pltfrm slbv_qspi_xfer(volatile t_reg_qspi *p_reg, uint8_t tx, uint8_t *p_rx)
 {
 	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
-	int32_t										slot = C_OTP_APP_REFV_SLOT_MAX;
+	uint32_t									timeout = C_SLBV_QSPI_TIMEOUT;
+	uint32_t									rx;
 
 	/** Check input pointer */
-	if( !p_ctx || !p_version )
+	if( !p_reg || !p_rx )
 	{
 		/** Pointer should not be null */
 		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_qspi_xfer_out;
 	}
-	else
+	/** Wait for room in TX FIFO */
+	while( ( p_reg->txdata & C_QSPI_TXDATA_FULL_MASK ) && --timeout );
+	if( !timeout )
 	{
-		/** Look for non virgin slot */
-		while( ( slot >= 0 ) && ( NO_ERROR != err ) )
-		{
-			/** Start from last slot */
-			err = sbrm_read_otp(p_ctx, C_OTP_APP_REFV_AREA_OFST + ( slot * C_OTP_APP_REFV_ELMNT_SIZE ), (uint8_t*)p_version, C_OTP_APP_REFV_ELMNT_SIZE);
-			if( (uint32_t)C_PATTERN_VIRGIN_32BITS != (uint32_t)*p_version )
-			{
-				/** Found */
-				err = NO_ERROR;
-			}
-			else
-			{
-				/** Change 'err' */
-				err = N_SLBV_ERR_NO_APP_REF_VERSION;
-				/** Decrement slot number */
-				slot--;
-			}
-		}
+		err = N_SLBV_ERR_QSPI_TROUBLE;
+		goto slbv_qspi_xfer_out;
+	}
+	p_reg->txdata = (uint32_t)tx;
+	/** Wait for received byte */
+	timeout = C_SLBV_QSPI_TIMEOUT;
+	do
+	{
+		rx = p_reg->rxdata;
+	} while( ( rx & C_QSPI_RXDATA_EMPTY_MASK ) && --timeout );
+	if( !timeout )
+	{
+		err = N_SLBV_ERR_QSPI_TROUBLE;
+		goto slbv_qspi_xfer_out;
 	}
+	*p_rx = (uint8_t)( ( rx & C_QSPI_RXDATA_DATA_MASK ) >> C_QSPI_RXDATA_DATA_OFST );
+	/** No error */
+	err = NO_ERROR;
+slbv_qspi_xfer_out:
 	/** End Of Function */
 	return err;
 }
 
 /******************************************************************************/
-int_pltfrm slbv_check_slb(t_context *p_ctx, e_slbv_slb_id slb_id)
+/** Read JEDEC ID, then pick widest read command flash is ready for */
+int_pltfrm slbv_qspi_probe(t_context *p_ctx, volatile t_reg_qspi *p_reg, uint32_t *p_cfg)
 {
-	uint8_t										loop = 0;
-	uint8_t										i;
-	/** By default FSBL is not considered as XiP */
-	uint8_t										token_xip = FALSE;
 	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
-	volatile uint_pltfrm						boundary_down = (uint_pltfrm)&__sbr_free_start_addr;
-	volatile uint_pltfrm						boundary_up = (uint_pltfrm)&__sbr_free_end_addr;
-	size_t										hash_len = 0;
-	uint32_t									tmp = 0;
-	uint32_t									rom_version = 0;
-	uint32_t									raw_binary_size = 0;
-	volatile uint32_t							tmp_size = 0;
-	t_km_key									key;
-	t_key_data									key_data;
-	ecc_affine_point_t							Q;
-	ecdsa_signature_t							signature;
-	volatile uint8_t							*p_tmp;
-	t_km_context								*p_km_ctx;
-	volatile uint_pltfrm						addr_copy;
-	volatile uint_pltfrm						addr_exec;
-	/** Declare local pointer to stored formated binary */
-	volatile uint_pltfrm						src_binary;
-	e_km_keyid									key_sig;
-
+	uint8_t										status_cmd = 0;
+	uint8_t										qe_mask = 0;
+	uint8_t										status = 0;
+	uint8_t										dummy;
+	uint32_t									proto = C_QSPI_PROTO_DUAL;
+	uint32_t									i;
 
 	/** Check input pointer */
-	if( !p_ctx || !p_ctx->p_km_context )
+	if( !p_ctx || !p_reg || !p_cfg )
 	{
 		/** Pointer should not be null */
 		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_qspi_probe_out;
 	}
-	else if( N_SLBV_SLB_ID_E31 != slb_id )
+	/** Direct mode, single wire, safe clock */
+	p_reg->fctrl &= ~C_QSPI_FCTRL_EN_MASK;
+	p_reg->sckdiv = C_SLBV_QSPI_SCKDIV_SAFE;
+	p_reg->fmt = ( ( C_QSPI_PROTO_SINGLE << C_QSPI_FMT_PROTO_OFST ) | ( 8 << C_QSPI_FMT_LEN_OFST ) );
+	/** Read JEDEC ID */
+	p_reg->csmode = C_QSPI_CSMODE_HOLD;
+	err = slbv_qspi_xfer(p_reg, C_SLBV_QSPI_CMD_READ_JEDEC_ID, &dummy);
+	for( i = 0;( NO_ERROR == err ) && ( i < sizeof(slbv_context.qspi_perf.jedec_id) );i++ )
 	{
-		/**  */
-		err = N_SLBV_ERR_APPLI_TARGET_NOT_SUPPORTED;
+		err = slbv_qspi_xfer(p_reg, 0x00, &slbv_context.qspi_perf.jedec_id[i]);
 	}
-	else
+	p_reg->csmode = C_QSPI_CSMODE_AUTO;
+	if( err )
 	{
-		/** Assign pointer */
-		p_km_ctx = (t_km_context*)p_ctx->p_km_context;
-		/** Retrieve where to search for FSBL */
-		err = slbv_get_boot_address(p_ctx, (uint_pltfrm*)&slbv_context.boot_addr);
-		if( err || !slbv_context.boot_addr )
+		goto slbv_qspi_probe_out;
+	}
+	/** Quad output read needs Quad Enable bit on most parts */
+	switch( slbv_context.qspi_perf.jedec_id[0] )
+	{
+		case C_SLBV_QSPI_JEDEC_MICRON:
+			/** Quad output read always available */
+			proto = C_QSPI_PROTO_QUAD;
+			break;
+		case C_SLBV_QSPI_JEDEC_MACRONIX:
+		case C_SLBV_QSPI_JEDEC_ISSI:
+			status_cmd = C_SLBV_QSPI_CMD_READ_STATUS;
+			qe_mask = C_SLBV_QSPI_SR_QE_MASK;
+			break;
+		case C_SLBV_QSPI_JEDEC_WINBOND:
+			status_cmd = C_SLBV_QSPI_CMD_READ_STATUS2;
+			qe_mask = C_SLBV_QSPI_SR2_QE_MASK;
+			break;
+		case 0x00:
+		case 0xff:
+			/** Nothing answered, keep single wire fast read */
+			proto = C_QSPI_PROTO_SINGLE;
+			break;
+		default:
+			/** Unknown part : dual output read needs no configuration */
+			break;
+	}
+	if( status_cmd )
+	{
+		/** Non volatile QE bit is only read, never written by Secure Boot ROM */
+		p_reg->csmode = C_QSPI_CSMODE_HOLD;
+		err = slbv_qspi_xfer(p_reg, status_cmd, &dummy);
+		if( NO_ERROR == err )
 		{
-			/** Set default value - address of free area in internal RAM/Flash */
-			slbv_context.boot_addr = (volatile uint_pltfrm)&__iflash_start;
+			err = slbv_qspi_xfer(p_reg, 0x00, &status);
 		}
-		/** Assign value then */
-		slbv_context.p_hdr = (volatile t_secure_header*)slbv_context.boot_addr;
-		/** Look for synchronization pattern **********************************/
-		if( ( C_SFLV_MAGIC_WORD1 != slbv_context.p_hdr->magic_word1 ) ||
-			( C_SFLV_MAGIC_WORD2 != slbv_context.p_hdr->magic_word2 ) )
+		p_reg->csmode = C_QSPI_CSMODE_AUTO;
+		if( err )
 		{
-			/** Synchronization pattern(s), no match */
-			err = N_SLBV_ERR_SYNC_PTRN_FAILURE;
-			goto slbv_check_slb_out;
+			goto slbv_qspi_probe_out;
 		}
-		/** Check Secure Boot ROM version *************************************/
-		rom_version = ( ( SBR_REF_VERSION_EDIT << C_SBR_REF_VERSION_EDIT_OFST ) & C_SBR_REF_VERSION_EDIT_MASK ) |\
-						( ( SBR_REF_VERSION_MINOR << C_SBR_REF_VERSION_MINOR_OFST ) & C_SBR_REF_VERSION_MINOR_MASK ) |\
-						( ( SBR_REF_VERSION_MAJOR << C_SBR_REF_VERSION_MAJOR_OFST ) & C_SBR_REF_VERSION_MAJOR_MASK );
-		if( rom_version > slbv_context.p_hdr->rom_ref_version )
+		proto = ( status & qe_mask ) ? C_QSPI_PROTO_QUAD : C_QSPI_PROTO_DUAL;
+	}
+	/** Build configuration, clock divisor is set by calibration */
+	*p_cfg = ( ( C_SLBV_QSPI_FAST_READ_DUMMY << C_OTP_QSPI_CFG_PAD_CNT_OFST ) & C_OTP_QSPI_CFG_PAD_CNT_MASK ) |
+			( ( proto << C_OTP_QSPI_CFG_PROTO_OFST ) & C_OTP_QSPI_CFG_PROTO_MASK ) |
+			( ( C_OTP_QSPI_CFG_VALID_NOOFST << C_OTP_QSPI_CFG_VALID_OFST ) & C_OTP_QSPI_CFG_VALID_MASK );
+	switch( proto )
+	{
+		case C_QSPI_PROTO_QUAD:
+			*p_cfg |= ( C_SLBV_QSPI_CMD_QUAD_OUT_READ << C_OTP_QSPI_CFG_CMD_OFST );
+			break;
+		case C_QSPI_PROTO_DUAL:
+			*p_cfg |= ( C_SLBV_QSPI_CMD_DUAL_OUT_READ << C_OTP_QSPI_CFG_CMD_OFST );
+			break;
+		default:
+			*p_cfg |= ( C_SLBV_QSPI_CMD_FAST_READ << C_OTP_QSPI_CFG_CMD_OFST );
+			break;
+	}
+slbv_qspi_probe_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Set memory mapped read mode from configuration word */
+void slbv_qspi_apply(volatile t_reg_qspi *p_reg, uint32_t cfg)
+{
+	uint32_t									proto = ( cfg & C_OTP_QSPI_CFG_PROTO_MASK ) >> C_OTP_QSPI_CFG_PROTO_OFST;
+
+	/** Controller must be in direct mode while changing format */
+	p_reg->fctrl &= ~C_QSPI_FCTRL_EN_MASK;
+	p_reg->sckdiv = ( ( cfg & C_OTP_QSPI_CFG_SCKDIV_MASK ) >> C_OTP_QSPI_CFG_SCKDIV_OFST ) & C_QSPI_SCKDIV_DIV_MASK;
+	/** Command and address on one wire, data on 'proto' wires, 3 bytes address */
+	p_reg->ffmt = C_QSPI_FFMT_CMD_EN_MASK |
+					( ( 3 << C_QSPI_FFMT_ADDR_LEN_OFST ) & C_QSPI_FFMT_ADDR_LEN_MASK ) |
+					( ( ( ( cfg & C_OTP_QSPI_CFG_PAD_CNT_MASK ) >> C_OTP_QSPI_CFG_PAD_CNT_OFST ) << C_QSPI_FFMT_PAD_CNT_OFST ) & C_QSPI_FFMT_PAD_CNT_MASK ) |
+					( ( C_QSPI_PROTO_SINGLE & C_QSPI_FFMT_PROTO_MASK_NOOFST ) << C_QSPI_FFMT_CMD_PROTO_OFST ) |
+					( ( C_QSPI_PROTO_SINGLE & C_QSPI_FFMT_PROTO_MASK_NOOFST ) << C_QSPI_FFMT_ADDR_PROTO_OFST ) |
+					( ( proto & C_QSPI_FFMT_PROTO_MASK_NOOFST ) << C_QSPI_FFMT_DATA_PROTO_OFST ) |
+					( ( ( cfg & C_OTP_QSPI_CFG_CMD_MASK ) >> C_OTP_QSPI_CFG_CMD_OFST ) << C_QSPI_FFMT_CMD_CODE_OFST );
+	/** Back to memory mapped mode */
+	p_reg->fctrl |= C_QSPI_FCTRL_EN_MASK;
+	M_FENCE_IO();
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+/** Header magic words are the known pattern read back through current setting */
+int_pltfrm slbv_qspi_check_pattern(uint_pltfrm boot_addr)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	volatile t_secure_header					*p_hdr = (volatile t_secure_header*)boot_addr;
+	uint32_t									i;
+
+	/** Check input pointer */
+	if( !boot_addr )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+		/** Every read must match */
+		err = NO_ERROR;
+		for( i = 0;( NO_ERROR == err ) && ( i < C_SLBV_QSPI_CALIB_NB_READS );i++ )
 		{
-			/** Application is not compatible */
-			err = N_SLBV_ERR_HDR_VERSION_MISMATCH;
-			goto slbv_check_slb_out;
+			if( ( C_SFLV_MAGIC_WORD1 != p_hdr->magic_word1 ) ||
+				( C_SFLV_MAGIC_WORD2 != p_hdr->magic_word2 ) )
+			{
+				err = N_SLBV_ERR_QSPI_TROUBLE;
+			}
 		}
-		/** Check firmware version given in header compare to the one from
-		 * storage area (OTP) *************************************************/
-		err = slbv_get_application_version(p_ctx, &slbv_context.ref_appli_version);
-		if( N_SLBV_ERR_NO_APP_REF_VERSION == err )
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Apply provisioned read mode, or probe and calibrate for this boot only */
+int_pltfrm slbv_qspi_setup(t_context *p_ctx, uint_pltfrm boot_addr)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	volatile t_reg_qspi							*p_reg = slbv_qspi_get_regs();
+	uint32_t									cfg = C_PATTERN_VIRGIN_32BITS;
+	uint32_t									safe_cfg;
+	uint32_t									div;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_qspi_setup_out;
+	}
+	else if( !p_reg )
+	{
+		/** No QSPI port on this platform */
+		err = N_SLBV_ERR_NO_INTERFACE_QSPI;
+		goto slbv_qspi_setup_out;
+	}
+	/** Fallback : single wire fast read at safe clock */
+	safe_cfg = ( C_SLBV_QSPI_CMD_FAST_READ << C_OTP_QSPI_CFG_CMD_OFST ) |
+				( C_SLBV_QSPI_FAST_READ_DUMMY << C_OTP_QSPI_CFG_PAD_CNT_OFST ) |
+				( C_QSPI_PROTO_SINGLE << C_OTP_QSPI_CFG_PROTO_OFST ) |
+				( C_SLBV_QSPI_SCKDIV_SAFE << C_OTP_QSPI_CFG_SCKDIV_OFST ) |
+				( C_OTP_QSPI_CFG_VALID_NOOFST << C_OTP_QSPI_CFG_VALID_OFST );
+	/** Setting provisioned in OTP ? Only a hint, never written by boot path */
+	err = sbrm_read_otp(p_ctx, C_OTP_QSPI_CFG_OFST, (uint8_t*)&cfg, C_OTP_QSPI_CFG_SIZE);
+	if( ( NO_ERROR == err ) &&
+		( C_OTP_QSPI_CFG_VALID_NOOFST == ( ( cfg & C_OTP_QSPI_CFG_VALID_MASK ) >> C_OTP_QSPI_CFG_VALID_OFST ) ) )
+	{
+		slbv_qspi_apply(p_reg, cfg);
+		err = slbv_qspi_check_pattern(boot_addr);
+		if( NO_ERROR == err )
 		{
-			/** Set very default version */
-			slbv_context.ref_appli_version = (uint32_t)1UL;
+			/** Done, no calibration needed */
+			slbv_context.qspi_perf.cfg = cfg;
+			goto slbv_qspi_setup_out;
 		}
-		else if( err )
+		/** Hint no longer works (flash replaced, board change) : calibrate again */
+	}
+	/** Look at flash capabilities */
+	err = slbv_qspi_probe(p_ctx, p_reg, &cfg);
+	if( err )
+	{
+		slbv_qspi_apply(p_reg, safe_cfg);
+		slbv_context.qspi_perf.cfg = safe_cfg;
+		goto slbv_qspi_setup_out;
+	}
+	/** Fastest clock reading pattern back correctly */
+	for( div = C_SLBV_QSPI_SCKDIV_MIN;div <= C_SLBV_QSPI_SCKDIV_SAFE;div++ )
+	{
+		cfg = ( cfg & ~C_OTP_QSPI_CFG_SCKDIV_MASK ) | ( ( div << C_OTP_QSPI_CFG_SCKDIV_OFST ) & C_OTP_QSPI_CFG_SCKDIV_MASK );
+		slbv_qspi_apply(p_reg, cfg);
+		err = slbv_qspi_check_pattern(boot_addr);
+		if( NO_ERROR == err )
 		{
-			/** Should not happen */
-			goto slbv_check_slb_out;
+			break;
 		}
-		/** Given version must be equal or greater than stored one */
-		if( slbv_context.ref_appli_version > slbv_context.p_hdr->firmware_version )
+	}
+	if( err )
+	{
+		/** No pattern (blank flash ?) or no working setting */
+		slbv_qspi_apply(p_reg, safe_cfg);
+		slbv_context.qspi_perf.cfg = safe_cfg;
+		goto slbv_qspi_setup_out;
+	}
+	/** Keep one step of margin */
+	if( C_SLBV_QSPI_SCKDIV_SAFE > div )
+	{
+		div++;
+		cfg = ( cfg & ~C_OTP_QSPI_CFG_SCKDIV_MASK ) | ( ( div << C_OTP_QSPI_CFG_SCKDIV_OFST ) & C_OTP_QSPI_CFG_SCKDIV_MASK );
+		slbv_qspi_apply(p_reg, cfg);
+		err = slbv_qspi_check_pattern(boot_addr);
+		if( err )
 		{
-			/** Version does not match */
-			err = N_SLBV_ERR_VERSION_MISMATCH;
-			goto slbv_check_slb_out;
+			slbv_qspi_apply(p_reg, safe_cfg);
+			slbv_context.qspi_perf.cfg = safe_cfg;
+			goto slbv_qspi_setup_out;
 		}
-		/** Check application type */
-		switch( slbv_context.p_hdr->appli_type )
+	}
+	/** Kept in RAM for this boot only */
+	slbv_context.qspi_perf.cfg = cfg;
+slbv_qspi_setup_out:
+	/** End Of Function */
+	return err;
+}
+#endif /* _WITH_SLBV_QSPI_PERF_ */
+
+#ifdef _WITH_SLBV_BOOT_PROBE_
+/******************************************************************************/
+/** Time base for probing budgets */
+uint_pltfrm slbv_probe_cycles(void)
+{
+	uint_pltfrm									cycles;
+
+	M_CSR_READ(mcycle, cycles);
+	/** End Of Function */
+	return cycles;
+}
+
+/******************************************************************************/
+/** Build candidates list : OTP order if programmed, BOOTDEV then other devices otherwise */
+int_pltfrm slbv_probe_order(t_context *p_ctx)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint32_t									order = C_PATTERN_VIRGIN_32BITS;
+	uint32_t									pattern;
+	uint32_t									i;
+	uint32_t									j;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_probe_order_out;
+	}
+	err = sbrm_read_otp(p_ctx, C_OTP_BOOT_ORDER_OFST, (uint8_t*)&order, C_OTP_BOOT_ORDER_SIZE);
+	if( ( NO_ERROR != err ) ||
+		( C_OTP_BOOT_ORDER_VALID_NOOFST != ( ( order & C_OTP_BOOT_ORDER_VALID_MASK ) >> C_OTP_BOOT_ORDER_VALID_OFST ) ) )
+	{
+		/** Not programmed : BOOTDEV first, then every other device built in this ROM */
+		order = ( slbv_context.bootdev >> C_OTP_BOOTDEV_PATTERN_OFST ) & C_OTP_BOOTDEV_PATTERN_MASK_NOOFST;
+		order |= ( ( C_OTP_BOOTDEV_QSPI_NOOFST == order ) ? C_OTP_BOOTDEV_EMMC_NOOFST : C_OTP_BOOTDEV_QSPI_NOOFST ) << C_OTP_BOOT_ORDER_ENTRY_WIDTH;
+	}
+	slbv_context.probe.nb_devices = 0;
+	for( i = 0;i < C_OTP_BOOT_ORDER_ENTRY_NB;i++ )
+	{
+		pattern = ( order >> ( i * C_OTP_BOOT_ORDER_ENTRY_WIDTH ) ) & C_OTP_BOOT_ORDER_ENTRY_MASK_NOOFST;
+		switch( pattern )
 		{
-			case N_SLBV_APP_TYPE_REGULAR:
-				slbv_context.decryption = FALSE;
+			case C_OTP_BOOTDEV_QSPI_NOOFST:
+#ifdef _WITH_SLBV_EMMC_
+			case C_OTP_BOOTDEV_EMMC_NOOFST:
+#endif /* _WITH_SLBV_EMMC_ */
 				break;
-			case N_SLBV_APP_TYPE_ENCRYPTED:
+			case C_OTP_BOOTDEV_RFU0_NOOFST:
+				/** End of list */
+				i = C_OTP_BOOT_ORDER_ENTRY_NB;
+				continue;
 			default:
-				err = N_SLBV_ERR_APPLI_TYPE_NOT_SUPPORTED;
-				goto slbv_check_slb_out;
-		}
-		/** Check address range ***********************************************/
-		/** Now check binary size */
-		if( ( ( sizeof(t_secure_header) + C_SIGNATURE_MAX_SIZE ) >= slbv_context.p_hdr->secure_appli_image_size ) &&
-			( C_SEC_HDR_TWO_SIGNATURES == slbv_context.p_hdr->nb_signatures ) )
-		{
-			/** Size to small */
-			err = N_SLBV_ERR_INVAL;
-			goto slbv_check_slb_out;
+				/** Not supported by this ROM */
+				continue;
 		}
-		else if( ( sizeof(t_secure_header) >= slbv_context.p_hdr->secure_appli_image_size ) &&
-				( C_SEC_HDR_ONE_SIGNATURE == slbv_context.p_hdr->nb_signatures ) )
+		/** Each device is listed once */
+		for( j = 0;( j < slbv_context.probe.nb_devices ) && ( pattern != slbv_context.probe.device[j].bootdev );j++ );
+		if( j < slbv_context.probe.nb_devices )
 		{
-			/** Size to small */
-			err = N_SLBV_ERR_INVAL;
-			goto slbv_check_slb_out;
+			continue;
 		}
-#ifdef _SLBV_OLD_BEHAVIOR_
-		/** Check binary offset coherence */
-		if( ( sizeof(t_secure_header) != slbv_context.p_hdr->fimware_start_offset ) &&
-			( C_SEC_HDR_ONE_SIGNATURE == slbv_context.p_hdr->nb_signatures ) )
-		{
-			/** Offset does not match header size with 1 certificate */
-			err = N_SLBV_ERR_INVAL_BINARY_OFST;
-			goto slbv_check_slb_out;
+		slbv_context.probe.device[slbv_context.probe.nb_devices].bootdev = pattern;
+		slbv_context.probe.device[slbv_context.probe.nb_devices].state = N_SLBV_PROBE_IDLE;
+		slbv_context.probe.device[slbv_context.probe.nb_devices].phase = 0;
+		slbv_context.probe.device[slbv_context.probe.nb_devices].err = NO_ERROR;
+		slbv_context.probe.device[slbv_context.probe.nb_devices].elapsed = 0;
+		slbv_context.probe.nb_devices++;
+	}
+	err = ( slbv_context.probe.nb_devices ) ? NO_ERROR : N_SLBV_ERR_PROBE_NO_DEVICE;
+slbv_probe_order_out:
+	/** End Of Function */
+	return err;
+}
 
-		}
-		else if( ( ( sizeof(t_secure_header) + C_SIGNATURE_MAX_SIZE ) != slbv_context.p_hdr->fimware_start_offset ) &&
-				( C_SEC_HDR_TWO_SIGNATURES == slbv_context.p_hdr->nb_signatures ) )
-		{
-			/** Offset does not match header size with 2 certificates */
-			err = N_SLBV_ERR_INVAL_BINARY_OFST;
-			goto slbv_check_slb_out;
-		}
-#endif /** _SLBV_OLD_BEHAVIOR_ */
-#if __riscv_xlen == 32
-		/** 32bits */
-		if( C_SEC_HDR_ADDRESS_SIZE_32BITS != slbv_context.p_hdr->address_size )
-#elif __riscv_xlen == 64
-		/** 64bits */
-		if( C_SEC_HDR_ADDRESS_SIZE_64BITS != slbv_context.p_hdr->address_size )
-#else
-#error [__riscv_xlen] A value for bus width must be defined
-#endif /* __riscv_xlen */
-		{
-			/**  */
-			err = N_SLBV_ERR_ADDR_SIZE_NOT_SUPPORTED;
-			goto slbv_check_slb_out;
-		}
-		/** Now */
-		src_binary = (volatile uint_pltfrm)slbv_context.p_hdr;
-		/** Then binary offset from header */
-		src_binary += slbv_context.p_hdr->fimware_start_offset;
-		/** Compute raw binary size : size given in header - binary offset*/
-		raw_binary_size = slbv_context.p_hdr->secure_appli_image_size - ( sizeof(t_secure_header) + slbv_context.p_hdr->fimware_start_offset );
-		if( C_SEC_HDR_TWO_SIGNATURES == slbv_context.p_hdr->nb_signatures )
-		{
-			raw_binary_size -= C_SIGNATURE_MAX_SIZE;
-		}
-		/** Check if raw binary size is coherent, i.e. it should be at least one instruction */
-		if( ( p_ctx->misa & ( 0x1 << C_MISA_EXTENSION_BIT_COMPRESSED_OFST ) ) &&
-			( sizeof(uint16_t) > raw_binary_size ) )
+/******************************************************************************/
+/** Kick device initialization, without waiting for device */
+int_pltfrm slbv_probe_start(t_context *p_ctx, uint32_t index)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	volatile t_reg_qspi							*p_reg = slbv_qspi_get_regs();
+	uint8_t										dummy;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_probe_start_out;
+	}
+	else if( index >= slbv_context.probe.nb_devices )
+	{
+		err = N_SLBV_ERR_NOT_IN_RANGE;
+		goto slbv_probe_start_out;
+	}
+	slbv_context.probe.device[index].start = slbv_probe_cycles();
+	switch( slbv_context.probe.device[index].bootdev )
+	{
+		case C_OTP_BOOTDEV_QSPI_NOOFST:
+			if( !p_reg )
+			{
+				err = N_SLBV_ERR_NO_INTERFACE_QSPI;
+				break;
+			}
+			/** Direct mode, single wire, safe clock : software reset, flash then needs tRST */
+			p_reg->fctrl &= ~C_QSPI_FCTRL_EN_MASK;
+			p_reg->sckdiv = C_SLBV_QSPI_SCKDIV_SAFE;
+			p_reg->fmt = ( ( C_QSPI_PROTO_SINGLE << C_QSPI_FMT_PROTO_OFST ) | ( 8 << C_QSPI_FMT_LEN_OFST ) );
+			p_reg->csmode = C_QSPI_CSMODE_AUTO;
+			err = slbv_qspi_xfer(p_reg, C_SLBV_QSPI_CMD_RESET_ENABLE, &dummy);
+			if( NO_ERROR == err )
+			{
+				err = slbv_qspi_xfer(p_reg, C_SLBV_QSPI_CMD_RESET, &dummy);
+			}
+			break;
+#ifdef _WITH_SLBV_EMMC_
+		case C_OTP_BOOTDEV_EMMC_NOOFST:
+			/** Card is put in idle state, CMD1 polling is done step by step */
+			err = slbv_emmc_init_start(p_ctx);
+			break;
+#endif /* _WITH_SLBV_EMMC_ */
+		default:
+			err = N_SLBV_ERR_BOOTDEV_NOT_SUPPORTED;
+			break;
+	}
+	slbv_context.probe.device[index].state = ( NO_ERROR == err ) ? N_SLBV_PROBE_PENDING : N_SLBV_PROBE_FAILED;
+	slbv_context.probe.device[index].err = err;
+slbv_probe_start_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Give device one short step, never waits for it */
+int_pltfrm slbv_probe_step(t_context *p_ctx, uint32_t index)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	volatile t_reg_qspi							*p_reg = slbv_qspi_get_regs();
+	uint_pltfrm									elapsed;
+	uint_pltfrm									budget;
+	uint8_t										status = C_SLBV_QSPI_SR_WIP_MASK;
+	uint8_t										dummy;
+	uint8_t										ready = FALSE;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_probe_step_out;
+	}
+	else if( ( index >= slbv_context.probe.nb_devices ) ||
+			( N_SLBV_PROBE_PENDING != slbv_context.probe.device[index].state ) )
+	{
+		err = N_SLBV_ERR_NOT_IN_RANGE;
+		goto slbv_probe_step_out;
+	}
+	elapsed = slbv_probe_cycles() - slbv_context.probe.device[index].start;
+	switch( slbv_context.probe.device[index].bootdev )
+	{
+		case C_OTP_BOOTDEV_QSPI_NOOFST:
+			budget = C_SLBV_PROBE_QSPI_BUDGET;
+			if( C_SLBV_PROBE_QSPI_RESET_CYCLES > elapsed )
+			{
+				/** Reset recovery not over */
+				err = NO_ERROR;
+				break;
+			}
+			/** Flash busy ? */
+			p_reg->csmode = C_QSPI_CSMODE_HOLD;
+			err = slbv_qspi_xfer(p_reg, C_SLBV_QSPI_CMD_READ_STATUS, &dummy);
+			if( NO_ERROR == err )
+			{
+				err = slbv_qspi_xfer(p_reg, 0x00, &status);
+			}
+			p_reg->csmode = C_QSPI_CSMODE_AUTO;
+			if( ( NO_ERROR != err ) || ( status & C_SLBV_QSPI_SR_WIP_MASK ) )
+			{
+				/** Absent flash reads all ones, it ends on budget */
+				err = NO_ERROR;
+				break;
+			}
+			/** Read mode setup, calibration if needed : header is the known pattern */
+			slbv_qspi_setup(p_ctx, (uint_pltfrm)&__qspi_start);
+			slbv_context.qspi_perf.done = TRUE;
+			err = slbv_qspi_check_pattern((uint_pltfrm)&__qspi_start);
+			ready = ( NO_ERROR == err ) ? TRUE : FALSE;
+			err = ( NO_ERROR == err ) ? NO_ERROR : N_SLBV_ERR_SYNC_PTRN_FAILURE;
+			break;
+#ifdef _WITH_SLBV_EMMC_
+		case C_OTP_BOOTDEV_EMMC_NOOFST:
+			budget = C_SLBV_PROBE_EMMC_BUDGET;
+			/** One CMD1 per step */
+			err = slbv_emmc_init_poll(p_ctx, &ready);
+			if( ( NO_ERROR != err ) || ( FALSE == ready ) )
+			{
+				break;
+			}
+			/** Power up over : finish initialization, then look at first block */
+			err = slbv_emmc_init_finish(p_ctx);
+			if( NO_ERROR == err )
+			{
+				err = slbv_emmc_read(slbv_context.emmc.p_reg, 0, 1, (uint_pltfrm)&__emmc_stage_start_addr, C_SLBV_EMMC_CMD_READ_MULTIPLE);
+			}
+			if( ( NO_ERROR == err ) &&
+				( ( C_SFLV_MAGIC_WORD1 != ((volatile t_secure_header*)&__emmc_stage_start_addr)->magic_word1 ) ||
+				( C_SFLV_MAGIC_WORD2 != ((volatile t_secure_header*)&__emmc_stage_start_addr)->magic_word2 ) ) )
+			{
+				err = N_SLBV_ERR_SYNC_PTRN_FAILURE;
+			}
+			ready = ( NO_ERROR == err ) ? TRUE : FALSE;
+			break;
+#endif /* _WITH_SLBV_EMMC_ */
+		default:
+			budget = 0;
+			err = N_SLBV_ERR_BOOTDEV_NOT_SUPPORTED;
+			break;
+	}
+	if( NO_ERROR != err )
+	{
+		/** Device is out of the race */
+		slbv_context.probe.device[index].state = N_SLBV_PROBE_FAILED;
+	}
+	else if( TRUE == ready )
+	{
+		slbv_context.probe.device[index].state = N_SLBV_PROBE_READY;
+	}
+	else if( elapsed > budget )
+	{
+		/** Budget is spent */
+		err = N_SLBV_ERR_PROBE_TIMEOUT;
+		slbv_context.probe.device[index].state = N_SLBV_PROBE_FAILED;
+	}
+	slbv_context.probe.device[index].err = err;
+	slbv_context.probe.device[index].elapsed = elapsed;
+slbv_probe_step_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Start all candidates, step them in turn, keep first ready one in priority order */
+int_pltfrm slbv_probe_boot_devices(t_context *p_ctx)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint32_t									i;
+	uint8_t										waiting;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_probe_boot_devices_out;
+	}
+	if( FALSE == slbv_context.probe.done )
+	{
+		slbv_context.probe.done = TRUE;
+		slbv_context.probe.selected = C_SLBV_PROBE_DEVICE_MAX;
+		err = slbv_probe_order(p_ctx);
+		if( err )
 		{
-			/** Binary is not even one compressed instruction */
-			err = N_SLBV_ERR_BINARY_SIZE_INCOHERENCE;
+			goto slbv_probe_boot_devices_out;
+		}
+		/** Every device starts initializing at once */
+		for( i = 0;i < slbv_context.probe.nb_devices;i++ )
+		{
+			slbv_probe_start(p_ctx, i);
+		}
+		do
+		{
+			/** One step for each device still pending */
+			for( i = 0;i < slbv_context.probe.nb_devices;i++ )
+			{
+				if( N_SLBV_PROBE_PENDING == slbv_context.probe.device[i].state )
+				{
+					slbv_probe_step(p_ctx, i);
+				}
+			}
+			/** A ready device wins unless a higher priority one is still pending */
+			waiting = FALSE;
+			for( i = 0;( FALSE == waiting ) && ( i < slbv_context.probe.nb_devices );i++ )
+			{
+				if( N_SLBV_PROBE_READY == slbv_context.probe.device[i].state )
+				{
+					slbv_context.probe.selected = i;
+					break;
+				}
+				waiting = ( N_SLBV_PROBE_PENDING == slbv_context.probe.device[i].state ) ? TRUE : FALSE;
+			}
+		} while( ( TRUE == waiting ) && ( C_SLBV_PROBE_DEVICE_MAX == slbv_context.probe.selected ) );
+	}
+	if( C_SLBV_PROBE_DEVICE_MAX == slbv_context.probe.selected )
+	{
+		/** Nothing answered with a valid header */
+		err = N_SLBV_ERR_PROBE_NO_DEVICE;
+		goto slbv_probe_boot_devices_out;
+	}
+	/** Selected device replaces BOOTDEV for this boot */
+	slbv_context.bootdev = ( slbv_context.bootdev & ~( C_OTP_BOOTDEV_PATTERN_MASK_NOOFST << C_OTP_BOOTDEV_PATTERN_OFST ) ) |
+							( slbv_context.probe.device[slbv_context.probe.selected].bootdev << C_OTP_BOOTDEV_PATTERN_OFST );
+	err = NO_ERROR;
+slbv_probe_boot_devices_out:
+	/** End Of Function */
+	return err;
+}
+#endif /* _WITH_SLBV_BOOT_PROBE_ */
+
+/******************************************************************************/
+int_pltfrm slbv_get_application_version(t_context *p_ctx, uint32_t *p_version)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	int32_t										slot;
+
+	/** Check input pointer */
+	if( !p_ctx || !p_version )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+		/** Look for last non virgin slot */
+		err = slbv_find_last_refv_slot(p_ctx, &slot, p_version);
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Program new reference version in next free slot - given to SUP applets through ROM services */
+int_pltfrm slbv_set_application_version(t_context *p_ctx, uint32_t version)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	int32_t										slot;
+	uint32_t									current = 0;
+	uint32_t									readback = 0;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_set_application_version_out;
+	}
+	else if( (uint32_t)C_PATTERN_VIRGIN_32BITS == version )
+	{
+		/** Cannot be told apart from a virgin slot */
+		err = GENERIC_ERR_INVAL;
+		goto slbv_set_application_version_out;
+	}
+	/** Retrieve current counter position */
+	err = slbv_find_last_refv_slot(p_ctx, &slot, &current);
+	if( N_SLBV_ERR_NO_APP_REF_VERSION == err )
+	{
+		/** Nothing programmed yet */
+		slot = -1;
+		current = 0;
+	}
+	else if( err )
+	{
+		/** Should not happen */
+		goto slbv_set_application_version_out;
+	}
+	if( current > version )
+	{
+		/** Counter only goes forward */
+		err = N_SLBV_ERR_VERSION_MISMATCH;
+		goto slbv_set_application_version_out;
+	}
+	else if( current == version )
+	{
+		/** Already there */
+		err = NO_ERROR;
+		goto slbv_set_application_version_out;
+	}
+	else if( (int32_t)C_OTP_APP_REFV_SLOT_MAX <= slot )
+	{
+		/** Counter area exhausted */
+		err = N_SLBV_ERR_NO_FREE_LOCATION;
+		goto slbv_set_application_version_out;
+	}
+	/** Program next slot */
+	slot++;
+	err = sbrm_write_otp(p_ctx, M_OTP_APP_REFV_SLOT_OFST(slot), (const uint8_t*)&version, C_OTP_APP_REFV_ELMNT_SIZE);
+	if( err )
+	{
+		goto slbv_set_application_version_out;
+	}
+	/** Read it back */
+	err = sbrm_read_otp(p_ctx, M_OTP_APP_REFV_SLOT_OFST(slot), (uint8_t*)&readback, C_OTP_APP_REFV_ELMNT_SIZE);
+	if( ( NO_ERROR == err ) && ( readback != version ) )
+	{
+		/** Programming failed */
+		err = N_SLBV_ERR_OTP_WRITE_FAILURE;
+	}
+	else if( NO_ERROR == err )
+	{
+		/** Keep context up to date */
+		slbv_context.ref_appli_version = version;
+	}
+slbv_set_application_version_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Slots are programmed in increasing order : binary search on first virgin one */
+int_pltfrm slbv_find_last_refv_slot(t_context *p_ctx, int32_t *p_slot, uint32_t *p_version)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint32_t									low = 0;
+	uint32_t									high = C_OTP_NB_APP_REFV_SLOTS;
+	uint32_t									middle;
+	uint32_t									value;
+
+	/** Check input pointer */
+	if( !p_ctx || !p_slot || !p_version )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_find_last_refv_slot_out;
+	}
+	/** Invariant : slots below 'low' are programmed, slots from 'high' are virgin */
+	while( low < high )
+	{
+		middle = low + ( ( high - low ) >> 1 );
+		err = sbrm_read_otp(p_ctx, M_OTP_APP_REFV_SLOT_OFST(middle), (uint8_t*)&value, C_OTP_APP_REFV_ELMNT_SIZE);
+		if( err )
+		{
+			goto slbv_find_last_refv_slot_out;
+		}
+		if( (uint32_t)C_PATTERN_VIRGIN_32BITS == value )
+		{
+			high = middle;
+		}
+		else
+		{
+			low = middle + 1;
+		}
+	}
+	if( !low )
+	{
+		/** Every slot is virgin */
+		err = N_SLBV_ERR_NO_APP_REF_VERSION;
+		goto slbv_find_last_refv_slot_out;
+	}
+	/** Last programmed slot */
+	*p_slot = (int32_t)( low - 1 );
+	err = sbrm_read_otp(p_ctx, M_OTP_APP_REFV_SLOT_OFST(low - 1), (uint8_t*)p_version, C_OTP_APP_REFV_ELMNT_SIZE);
+slbv_find_last_refv_slot_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm slbv_check_slb(t_context *p_ctx, e_slbv_slb_id slb_id)
+{
+	uint8_t										loop = 0;
+	uint8_t										i;
+	/** By default FSBL is not considered as XiP */
+	uint8_t										token_xip = FALSE;
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	volatile uint_pltfrm						boundary_down = (uint_pltfrm)&__sbr_free_start_addr;
+	volatile uint_pltfrm						boundary_up = (uint_pltfrm)&__sbr_free_end_addr;
+	size_t										hash_len = 0;
+	uint32_t									tmp = 0;
+	uint32_t									rom_version = 0;
+	uint32_t									raw_binary_size = 0;
+	/** Size of installed binary, and of execution area */
+	uint32_t									install_size = 0;
+	uint32_t									exec_size = 0;
+	volatile uint32_t							tmp_size = 0;
+	t_km_key									key;
+	t_key_data									key_data;
+	ecc_affine_point_t							Q;
+	ecdsa_signature_t							signature;
+	volatile uint8_t							*p_tmp;
+	volatile uint_pltfrm						addr_copy;
+	volatile uint_pltfrm						addr_exec;
+	/** Declare local pointer to stored formated binary */
+	volatile uint_pltfrm						src_binary;
+	e_km_keyid									key_sig;
+
+
+	/** Check input pointer */
+	if( !p_ctx || !p_ctx->p_km_context )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else if( N_SLBV_SLB_ID_E31 != slb_id )
+	{
+		/**  */
+		err = N_SLBV_ERR_APPLI_TARGET_NOT_SUPPORTED;
+	}
+	else
+	{
+		/** Retrieve where to search for FSBL */
+		err = slbv_get_boot_address(p_ctx, (uint_pltfrm*)&slbv_context.boot_addr);
+		if( err || !slbv_context.boot_addr )
+		{
+			/** Set default value - address of free area in internal RAM/Flash */
+			slbv_context.boot_addr = (volatile uint_pltfrm)&__iflash_start;
+		}
+#ifdef _WITH_SLBV_AB_SLOTS_
+		/** Point on slot under trial */
+		slbv_context.boot_addr += ( slbv_context.ab.current * slbv_context.ab.slot_size );
+#endif /* _WITH_SLBV_AB_SLOTS_ */
+#ifdef _WITH_SBRM_PROFILING_
+		sbrm_prof_mark(N_SBRM_PROF_HEADER_CHECK);
+#endif /* _WITH_SBRM_PROFILING_ */
+		/** Assign value then */
+		slbv_context.p_hdr = (volatile t_secure_header*)slbv_context.boot_addr;
+		/** Look for synchronization pattern **********************************/
+		if( ( C_SFLV_MAGIC_WORD1 != slbv_context.p_hdr->magic_word1 ) ||
+			( C_SFLV_MAGIC_WORD2 != slbv_context.p_hdr->magic_word2 ) )
+		{
+			/** Synchronization pattern(s), no match */
+			err = N_SLBV_ERR_SYNC_PTRN_FAILURE;
 			goto slbv_check_slb_out;
 		}
-		else if( !( p_ctx->misa & ( 0x1 << C_MISA_EXTENSION_BIT_COMPRESSED_OFST ) ) &&
-				( sizeof(uint32_t) > raw_binary_size ) )
+		/** Check Secure Boot ROM version *************************************/
+		rom_version = ( ( SBR_REF_VERSION_EDIT << C_SBR_REF_VERSION_EDIT_OFST ) & C_SBR_REF_VERSION_EDIT_MASK ) |\
+						( ( SBR_REF_VERSION_MINOR << C_SBR_REF_VERSION_MINOR_OFST ) & C_SBR_REF_VERSION_MINOR_MASK ) |\
+						( ( SBR_REF_VERSION_MAJOR << C_SBR_REF_VERSION_MAJOR_OFST ) & C_SBR_REF_VERSION_MAJOR_MASK );
+		if( rom_version > slbv_context.p_hdr->rom_ref_version )
 		{
-			/** Binary is not even one compressed instruction */
-			err = N_SLBV_ERR_BINARY_SIZE_INCOHERENCE;
+			/** Application is not compatible */
+			err = N_SLBV_ERR_HDR_VERSION_MISMATCH;
+			goto slbv_check_slb_out;
+		}
+		/** Check firmware version given in header compare to the one from
+		 * storage area (OTP) *************************************************/
+		err = slbv_get_application_version(p_ctx, &slbv_context.ref_appli_version);
+		if( N_SLBV_ERR_NO_APP_REF_VERSION == err )
+		{
+			/** Set very default version */
+			slbv_context.ref_appli_version = (uint32_t)1UL;
+		}
+		else if( err )
+		{
+			/** Should not happen */
 			goto slbv_check_slb_out;
 		}
-		/** Verify that copy and execution addresses are consistent */
-		/** Get copy address */
-		memcpy((void*)&addr_copy, (const void*)slbv_context.p_hdr->copy_address, sizeof(uint_pltfrm));
-		/** Get execution address */
-		memcpy((void*)&addr_exec, (const void*)slbv_context.p_hdr->execution_address, sizeof(uint_pltfrm));
-		/** Check if it's XiP */
+		/** Given version must be equal or greater than stored one */
+		if( slbv_context.ref_appli_version > slbv_context.p_hdr->firmware_version )
+		{
+			/** Version does not match */
+			err = N_SLBV_ERR_VERSION_MISMATCH;
+			goto slbv_check_slb_out;
+		}
+#ifdef _WITH_SLBV_MANIFEST_
+		/** By default image holds a single binary */
+		slbv_context.manifest.enabled = FALSE;
+#endif /* _WITH_SLBV_MANIFEST_ */
+#ifdef _WITH_SLBV_HEADER_V2_
+		/** By default header has a single copy/execution address pair */
+		slbv_context.v2.enabled = FALSE;
+#endif /* _WITH_SLBV_HEADER_V2_ */
+#ifdef _WITH_SLBV_CHUNKED_IMAGE_
+		/** By default image is hashed as a single linear stream */
+		slbv_context.chunk.enabled = FALSE;
+#endif /* _WITH_SLBV_CHUNKED_IMAGE_ */
+#ifdef _WITH_SLBV_WARM_RESET_
+		/** Nothing to record until binary is located */
+		slbv_context.warm.image_size = 0;
+#endif /* _WITH_SLBV_WARM_RESET_ */
+#ifdef _WITH_SLBV_STREAMED_INSTALL_
+		/** By default image is installed verbatim */
+		slbv_context.stream.type = N_SLBV_STREAM_NONE;
+		slbv_context.stream.installed = FALSE;
+#endif /* _WITH_SLBV_STREAMED_INSTALL_ */
+		/** Check application type */
+		switch( slbv_context.p_hdr->appli_type )
+		{
+			case N_SLBV_APP_TYPE_REGULAR:
+				slbv_context.decryption = FALSE;
+				break;
+#ifdef _WITH_SLBV_MANIFEST_
+			case N_SLBV_APP_TYPE_MANIFEST:
+				slbv_context.decryption = FALSE;
+				/** Signature covers manifest, segments are checked afterwards */
+				slbv_context.manifest.enabled = TRUE;
+				break;
+#endif /* _WITH_SLBV_MANIFEST_ */
+#ifdef _WITH_SLBV_HEADER_V2_
+			case N_SLBV_APP_TYPE_V2:
+				slbv_context.decryption = FALSE;
+				/** Signature covers segment table, segments are checked afterwards */
+				slbv_context.v2.enabled = TRUE;
+				break;
+#endif /* _WITH_SLBV_HEADER_V2_ */
+#ifdef _WITH_SLBV_CHUNKED_IMAGE_
+			case N_SLBV_APP_TYPE_CHUNKED:
+				slbv_context.decryption = FALSE;
+				/** Signature covers chunk descriptor, chunks are checked afterwards */
+				slbv_context.chunk.enabled = TRUE;
+				break;
+#endif /* _WITH_SLBV_CHUNKED_IMAGE_ */
+#ifdef _WITH_SLBV_COMPRESSED_IMAGE_
+			case N_SLBV_APP_TYPE_COMPRESSED:
+				slbv_context.decryption = FALSE;
+				/** Signature covers compressed stream, decompression is done while hashing */
+				slbv_context.stream.type = N_SLBV_STREAM_LZ4;
+				break;
+#endif /* _WITH_SLBV_COMPRESSED_IMAGE_ */
+#ifdef _WITH_SLBV_ENCRYPTED_IMAGE_
+			case N_SLBV_APP_TYPE_ENCRYPTED:
+				/** Signature covers ciphertext, decryption is done while hashing */
+				slbv_context.decryption = TRUE;
+				slbv_context.stream.type = N_SLBV_STREAM_AES_CTR;
+				break;
+#else
+			case N_SLBV_APP_TYPE_ENCRYPTED:
+#endif /* _WITH_SLBV_ENCRYPTED_IMAGE_ */
+			default:
+				err = N_SLBV_ERR_APPLI_TYPE_NOT_SUPPORTED;
+				goto slbv_check_slb_out;
+		}
+		/** Check address range ***********************************************/
+		/** Now check binary size */
+		if( ( ( sizeof(t_secure_header) + C_SIGNATURE_MAX_SIZE ) >= slbv_context.p_hdr->secure_appli_image_size ) &&
+			( C_SEC_HDR_TWO_SIGNATURES == slbv_context.p_hdr->nb_signatures ) )
+		{
+			/** Size to small */
+			err = N_SLBV_ERR_INVAL;
+			goto slbv_check_slb_out;
+		}
+		else if( ( sizeof(t_secure_header) >= slbv_context.p_hdr->secure_appli_image_size ) &&
+				( C_SEC_HDR_ONE_SIGNATURE == slbv_context.p_hdr->nb_signatures ) )
+		{
+			/** Size to small */
+			err = N_SLBV_ERR_INVAL;
+			goto slbv_check_slb_out;
+		}
+#ifdef _SLBV_OLD_BEHAVIOR_
+		/** Check binary offset coherence */
+		if( ( sizeof(t_secure_header) != slbv_context.p_hdr->fimware_start_offset ) &&
+			( C_SEC_HDR_ONE_SIGNATURE == slbv_context.p_hdr->nb_signatures ) )
+		{
+			/** Offset does not match header size with 1 certificate */
+			err = N_SLBV_ERR_INVAL_BINARY_OFST;
+			goto slbv_check_slb_out;
+
+		}
+		else if( ( ( sizeof(t_secure_header) + C_SIGNATURE_MAX_SIZE ) != slbv_context.p_hdr->fimware_start_offset ) &&
+				( C_SEC_HDR_TWO_SIGNATURES == slbv_context.p_hdr->nb_signatures ) )
+		{
+			/** Offset does not match header size with 2 certificates */
+			err = N_SLBV_ERR_INVAL_BINARY_OFST;
+			goto slbv_check_slb_out;
+		}
+#endif /** _SLBV_OLD_BEHAVIOR_ */
+#if __riscv_xlen == 32
+		/** 32bits */
+		if( C_SEC_HDR_ADDRESS_SIZE_32BITS != slbv_context.p_hdr->address_size )
+#elif __riscv_xlen == 64
+		/** 64bits */
+		if( C_SEC_HDR_ADDRESS_SIZE_64BITS != slbv_context.p_hdr->address_size )
+#else
+#error [__riscv_xlen] A value for bus width must be defined
+#endif /* __riscv_xlen */
+		{
+			/**  */
+			err = N_SLBV_ERR_ADDR_SIZE_NOT_SUPPORTED;
+			goto slbv_check_slb_out;
+		}
+		/** Now */
+		src_binary = (volatile uint_pltfrm)slbv_context.p_hdr;
+		/** Then binary offset from header */
+		src_binary += slbv_context.p_hdr->fimware_start_offset;
+		/** Compute raw binary size : size given in header - binary offset*/
+		raw_binary_size = slbv_context.p_hdr->secure_appli_image_size - ( sizeof(t_secure_header) + slbv_context.p_hdr->fimware_start_offset );
+		if( C_SEC_HDR_TWO_SIGNATURES == slbv_context.p_hdr->nb_signatures )
+		{
+			raw_binary_size -= C_SIGNATURE_MAX_SIZE;
+		}
+		/** Check if raw binary size is coherent, i.e. it should be at least one instruction */
+		if( ( p_ctx->misa & ( 0x1 << C_MISA_EXTENSION_BIT_COMPRESSED_OFST ) ) &&
+			( sizeof(uint16_t) > raw_binary_size ) )
+		{
+			/** Binary is not even one compressed instruction */
+			err = N_SLBV_ERR_BINARY_SIZE_INCOHERENCE;
+			goto slbv_check_slb_out;
+		}
+		else if( !( p_ctx->misa & ( 0x1 << C_MISA_EXTENSION_BIT_COMPRESSED_OFST ) ) &&
+				( sizeof(uint32_t) > raw_binary_size ) )
+		{
+			/** Binary is not even one compressed instruction */
+			err = N_SLBV_ERR_BINARY_SIZE_INCOHERENCE;
+			goto slbv_check_slb_out;
+		}
+#ifdef _WITH_SLBV_MANIFEST_
+		if( TRUE == slbv_context.manifest.enabled )
+		{
+			/** Copy and execution addresses are given per segment, they are checked once manifest is trusted */
+			goto slbv_check_slb_certificates;
+		}
+#endif /* _WITH_SLBV_MANIFEST_ */
+#ifdef _WITH_SLBV_HEADER_V2_
+		if( TRUE == slbv_context.v2.enabled )
+		{
+			/** Load addresses are given per segment, they are checked once segment table is trusted */
+			goto slbv_check_slb_certificates;
+		}
+#endif /* _WITH_SLBV_HEADER_V2_ */
+		/** By default, binary is installed as is */
+		install_size = raw_binary_size;
+		exec_size = slbv_context.p_hdr->secure_appli_image_size;
+#ifdef _WITH_SLBV_STREAMED_INSTALL_
+		if( ( N_SLBV_STREAM_NONE != slbv_context.stream.type ) &&
+			( (uint_pltfrm)slbv_context.p_hdr + sizeof(t_secure_header) > src_binary ) )
+		{
+			/** Stream must be located after header */
+			err = N_SLBV_ERR_INVAL_BINARY_OFST;
+			goto slbv_check_slb_out;
+		}
+#endif /* _WITH_SLBV_STREAMED_INSTALL_ */
+#ifdef _WITH_SLBV_COMPRESSED_IMAGE_
+		if( N_SLBV_STREAM_LZ4 == slbv_context.stream.type )
+		{
+			/** Compressed stream starts with its descriptor */
+			if( ( sizeof(t_slbv_comp_desc) > raw_binary_size ) ||
+				( C_SLBV_COMP_DESC_MAGIC != ((volatile t_slbv_comp_desc*)src_binary)->magic ) )
+			{
+				/** Not a compressed stream */
+				err = N_SLBV_ERR_DECOMPRESSION_FAILURE;
+				goto slbv_check_slb_out;
+			}
+			/** Destination area must hold decompressed binary */
+			install_size = ((volatile t_slbv_comp_desc*)src_binary)->uncompressed_size;
+			exec_size = install_size;
+		}
+#endif /* _WITH_SLBV_COMPRESSED_IMAGE_ */
+#ifdef _WITH_SLBV_ENCRYPTED_IMAGE_
+		if( N_SLBV_STREAM_AES_CTR == slbv_context.stream.type )
+		{
+			/** Encrypted stream starts with its descriptor */
+			if( ( sizeof(t_slbv_enc_desc) > raw_binary_size ) ||
+				( C_SLBV_ENC_DESC_MAGIC != ((volatile t_slbv_enc_desc*)src_binary)->magic ) ||
+				( ( C_AES128_SIZE != ((volatile t_slbv_enc_desc*)src_binary)->key_size ) &&
+				( C_AES256_SIZE != ((volatile t_slbv_enc_desc*)src_binary)->key_size ) ) )
+			{
+				/** Not an encrypted stream */
+				err = N_SLBV_ERR_DECRYPTION_FAILURE;
+				goto slbv_check_slb_out;
+			}
+			/** Plaintext has same size as ciphertext */
+			install_size = ((volatile t_slbv_enc_desc*)src_binary)->payload_size;
+			exec_size = install_size;
+		}
+#endif /* _WITH_SLBV_ENCRYPTED_IMAGE_ */
+		/** Verify that copy and execution addresses are consistent */
+		/** Get copy address */
+		memcpy((void*)&addr_copy, (const void*)slbv_context.p_hdr->copy_address, sizeof(uint_pltfrm));
+		/** Get execution address */
+		memcpy((void*)&addr_exec, (const void*)slbv_context.p_hdr->execution_address, sizeof(uint_pltfrm));
+		/** Check if it's XiP */
+#if __riscv_xlen == 32
+		/** 32bits */
+		if( C_PATTERN_VIRGIN_32BITS == addr_copy )
+#elif __riscv_xlen == 64
+		/** 64bits */
+		if( C_PATTERN_VIRGIN_64BITS == addr_copy )
+#else
+#error [__riscv_xlen] A value for bus width must be defined
+#endif /* __riscv_xlen */
+		{
+			/** Ok, it's eXecute in Place then updated boundaries */
+			boundary_down = (uint_pltfrm)&__qspi_start;
+			boundary_up = boundary_down + (uint_pltfrm)&__qspi_size;
+#ifdef _WITH_SLBV_EMMC_
+			if( TRUE == slbv_context.emmc.loaded )
+			{
+				/** Image staged from eMMC runs where it has been staged */
+				boundary_down = (uint_pltfrm)&__emmc_stage_start_addr;
+				boundary_up = (uint_pltfrm)&__emmc_stage_end_addr;
+			}
+#endif /* _WITH_SLBV_EMMC_ */
+			/** Update addr_copy to reflect XiP choice */
+			addr_copy = boundary_down;
+			/** Refresh token */
+			token_xip = TRUE;
+#ifdef _WITH_SLBV_STREAMED_INSTALL_
+			if( N_SLBV_STREAM_NONE != slbv_context.stream.type )
+			{
+				/** Compressed or encrypted binary can not be executed in place */
+				err = N_SLBV_ERR_APPLI_TYPE_NOT_SUPPORTED;
+				goto slbv_check_slb_out;
+			}
+#endif /* _WITH_SLBV_STREAMED_INSTALL_ */
+		}
+		/** Check is copy address is in range if not XIP */
+		else if( ( (uint_pltfrm)boundary_down <= addr_copy) && ( (uint_pltfrm)boundary_up >= ( addr_copy + install_size ) ) )
+		{
+			/** Ok, destination area is in range */
+		}
+		else
+		{
+			/** Copy address not in expected area */
+			err = N_SLBV_ERR_NOT_IN_RANGE;
+			goto slbv_check_slb_out;
+		}
+		/** Check if execution address is in destination area (copy address + binary size - 1 opcode size ) */
+		if( ( addr_copy <= addr_exec ) &&
+			( ( addr_copy + exec_size - sizeof(uint32_t) ) >= addr_exec) )
+		{
+			/** Set 64bits execution address to context structure */
+			slbv_context.jump_fct_ptr = (void*)addr_exec;
+#ifdef _WITH_SLBV_WARM_RESET_
+			/** Binary as it runs, for warm reset integrity confirmation */
+			slbv_context.warm.image_addr = ( TRUE == token_xip ) ? src_binary : addr_copy;
+			slbv_context.warm.image_size = install_size;
+			slbv_context.warm.firmware_version = slbv_context.p_hdr->firmware_version;
+#endif /* _WITH_SLBV_WARM_RESET_ */
+		}
+		else
+		{
+			/** Execution address does not fit in */
+			err = N_SLBV_ERR_EXEC_NOT_IN_RANGE;
+			goto slbv_check_slb_out;
+		}
+#if defined(_WITH_SLBV_MANIFEST_) || defined(_WITH_SLBV_HEADER_V2_)
+slbv_check_slb_certificates:
+#endif /* _WITH_SLBV_MANIFEST_ || _WITH_SLBV_HEADER_V2_ */
+		/** Certificate(s) management *****************************************/
+		/** Check algorithm */
+		if( N_KM_ALGO_ECDSA384 != slbv_context.p_hdr->algo )
+		{
+			/** Algorithm not supported */
+			err = N_SLBV_ERR_ALGO_NOT_SUPPORTED;
+			goto slbv_check_slb_out;
+		}
+		/** Set number of signatures to verify */
+		if( C_SEC_HDR_ONE_SIGNATURE == slbv_context.p_hdr->nb_signatures )
+		{
+			/**  */
+			loop = 1;
+		}
+#ifdef __WITH_2_SIGNATURES_SUPORT_
+		else if ( C_SEC_HDR_TWO_SIGNATURES == slbv_context.p_hdr->nb_signatures )
+		{
+			/**  */
+			loop = 2;
+		}
+#endif /* __WITH_2_SIGNATURES_SUPORT_ */
+		else
+		{
+			/** Value is not in range */
+			err = N_SLBV_ERR_NOT_SUPPORTED;
+			goto slbv_check_slb_out;
+		}
+		/** Check key(s) coherence */
+		if( ( C_SEC_HDR_ONE_SIGNATURE == slbv_context.p_hdr->nb_signatures ) &&
+				( N_KM_KEYID_CSK != slbv_context.p_hdr->sign_keyid_1 ) )
+		{
+			/**  */
+			err = N_SLBV_ERR_KEY_INCOHERENCE;
+			goto slbv_check_slb_out;
+		}
+		else if( C_EDCSA384_SIZE_BITS != slbv_context.p_hdr->signature_size_bits )
+		{
+			/** Bad key size */
+			err = N_SLBV_ERR_WRONG_KEY_SIZE;
+			goto slbv_check_slb_out;
+		}
+		/** Check signature(s) - Enter the loop */
+		for( i = 0;i < loop;i++ )
+		{
+			/** Initialize key buffer */
+			memset((void*)&key_data, 0x00, sizeof(t_key_data));
+			/** Assign pointers */
+			key.p_descriptor = (uint32_t*)&key_data.algo;
+			key.ecdsa.p_x = (uint8_t*)key_data.key;
+			key.ecdsa.p_y = key.ecdsa.p_x + C_EDCSA384_SIZE;
+			key.certificate.p_x = (uint8_t*)key_data.certificate;
+			key.certificate.p_y = key.certificate.p_x + C_EDCSA384_SIZE;
+			switch( i )
+			{
+				case 0:
+					key_sig = slbv_context.p_hdr->sign_keyid_1;
+					break;
+				case 1:
+					key_sig = slbv_context.p_hdr->sign_keyid_2;
+					break;
+				default:
+					err = GENERIC_ERR_CRITICAL;
+					goto slbv_check_slb_out;
+			}
+			/** Retrieve key */
+			err = km_get_key(p_ctx,
+								key_sig,
+								(t_km_key*)&key,
+								(uint32_t*)&tmp);
+			if( err )
+			{
+				/** Valid CSK not available/found */
+				err = N_SLBV_ERR_NO_CSK_AVAILABLE;
+				goto slbv_check_slb_out;
+			}
+			/**  */
+			/** Initialization of hash buffer */
+#ifdef _WITH_GPIO_CHARAC_
+			/** Green LED Off/On */
+			metal_led_off(p_ctx->led[1]);
+			metal_led_on(p_ctx->led[1]);
+			/** Set GPIO SHA high */
+			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 1);
+#endif /* _WITH_GPIO_CHARAC_ */
+			err = scl_sha_init((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+								(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+								SCL_HASH_SHA384);
+#ifdef _WITH_GPIO_CHARAC_
+			/** Set GPIO SHA low */
+			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 0);
+#endif /* _WITH_GPIO_CHARAC_ */
+			if( SCL_OK != err )
+			{
+				/** Critical error */
+				err = N_SLBV_ERR_CRYPTO_FAILURE;
+				goto slbv_check_slb_out;
+			}
+			/** Hash header without signature */
+			p_tmp = (volatile uint8_t*)slbv_context.p_hdr;
+			/** Remove signature from structure size */
+			tmp_size = (volatile uint32_t)sizeof(t_secure_header) - C_SIGNATURE_MAX_SIZE;
+#ifdef _WITH_GPIO_CHARAC_
+			/** Set GPIO SHA high */
+			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 1);
+#endif /* _WITH_GPIO_CHARAC_ */
+			err = scl_sha_core((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+								(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+								(const uint8_t*)p_tmp,
+								tmp_size);
+#ifdef _WITH_GPIO_CHARAC_
+			/** Set GPIO SHA low */
+			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 0);
+#endif /* _WITH_GPIO_CHARAC_ */
+			if( SCL_OK != err )
+			{
+				/** Should not happen */
+				err = GENERIC_ERR_CRITICAL;
+				goto slbv_check_slb_out;
+			}
+
+			/** Hash binary image, starting from just after signature */
+			p_tmp = (volatile uint8_t*)slbv_context.p_hdr + sizeof(t_secure_header);
+			/**  */
+			tmp_size = (volatile uint32_t)slbv_context.p_hdr->secure_appli_image_size - sizeof(t_secure_header);
+			/** If 2 signatures then remove one ECDSA384 signature size */
+			if( C_SEC_HDR_TWO_SIGNATURES == slbv_context.p_hdr->nb_signatures )
+			{
+				tmp_size -= C_SIGNATURE_MAX_SIZE;
+			}
+#ifdef _WITH_SLBV_STREAMED_INSTALL_
+			if( ( N_SLBV_STREAM_NONE != slbv_context.stream.type ) && ( 0 == i ) )
+			{
+				/** Hash linearly up to stream only, it is hashed while installed below */
+				tmp_size = (volatile uint32_t)( src_binary - (uint_pltfrm)p_tmp );
+			}
+#endif /* _WITH_SLBV_STREAMED_INSTALL_ */
+#ifdef _WITH_SLBV_CHUNKED_IMAGE_
+			if( TRUE == slbv_context.chunk.enabled )
+			{
+				/** Only chunk descriptor (and so tree root) is signed, it follows signature(s) */
+				if( C_SEC_HDR_TWO_SIGNATURES == slbv_context.p_hdr->nb_signatures )
+				{
+					p_tmp += C_SIGNATURE_MAX_SIZE;
+				}
+				slbv_context.chunk.p_desc = (volatile t_slbv_chunk_desc*)p_tmp;
+				tmp_size = (volatile uint32_t)sizeof(t_slbv_chunk_desc);
+			}
+#endif /* _WITH_SLBV_CHUNKED_IMAGE_ */
+#ifdef _WITH_SLBV_MANIFEST_
+			if( TRUE == slbv_context.manifest.enabled )
+			{
+				/** Only manifest is signed, it follows signature(s) */
+				if( C_SEC_HDR_TWO_SIGNATURES == slbv_context.p_hdr->nb_signatures )
+				{
+					p_tmp += C_SIGNATURE_MAX_SIZE;
+				}
+				if( 0 == i )
+				{
+					/** Manifest is copied once, before any check : boot device is not read again for it */
+					memcpy((void*)&slbv_context.manifest.table, (const void*)p_tmp, offsetof(t_slbv_manifest, segment));
+					if( ( C_SLBV_MANIFEST_MAGIC != slbv_context.manifest.table.magic ) ||
+						!slbv_context.manifest.table.nb_segments ||
+						( C_SLBV_MANIFEST_SEG_MAX < slbv_context.manifest.table.nb_segments ) )
+					{
+						/** Manifest is not usable */
+						err = N_SLBV_ERR_MANIFEST_INVALID;
+						goto slbv_check_slb_out;
+					}
+					memcpy((void*)slbv_context.manifest.table.segment,
+							(const void*)( p_tmp + offsetof(t_slbv_manifest, segment) ),
+							slbv_context.manifest.table.nb_segments * sizeof(t_slbv_manifest_seg));
+					/** Segments data must be located after manifest on boot device */
+					slbv_context.manifest.table_end = (uint_pltfrm)p_tmp + offsetof(t_slbv_manifest, segment) +
+														( slbv_context.manifest.table.nb_segments * sizeof(t_slbv_manifest_seg) );
+				}
+				/** Signature covers RAM copy */
+				p_tmp = (volatile uint8_t*)&slbv_context.manifest.table;
+				tmp_size = (volatile uint32_t)( offsetof(t_slbv_manifest, segment) +
+												( slbv_context.manifest.table.nb_segments * sizeof(t_slbv_manifest_seg) ) );
+			}
+#endif /* _WITH_SLBV_MANIFEST_ */
+#ifdef _WITH_SLBV_HEADER_V2_
+			if( TRUE == slbv_context.v2.enabled )
+			{
+				/** Only segment table is signed, it follows signature(s) */
+				if( C_SEC_HDR_TWO_SIGNATURES == slbv_context.p_hdr->nb_signatures )
+				{
+					p_tmp += C_SIGNATURE_MAX_SIZE;
+				}
+				if( 0 == i )
+				{
+					/** Segment table is copied once, before any check : boot device is not read again for it */
+					memcpy((void*)&slbv_context.v2.table, (const void*)p_tmp, offsetof(t_slbv_v2_table, segment));
+					if( ( C_SLBV_V2_MAGIC != slbv_context.v2.table.magic ) ||
+						!slbv_context.v2.table.nb_segments ||
+						( C_SLBV_V2_SEG_MAX < slbv_context.v2.table.nb_segments ) )
+					{
+						/** Segment table is not usable */
+						err = N_SLBV_ERR_V2_SEGMENT_INVALID;
+						goto slbv_check_slb_out;
+					}
+					memcpy((void*)slbv_context.v2.table.segment,
+							(const void*)( p_tmp + offsetof(t_slbv_v2_table, segment) ),
+							slbv_context.v2.table.nb_segments * sizeof(t_slbv_v2_seg));
+					/** Stored data must be located after segment table on boot device */
+					slbv_context.v2.table_end = (uint_pltfrm)p_tmp + offsetof(t_slbv_v2_table, segment) +
+												( slbv_context.v2.table.nb_segments * sizeof(t_slbv_v2_seg) );
+				}
+				/** Signature covers RAM copy */
+				p_tmp = (volatile uint8_t*)&slbv_context.v2.table;
+				tmp_size = (volatile uint32_t)( offsetof(t_slbv_v2_table, segment) +
+												( slbv_context.v2.table.nb_segments * sizeof(t_slbv_v2_seg) ) );
+			}
+#endif /* _WITH_SLBV_HEADER_V2_ */
+#ifdef _WITH_SBRM_PROFILING_
+			sbrm_prof_mark(N_SBRM_PROF_SHA);
+#endif /* _WITH_SBRM_PROFILING_ */
+			/** Hash binary image */
+#ifdef _WITH_GPIO_CHARAC_
+			/** Set GPIO SHA high */
+			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 1);
+#endif /* _WITH_GPIO_CHARAC_ */
+			err = scl_sha_core((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+								(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+								(const uint8_t*)p_tmp,
+								tmp_size);
+#ifdef _WITH_GPIO_CHARAC_
+			/** Set GPIO SHA low */
+			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 0);
+#endif /* _WITH_GPIO_CHARAC_ */
+			if( SCL_OK != err )
+			{
+				/** Should not happen */
+				err = GENERIC_ERR_CRITICAL;
+				goto slbv_check_slb_out;
+			}
+#ifdef _WITH_SLBV_STREAMED_INSTALL_
+			if( ( N_SLBV_STREAM_NONE != slbv_context.stream.type ) && ( 0 == i ) )
+			{
+				/** Keep track of destination area, it must be wiped if signature does not match */
+				slbv_context.stream.dst = addr_copy;
+				slbv_context.stream.size = install_size;
+				slbv_context.stream.installed = TRUE;
+				/** Signed area ends where linear hash would have ended */
+				tmp_size = (volatile uint32_t)slbv_context.p_hdr->secure_appli_image_size;
+				if( C_SEC_HDR_TWO_SIGNATURES == slbv_context.p_hdr->nb_signatures )
+				{
+					tmp_size -= C_SIGNATURE_MAX_SIZE;
+				}
+				/** Hash rest of signed area, installing stream at destination on the fly */
+				switch( slbv_context.stream.type )
+				{
+#ifdef _WITH_SLBV_COMPRESSED_IMAGE_
+					case N_SLBV_STREAM_LZ4:
+						err = slbv_comp_hash_install(p_ctx,
+														src_binary,
+														(uint_pltfrm)slbv_context.p_hdr + tmp_size,
+														addr_copy,
+														install_size);
+						break;
+#endif /* _WITH_SLBV_COMPRESSED_IMAGE_ */
+#ifdef _WITH_SLBV_ENCRYPTED_IMAGE_
+					case N_SLBV_STREAM_AES_CTR:
+						err = slbv_enc_hash_install(p_ctx,
+														src_binary,
+														(uint_pltfrm)slbv_context.p_hdr + tmp_size,
+														addr_copy,
+														install_size);
+						break;
+#endif /* _WITH_SLBV_ENCRYPTED_IMAGE_ */
+					default:
+						err = GENERIC_ERR_CRITICAL;
+						break;
+				}
+				if( NO_ERROR != err )
+				{
+					goto slbv_check_slb_out;
+				}
+			}
+#endif /* _WITH_SLBV_STREAMED_INSTALL_ */
+			/** Then finish computation */
+			hash_len = sizeof(p_ctx->digest);
+			memset((void*)p_ctx->digest, 0x00, SHA384_BYTE_HASHSIZE);
+#ifdef _WITH_GPIO_CHARAC_
+			/** Set GPIO SHA high */
+			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 1);
+#endif /* _WITH_GPIO_CHARAC_ */
+			err = scl_sha_finish((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+									(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+									p_ctx->digest,
+									&hash_len);
+#ifdef _WITH_GPIO_CHARAC_
+			/** Set GPIO SHA low */
+			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 0);
+#endif /* _WITH_GPIO_CHARAC_ */
+#ifdef _WITH_SBRM_PROFILING_
+			sbrm_prof_mark(N_SBRM_PROF_SHA_END);
+#endif /* _WITH_SBRM_PROFILING_ */
+			if( SCL_OK != err )
+			{
+				/** Critical error */
+				err = GENERIC_ERR_CRITICAL;
+				goto slbv_check_slb_out;
+			}
+			/** Assign parameters */
+			Q.x = key.ecdsa.p_x;
+			Q.y = key.ecdsa.p_y;
+			signature.r = (uint8_t*)( slbv_context.p_hdr->signature + ( i * C_SIGNATURE_MAX_SIZE ) );
+			signature.s = signature.r + C_EDCSA384_SIZE;
+			/** Check certificate */
+#ifdef _WITH_GPIO_CHARAC_
+			/** Set GPIO check ECDSA high */
+			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA_ECDSA, 1);
+#endif /* _WITH_GPIO_CHARAC_ */
+#ifdef _WITH_SBRM_PROFILING_
+			sbrm_prof_mark(N_SBRM_PROF_ECDSA);
+#endif /* _WITH_SBRM_PROFILING_ */
+			err = scl_ecdsa_verification((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+											&ecc_secp384r1,
+											(const ecc_affine_const_point_t *const)&Q,
+											(const ecdsa_signature_const_t *const)&signature,
+											p_ctx->digest,
+											SHA384_BYTE_HASHSIZE);
+#ifdef _WITH_SBRM_PROFILING_
+			sbrm_prof_mark(N_SBRM_PROF_ECDSA_END);
+#endif /* _WITH_SBRM_PROFILING_ */
+#ifdef _WITH_GPIO_CHARAC_
+			/** Set GPIO check ECDSA low */
+			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA_ECDSA, 0);
+			/** Green LED Off */
+			metal_led_off(p_ctx->led[1]);
+#endif /* _WITH_GPIO_CHARAC_ */
+			if( SCL_OK != err )
+			{
+				/** SLB is not granted to be executed on this platform */
+				err = N_SLBV_ERR_CRYPTO_FAILURE;
+				goto slbv_check_slb_out;
+			}
+			else
+			{
+				/** No error */
+				err = NO_ERROR;
+			}
+		}
+#ifdef _WITH_SBRM_PROFILING_
+		sbrm_prof_mark(N_SBRM_PROF_COPY);
+#endif /* _WITH_SBRM_PROFILING_ */
+#ifdef _WITH_SLBV_MANIFEST_
+		if( TRUE == slbv_context.manifest.enabled )
+		{
+			/** Manifest is trusted now, install and check each segment against its digest */
+			err = slbv_manifest_process(p_ctx, slb_id);
+			goto slbv_check_slb_out;
+		}
+#endif /* _WITH_SLBV_MANIFEST_ */
+#ifdef _WITH_SLBV_HEADER_V2_
+		if( TRUE == slbv_context.v2.enabled )
+		{
+			/** Segment table is trusted now, scatter segments to their final addresses */
+			err = slbv_v2_process(p_ctx);
+			goto slbv_check_slb_out;
+		}
+#endif /* _WITH_SLBV_HEADER_V2_ */
+#ifdef _WITH_SLBV_CHUNKED_IMAGE_
+		if( TRUE == slbv_context.chunk.enabled )
+		{
+			/** Signed root is trusted now, check leaves table against it */
+			err = slbv_chunk_check_table(p_ctx,
+										(uint_pltfrm)slbv_context.chunk.p_desc,
+										(uint_pltfrm)src_binary,
+										raw_binary_size);
+			if( NO_ERROR != err )
+			{
+				goto slbv_check_slb_out;
+			}
+#ifdef _WITH_SLBV_INCREMENTAL_
+			if( FALSE == token_xip )
+			{
+				/** Chunks still intact since previous boot are neither copied nor hashed */
+				err = slbv_inc_process(p_ctx, src_binary, addr_copy, raw_binary_size);
+				goto slbv_check_slb_out;
+			}
+#endif /* _WITH_SLBV_INCREMENTAL_ */
+#ifdef _WITH_SLBV_LAZY_XIP_
+			if( TRUE == token_xip )
+			{
+				/** Defer chunks check to their first access, if image is eligible */
+				err = slbv_lazy_prepare(p_ctx, src_binary, raw_binary_size);
+				if( ( NO_ERROR != err ) || ( TRUE == slbv_context.lazy.pending ) )
+				{
+					goto slbv_check_slb_out;
+				}
+			}
+#endif /* _WITH_SLBV_LAZY_XIP_ */
+			/** Then copy (if not XiP) and check chunks one by one */
+			err = slbv_chunk_process(p_ctx, src_binary, addr_copy, raw_binary_size, token_xip);
+			goto slbv_check_slb_out;
+		}
+#endif /* _WITH_SLBV_CHUNKED_IMAGE_ */
+#ifdef _WITH_SLBV_STREAMED_INSTALL_
+		if( N_SLBV_STREAM_NONE != slbv_context.stream.type )
+		{
+			/** Already installed while verified */
+			goto slbv_check_slb_out;
+		}
+#endif /* _WITH_SLBV_STREAMED_INSTALL_ */
+		/** Check if FSBL is XIP or not, if so install it */
+		if( FALSE == token_xip )
+		{
+			/** If not, SLB has been checked ok, let's copy it at destination area */
+			memcpy((void*)addr_copy,
+					(const void*)( slbv_context.p_hdr + slbv_context.p_hdr->fimware_start_offset ),
+					raw_binary_size);
+		}
+	}
+slbv_check_slb_out:
+#ifdef _WITH_SBRM_PROFILING_
+	sbrm_prof_mark(N_SBRM_PROF_COPY_END);
+#endif /* _WITH_SBRM_PROFILING_ */
+#ifdef _WITH_SLBV_STREAMED_INSTALL_
+	if( ( NO_ERROR != err ) && ( TRUE == slbv_context.stream.installed ) )
+	{
+		/** Do not leave unverified code in destination area */
+		memset((void*)slbv_context.stream.dst, 0x00, slbv_context.stream.size);
+		slbv_context.stream.installed = FALSE;
+	}
+#endif /* _WITH_SLBV_STREAMED_INSTALL_ */
+	/** End Of Function */
+	return err;
+}
+
+#if defined(_WITH_SLBV_MANIFEST_) || defined(_WITH_SLBV_HEADER_V2_)
+/******************************************************************************/
+/** Does [dst, dst + size) overlap one of areas already written ? */
+uint8_t slbv_area_overlaps(uint_pltfrm dst, uint_pltfrm size, const t_slbv_installed_area *p_area, uint32_t nb_area)
+{
+	uint32_t									i;
+
+	for( i = 0;i < nb_area;i++ )
+	{
+		if( ( dst < ( p_area[i].dst + p_area[i].size ) ) &&
+			( p_area[i].dst < ( dst + size ) ) )
+		{
+			return TRUE;
+		}
+	}
+	/** End Of Function */
+	return FALSE;
+}
+#endif /* _WITH_SLBV_MANIFEST_ || _WITH_SLBV_HEADER_V2_ */
+
+#ifdef _WITH_SLBV_HEADER_V2_
+/******************************************************************************/
+/** Install each segment of header v2 at its final address, checking it against its digest on the way */
+int_pltfrm slbv_v2_process(t_context *p_ctx)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	t_slbv_v2_table								*p_table = &slbv_context.v2.table;
+	t_slbv_v2_seg								*p_seg;
+	uint_pltfrm									table_end;
+	uint_pltfrm									src;
+	uint_pltfrm									dst;
+	uint_pltfrm									exec;
+	uint64_t									filled;
+	uint64_t									done;
+	uint32_t									block;
+	uint32_t									flags;
+	uint32_t									i;
+	uint8_t										entry_found = FALSE;
+	uint8_t										digest[SHA384_BYTE_HASHSIZE] __attribute__((aligned(0x10)));
+	size_t										hash_len;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_v2_process_out;
+	}
+	/** Entry point is given by header */
+	memcpy((void*)&exec, (const void*)slbv_context.p_hdr->execution_address, sizeof(uint_pltfrm));
+	/** Only RAM copy of table is used, as bounded and signed */
+	table_end = slbv_context.v2.table_end;
+	slbv_context.v2.nb_installed = 0;
+	for( i = 0;( i < p_table->nb_segments ) && ( i < C_SLBV_V2_SEG_MAX );i++ )
+	{
+		p_seg = &p_table->segment[i];
+		flags = p_seg->flags;
+		/** Flags coherence : zero-filled segment has no data, XiP segment is neither copied nor expanded */
+		if( ( flags & ~C_SLBV_V2_SEG_FLAGS_ALL ) ||
+			!p_seg->mem_size ||
+			( ( flags & C_SLBV_V2_SEG_FLAG_ZERO_FILL ) && ( ( flags & ~C_SLBV_V2_SEG_FLAG_ZERO_FILL ) || p_seg->file_size ) ) ||
+			( !( flags & C_SLBV_V2_SEG_FLAG_ZERO_FILL ) && !p_seg->file_size ) ||
+			( ( flags & C_SLBV_V2_SEG_FLAG_XIP ) && ( ( flags & C_SLBV_V2_SEG_FLAG_COMPRESSED ) || ( p_seg->mem_size != p_seg->file_size ) ) ) ||
+			( !( flags & C_SLBV_V2_SEG_FLAG_COMPRESSED ) && ( p_seg->mem_size < p_seg->file_size ) ) ||
+			( (uint_pltfrm)p_seg->mem_size != p_seg->mem_size ) )
+		{
+			err = N_SLBV_ERR_V2_SEGMENT_INVALID;
+			goto slbv_v2_process_out;
+		}
+#ifndef _WITH_SLBV_COMPRESSED_IMAGE_
+		if( flags & C_SLBV_V2_SEG_FLAG_COMPRESSED )
+		{
+			/** No decompressor in this ROM */
+			err = N_SLBV_ERR_APPLI_TYPE_NOT_SUPPORTED;
+			goto slbv_v2_process_out;
+		}
+#endif /* _WITH_SLBV_COMPRESSED_IMAGE_ */
+		src = 0;
+		if( !( flags & C_SLBV_V2_SEG_FLAG_ZERO_FILL ) )
+		{
+			/** Stored data must be inside image, after segment table, and addressable */
+			if( ( ( p_seg->offset + p_seg->file_size ) < p_seg->offset ) ||
+				( ( p_seg->offset + p_seg->file_size ) > p_table->image_size ) ||
+				( ( (uint64_t)(uint_pltfrm)slbv_context.p_hdr + p_seg->offset + p_seg->file_size ) > (uint64_t)(uint_pltfrm)-1 ) )
+			{
+				err = N_SLBV_ERR_V2_SEGMENT_INVALID;
+				goto slbv_v2_process_out;
+			}
+			src = (uint_pltfrm)slbv_context.p_hdr + (uint_pltfrm)p_seg->offset;
+			if( src < table_end )
+			{
+				err = N_SLBV_ERR_V2_SEGMENT_INVALID;
+				goto slbv_v2_process_out;
+			}
+		}
+		if( flags & C_SLBV_V2_SEG_FLAG_XIP )
+		{
+			/** eXecute in Place, segment is checked where it is */
+			dst = src;
+		}
+		else
+		{
+			dst = (uint_pltfrm)p_seg->load_address;
+			if( ( (uint64_t)dst != p_seg->load_address ) ||
+				( (uint_pltfrm)&__sbr_free_start_addr > dst ) ||
+				( ( (uint64_t)(uint_pltfrm)&__sbr_free_end_addr - dst ) < p_seg->mem_size ) )
+			{
+				/** Load address not in expected area */
+				err = N_SLBV_ERR_NOT_IN_RANGE;
+				goto slbv_v2_process_out;
+			}
+			/** Segments must not overlap, a later one would overwrite checked data */
+			if( TRUE == slbv_area_overlaps(dst, (uint_pltfrm)p_seg->mem_size, slbv_context.v2.installed, slbv_context.v2.nb_installed) )
+			{
+				err = N_SLBV_ERR_V2_SEGMENT_INVALID;
+				goto slbv_v2_process_out;
+			}
+			slbv_context.v2.installed[slbv_context.v2.nb_installed].dst = dst;
+			slbv_context.v2.installed[slbv_context.v2.nb_installed].size = (uint_pltfrm)p_seg->mem_size;
+			slbv_context.v2.nb_installed++;
+		}
+		if( flags & C_SLBV_V2_SEG_FLAG_ZERO_FILL )
+		{
+			/** BSS : nothing stored, nothing to check */
+			memset((void*)dst, 0x00, (size_t)p_seg->mem_size);
+			continue;
+		}
+		err = scl_sha_init((metal_scl_t*)p_ctx->p_metal_sifive_scl, (scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx, SCL_HASH_SHA384);
+		if( SCL_OK != err )
+		{
+			err = N_SLBV_ERR_CRYPTO_FAILURE;
+			goto slbv_v2_process_out;
+		}
+#ifdef _WITH_SLBV_COMPRESSED_IMAGE_
+		if( flags & C_SLBV_V2_SEG_FLAG_COMPRESSED )
+		{
+			/** Expanded size is given by stream descriptor */
+			if( ( sizeof(t_slbv_comp_desc) > p_seg->file_size ) ||
+				( C_SLBV_COMP_DESC_MAGIC != ((volatile t_slbv_comp_desc*)src)->magic ) ||
+				( ((volatile t_slbv_comp_desc*)src)->uncompressed_size > p_seg->mem_size ) )
+			{
+				err = N_SLBV_ERR_DECOMPRESSION_FAILURE;
+				goto slbv_v2_process_out;
+			}
+			filled = ((volatile t_slbv_comp_desc*)src)->uncompressed_size;
+			/** Stream is hashed as fetched, while expanded to final address */
+			err = slbv_comp_hash_install(p_ctx, src, src + (uint_pltfrm)p_seg->file_size, dst, (uint32_t)filled);
+			if( NO_ERROR != err )
+			{
+				goto slbv_v2_process_out;
+			}
+		}
+		else
+#endif /* _WITH_SLBV_COMPRESSED_IMAGE_ */
+		{
+			/** Single pass : each block is copied, then what has been copied is hashed */
+			filled = p_seg->file_size;
+			for( done = 0;done < filled;done += block )
+			{
+				block = ( ( filled - done ) > C_SLBV_V2_COPY_BLOCK_SIZE ) ? C_SLBV_V2_COPY_BLOCK_SIZE : (uint32_t)( filled - done );
+				if( dst != src )
+				{
+					memcpy((void*)( dst + (uint_pltfrm)done ), (const void*)( src + (uint_pltfrm)done ), block);
+				}
+				err = scl_sha_core((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+									(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+									(const uint8_t*)( dst + (uint_pltfrm)done ),
+									block);
+				if( SCL_OK != err )
+				{
+					err = N_SLBV_ERR_CRYPTO_FAILURE;
+					goto slbv_v2_process_out;
+				}
+			}
+		}
+		hash_len = SHA384_BYTE_HASHSIZE;
+		err = scl_sha_finish((metal_scl_t*)p_ctx->p_metal_sifive_scl, (scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx, digest, &hash_len);
+		if( SCL_OK != err )
+		{
+			err = N_SLBV_ERR_CRYPTO_FAILURE;
+			goto slbv_v2_process_out;
+		}
+		if( memcmp((const void*)digest, (const void*)p_seg->digest, SHA384_BYTE_HASHSIZE) )
+		{
+			/** Segment does not match table */
+			err = N_SLBV_ERR_V2_SEGMENT_MISMATCH;
+			goto slbv_v2_process_out;
+		}
+		/** Zero-fill tail */
+		if( filled < p_seg->mem_size )
+		{
+			memset((void*)( dst + (uint_pltfrm)filled ), 0x00, (size_t)( p_seg->mem_size - filled ));
+		}
+		if( ( dst <= exec ) && ( ( dst + (uint_pltfrm)filled - sizeof(uint16_t) ) >= exec ) )
+		{
+			/** Entry point lies in checked code */
+			entry_found = TRUE;
+		}
+	}
+	if( FALSE == entry_found )
+	{
+		/** Execution address does not fit in */
+		err = N_SLBV_ERR_EXEC_NOT_IN_RANGE;
+		goto slbv_v2_process_out;
+	}
+	slbv_context.jump_fct_ptr = (void*)exec;
+	err = NO_ERROR;
+slbv_v2_process_out:
+	if( NO_ERROR != err )
+	{
+		/** Do not leave unverified code in destination areas */
+		for( i = 0;i < slbv_context.v2.nb_installed;i++ )
+		{
+			memset((void*)slbv_context.v2.installed[i].dst, 0x00, slbv_context.v2.installed[i].size);
+		}
+		slbv_context.v2.nb_installed = 0;
+	}
+	/** End Of Function */
+	return err;
+}
+#endif /* _WITH_SLBV_HEADER_V2_ */
+
+#ifdef _WITH_SLBV_AB_SLOTS_
+/******************************************************************************/
+/** Cheap header checks, nothing is hashed here - slot size is zero when unknown */
+int_pltfrm slbv_ab_precheck_slot(t_context *p_ctx, uint_pltfrm slot_addr, uint_pltfrm slot_size)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	volatile t_secure_header					*p_hdr = (volatile t_secure_header*)slot_addr;
+	uint32_t									rom_version;
+
+	/** Check input pointer */
+	if( !p_ctx || !slot_addr )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else if( ( C_SFLV_MAGIC_WORD1 != p_hdr->magic_word1 ) ||
+			( C_SFLV_MAGIC_WORD2 != p_hdr->magic_word2 ) )
+	{
+		/** Synchronization pattern(s), no match */
+		err = N_SLBV_ERR_SYNC_PTRN_FAILURE;
+	}
+	else
+	{
+		rom_version = ( ( SBR_REF_VERSION_EDIT << C_SBR_REF_VERSION_EDIT_OFST ) & C_SBR_REF_VERSION_EDIT_MASK ) |\
+						( ( SBR_REF_VERSION_MINOR << C_SBR_REF_VERSION_MINOR_OFST ) & C_SBR_REF_VERSION_MINOR_MASK ) |\
+						( ( SBR_REF_VERSION_MAJOR << C_SBR_REF_VERSION_MAJOR_OFST ) & C_SBR_REF_VERSION_MAJOR_MASK );
+		if( rom_version > p_hdr->rom_ref_version )
+		{
+			/** Application is not compatible */
+			err = N_SLBV_ERR_HDR_VERSION_MISMATCH;
+		}
+		else if( slbv_context.ref_appli_version > p_hdr->firmware_version )
+		{
+			/** Anti-rollback would reject it anyway */
+			err = N_SLBV_ERR_VERSION_MISMATCH;
+		}
+		else if( ( sizeof(t_secure_header) > p_hdr->secure_appli_image_size ) ||
+				( slot_size && ( slot_size < p_hdr->secure_appli_image_size ) ) )
+		{
+			/** Image cannot fit in slot */
+			err = N_SLBV_ERR_BINARY_SIZE_INCOHERENCE;
+		}
+		else
+		{
+			/** Worth a full verification */
+			err = NO_ERROR;
+		}
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Read boot record then build ordered list of slots to try */
+int_pltfrm slbv_ab_select(t_context *p_ctx)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	volatile t_slbv_ab_record					*p_record;
+	uint_pltfrm									base = 0;
+	uint_pltfrm									device_size;
+	uint32_t									crc = 0;
+	uint32_t									nb_slots = 1;
+	uint32_t									slot;
+	uint32_t									i;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_ab_select_out;
+	}
+	/** Same base address as the one slbv_check_slb will use */
+	err = slbv_get_boot_address(p_ctx, &base);
+	if( err || !base )
+	{
+		/** Set default value - address of free area in internal RAM/Flash */
+		base = (uint_pltfrm)&__iflash_start;
+	}
+	/** Reference version is needed for pre-checks */
+	err = slbv_get_application_version(p_ctx, &slbv_context.ref_appli_version);
+	if( N_SLBV_ERR_NO_APP_REF_VERSION == err )
+	{
+		/** Set very default version */
+		slbv_context.ref_appli_version = (uint32_t)1UL;
+	}
+	else if( err )
+	{
+		/** Should not happen */
+		goto slbv_ab_select_out;
+	}
+	/** Only memory mapped boot flash has a known size, image is alone on any other boot area */
+	device_size = ( (uint_pltfrm)&__qspi_start == base ) ? (uint_pltfrm)&__qspi_size : 0;
+	/** Without boot record, image is alone on device : slot A spans whole device */
+	slbv_context.ab.active = C_SLBV_AB_SLOT_A;
+	slbv_context.ab.slot_size = device_size;
+	if( ( C_SLBV_AB_RECORD_OFST + sizeof(t_slbv_ab_record) ) <= device_size )
+	{
+		/** Boot record is owned by update agent : ROM reads it, it never writes boot device */
+		p_record = (volatile t_slbv_ab_record*)( base + C_SLBV_AB_RECORD_OFST );
+		if( ( C_SLBV_AB_RECORD_MAGIC == p_record->magic ) &&
+			( C_SLBV_AB_SLOT_NB > p_record->active_slot ) )
+		{
+			err = sbrm_compute_crc(&crc, (uint8_t*)p_record, offsetof(t_slbv_ab_record, crc));
+			if( ( NO_ERROR == err ) && ( crc == p_record->crc ) )
+			{
+				/** Record is consistent, device holds both slots */
+				slbv_context.ab.active = p_record->active_slot;
+				slbv_context.ab.slot_size = C_SLBV_AB_SLOT_SIZE;
+				nb_slots = C_SLBV_AB_SLOT_NB;
+			}
+		}
+	}
+	/** Active slot first, then the other one */
+	slbv_context.ab.nb_candidates = 0;
+	for( i = 0;i < C_SLBV_AB_SLOT_NB;i++ )
+	{
+		slot = ( slbv_context.ab.active + i ) % C_SLBV_AB_SLOT_NB;
+		slbv_context.ab.attempt[slot].tried = FALSE;
+		slbv_context.ab.attempt[slot].err = N_SLBV_ERR_AB_NO_VALID_SLOT;
+		if( i < nb_slots )
+		{
+			slbv_context.ab.attempt[slot].err = slbv_ab_precheck_slot(p_ctx, base + ( slot * slbv_context.ab.slot_size ), slbv_context.ab.slot_size);
+		}
+		if( NO_ERROR == slbv_context.ab.attempt[slot].err )
+		{
+			/** Candidate */
+			slbv_context.ab.candidate[slbv_context.ab.nb_candidates++] = slot;
+		}
+	}
+	/** No error */
+	err = NO_ERROR;
+slbv_ab_select_out:
+	/** End Of Function */
+	return err;
+}
+#endif /* _WITH_SLBV_AB_SLOTS_ */
+
+#if defined(_WITH_SLBV_CHUNKED_IMAGE_) || defined(_WITH_SLBV_MANIFEST_) || defined(_WITH_SLBV_WARM_RESET_) || defined(_WITH_SLBV_HEADER_V2_)
+/******************************************************************************/
+/** One shot SHA-384 with given SCL engine and context */
+int_pltfrm slbv_hash(t_context *p_ctx,
+						metal_scl_t *p_scl,
+						scl_sha_ctx_t *p_sha_ctx,
+						const uint8_t *p_data,
+						uint32_t size,
+						uint8_t *p_digest)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	size_t										hash_len = SHA384_BYTE_HASHSIZE;
+
+	/** Check input pointer */
+	if( !p_ctx || !p_scl || !p_sha_ctx || !p_data || !p_digest )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+#ifdef _WITH_GPIO_CHARAC_
+		/** Set GPIO SHA high */
+		metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 1);
+#endif /* _WITH_GPIO_CHARAC_ */
+		err = scl_sha_init(p_scl, p_sha_ctx, SCL_HASH_SHA384);
+		if( SCL_OK == err )
+		{
+			err = scl_sha_core(p_scl, p_sha_ctx, p_data, size);
+		}
+		if( SCL_OK == err )
+		{
+			err = scl_sha_finish(p_scl, p_sha_ctx, p_digest, &hash_len);
+		}
+#ifdef _WITH_GPIO_CHARAC_
+		/** Set GPIO SHA low */
+		metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 0);
+#endif /* _WITH_GPIO_CHARAC_ */
+		if( SCL_OK != err )
+		{
+			/** Critical error */
+			err = N_SLBV_ERR_CRYPTO_FAILURE;
+		}
+		else
+		{
+			/** No error */
+			err = NO_ERROR;
+		}
+	}
+	/** End Of Function */
+	return err;
+}
+
+#endif /* _WITH_SLBV_CHUNKED_IMAGE_ || _WITH_SLBV_MANIFEST_ || _WITH_SLBV_WARM_RESET_ || _WITH_SLBV_HEADER_V2_ */
+
+#ifdef _WITH_SLBV_CHUNKED_IMAGE_
+/******************************************************************************/
+/** Check chunk descriptor coherence, then leaves table against signed root */
+int_pltfrm slbv_chunk_check_table(t_context *p_ctx, uint_pltfrm desc_addr, uint_pltfrm leaves_end, uint32_t raw_binary_size)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	volatile t_slbv_chunk_desc					*p_desc = (volatile t_slbv_chunk_desc*)desc_addr;
+	uint32_t									nb_chunks;
+
+	/** Check input pointer */
+	if( !p_ctx || !desc_addr )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else if( ( C_SLBV_CHUNK_DESC_MAGIC != p_desc->magic ) ||
+			( C_SLBV_CHUNK_SIZE_LOG2_MIN > p_desc->chunk_size_log2 ) ||
+			( C_SLBV_CHUNK_SIZE_LOG2_MAX < p_desc->chunk_size_log2 ) )
+	{
+		/** Descriptor is not usable */
+		err = N_SLBV_ERR_CHUNK_DESC_INVALID;
+	}
+	else
+	{
+		/** Compute chunk size */
+		slbv_context.chunk.size = ( 0x1UL << p_desc->chunk_size_log2 );
+		/** Number of chunks needed to cover raw binary, last one may be partial */
+		nb_chunks = ( raw_binary_size + slbv_context.chunk.size - 1 ) >> p_desc->chunk_size_log2;
+		/** Leaves table is located just after descriptor */
+		slbv_context.chunk.p_leaves = (volatile uint8_t*)( desc_addr + sizeof(t_slbv_chunk_desc) );
+		if( ( nb_chunks != p_desc->nb_chunks ) ||
+			( C_SLBV_CHUNK_NB_MAX < nb_chunks ) ||
+			( ( (uint_pltfrm)slbv_context.chunk.p_leaves + ( nb_chunks * C_SLBV_CHUNK_HASH_SIZE ) ) > leaves_end ) )
+		{
+			/** Leaves table does not fit between descriptor and binary */
+			err = N_SLBV_ERR_CHUNK_DESC_INVALID;
+			goto slbv_chunk_check_table_out;
+		}
+		/** Root is hash of concatenated leaves */
+		err = slbv_hash(p_ctx,
+							(metal_scl_t*)p_ctx->p_metal_sifive_scl,
+							(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+							(const uint8_t*)slbv_context.chunk.p_leaves,
+							nb_chunks * C_SLBV_CHUNK_HASH_SIZE,
+							p_ctx->digest);
+		if( NO_ERROR != err )
+		{
+			goto slbv_chunk_check_table_out;
+		}
+		/** Compare with signed root */
+		if( memcmp((const void*)p_ctx->digest, (const void*)p_desc->root, C_SLBV_CHUNK_HASH_SIZE) )
+		{
+			/** Leaves table has been tampered */
+			err = N_SLBV_ERR_CHUNK_ROOT_MISMATCH;
+		}
+	}
+slbv_chunk_check_table_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Check one chunk against its leaf - 'dst' is hashed, so copy must be done before */
+int_pltfrm slbv_chunk_check(t_context *p_ctx,
+							metal_scl_t *p_scl,
+							scl_sha_ctx_t *p_sha_ctx,
+							uint32_t index,
+							uint_pltfrm src,
+							uint_pltfrm dst,
+							uint32_t size)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint8_t										digest[C_SLBV_CHUNK_HASH_SIZE] __attribute__((aligned(0x10)));
+
+	/** Check input pointer */
+	if( !p_ctx || !src || !dst || !slbv_context.chunk.p_leaves )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+		/** Install chunk if needed */
+		if( src != dst )
+		{
+			memcpy((void*)dst, (const void*)src, size);
+		}
+		/** Hash installed chunk, so that what is checked is what will be executed */
+		err = slbv_hash(p_ctx, p_scl, p_sha_ctx, (const uint8_t*)dst, size, digest);
+		if( NO_ERROR != err )
+		{
+			goto slbv_chunk_check_out;
+		}
+		if( memcmp((const void*)digest,
+					(const void*)( slbv_context.chunk.p_leaves + ( index * C_SLBV_CHUNK_HASH_SIZE ) ),
+					C_SLBV_CHUNK_HASH_SIZE) )
+		{
+			/** Corrupted chunk */
+			err = N_SLBV_ERR_CHUNK_HASH_MISMATCH;
+		}
+	}
+slbv_chunk_check_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Check chunks [first, first + count[ of raw binary */
+int_pltfrm slbv_chunk_range(t_context *p_ctx,
+							metal_scl_t *p_scl,
+							scl_sha_ctx_t *p_sha_ctx,
+							uint32_t first,
+							uint32_t count,
+							uint_pltfrm src,
+							uint_pltfrm dst,
+							uint32_t raw_binary_size)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint32_t									index = first;
+	uint32_t									offset = first * slbv_context.chunk.size;
+	uint32_t									size;
+
+	/** Check input pointer */
+	if( !p_ctx || !p_scl || !p_sha_ctx || !src || !dst )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+		/** Stop at first corrupted chunk */
+		err = NO_ERROR;
+		while( ( index < ( first + count ) ) && ( offset < raw_binary_size ) && ( NO_ERROR == err ) )
+		{
+			/** Last chunk may be partial */
+			size = ( ( raw_binary_size - offset ) > slbv_context.chunk.size ) ? slbv_context.chunk.size : ( raw_binary_size - offset );
+			err = slbv_chunk_check(p_ctx, p_scl, p_sha_ctx, index, src + offset, dst + offset, size);
+			offset += size;
+			index++;
+		}
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm slbv_chunk_process(t_context *p_ctx, uint_pltfrm src, uint_pltfrm dst, uint32_t raw_binary_size, uint8_t token_xip)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointer */
+	if( !p_ctx || !src || !dst )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+		/** In XiP case, chunks are checked in place */
+		if( TRUE == token_xip )
+		{
+			dst = src;
+		}
+#ifdef _WITH_SLBV_MULTI_HART_
+		/** Spread chunks over available harts */
+		err = slbv_hart_dispatch(p_ctx, src, dst, raw_binary_size);
+#else
+		err = slbv_chunk_range(p_ctx,
+								(metal_scl_t*)p_ctx->p_metal_sifive_scl,
+								(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+								0,
+								slbv_context.chunk.p_desc->nb_chunks,
+								src,
+								dst,
+								raw_binary_size);
+#endif /* _WITH_SLBV_MULTI_HART_ */
+		if( ( NO_ERROR != err ) && ( FALSE == token_xip ) )
+		{
+			/** Do not leave partially verified code in destination area */
+			memset((void*)dst, 0x00, raw_binary_size);
+		}
+	}
+	/** End Of Function */
+	return err;
+}
+
+#ifdef _WITH_SLBV_MULTI_HART_
+/******************************************************************************/
+/** Parking loop for secondary harts, wake-up is done through CLINT MSIP */
+__attribute__((noreturn)) void slbv_hart_park(uint32_t hartid)
+{
+	volatile t_slbv_hart_work					*p_work;
+	uint32_t									expected;
+
+	/** Hart not handled by work distribution layer */
+	if( C_SLBV_HART_NB_MAX <= hartid )
+	{
+		while( 1 )
+		{
+			__asm__ volatile("wfi");
+		}
+	}
+	/** Assign pointer */
+	p_work = &slbv_hart_work[hartid];
+	/** MSIP is only a wake-up event : mstatus.MIE stays cleared, so no trap is taken */
+	__asm__ volatile("csrs mie, %0" :: "r"(C_SLBV_MIE_MSIE_MASK));
+	while( 1 )
+	{
+		__asm__ volatile("wfi");
+		/** Acknowledge software interrupt */
+		C_SLBV_CLINT_MSIP(hartid) = 0;
+		/** Take work descriptor, if main hart did not get it back */
+		expected = N_SLBV_HART_WORK_POSTED;
+		if( __atomic_compare_exchange_n(&p_work->state,
+										&expected,
+										N_SLBV_HART_WORK_BUSY,
+										FALSE,
+										__ATOMIC_SEQ_CST,
+										__ATOMIC_SEQ_CST) )
+		{
+#ifdef _WITH_SLBV_MANIFEST_
+			if( N_SLBV_HART_JOB_JUMP == p_work->type )
+			{
+				/** Segment installed and checked by main hart, start it */
+				__atomic_store_n(&p_work->state, N_SLBV_HART_WORK_DONE, __ATOMIC_SEQ_CST);
+				__asm__ volatile("csrc mie, %0" :: "r"(C_SLBV_MIE_MSIE_MASK));
+				((void (*)(void))p_work->entry)();
+			}
+#endif /* _WITH_SLBV_MANIFEST_ */
+			/** Hash assigned chunks with software SHA, HCA belongs to main hart */
+			p_work->result = slbv_chunk_range(p_work->p_ctx,
+												(metal_scl_t*)&slbv_hart_scl,
+												(scl_sha_ctx_t*)&slbv_hart_sha_ctx[hartid],
+												p_work->first,
+												p_work->count,
+												p_work->src,
+												p_work->dst,
+												p_work->raw_binary_size);
+			/** Publish result */
+			__atomic_store_n(&p_work->state, N_SLBV_HART_WORK_DONE, __ATOMIC_SEQ_CST);
+		}
+	}
+}
+
+/******************************************************************************/
+/** Split chunks between main hart and parked harts, then combine results */
+int_pltfrm slbv_hart_dispatch(t_context *p_ctx, uint_pltfrm src, uint_pltfrm dst, uint32_t raw_binary_size)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	int_pltfrm 									err_hart;
+	uint32_t									self;
+	uint32_t									nb_harts;
+	uint32_t									nb_chunks;
+	uint32_t									share;
+	uint32_t									first = 0;
+	uint32_t									expected;
+	uint32_t									timeout;
+	uint32_t									i;
+	uint_pltfrm									start;
+	uint_pltfrm									now;
+	uint64_t									budget;
+	volatile t_slbv_hart_work					*p_work;
+
+	/** Check input pointer */
+	if( !p_ctx || !src || !dst )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+		self = (uint32_t)metal_cpu_get_current_hartid();
+		nb_harts = M_WHOIS_MIN((uint32_t)metal_cpu_get_num_harts(), C_SLBV_HART_NB_MAX);
+		nb_chunks = slbv_context.chunk.p_desc->nb_chunks;
+		/** Main hart takes one share too, remainder goes to main hart */
+		share = ( self < nb_harts ) ? ( nb_chunks / nb_harts ) : 0;
+		/** Workers use same SCL configuration but software SHA */
+		memcpy((void*)&slbv_hart_scl, (const void*)p_ctx->p_metal_sifive_scl, sizeof(metal_scl_t));
+		slbv_hart_scl.hash_func.sha_init = soft_sha_init;
+		slbv_hart_scl.hash_func.sha_core = soft_sha_core;
+		slbv_hart_scl.hash_func.sha_finish = soft_sha_finish;
+		/** Post work descriptors */
+		for( i = 0;( i < nb_harts ) && share;i++ )
+		{
+			/** Share of a lost hart is left to main hart */
+			if( ( self == i ) || ( TRUE == slbv_hart_lost[i] ) )
+			{
+				continue;
+			}
+			p_work = &slbv_hart_work[i];
+			p_work->type = N_SLBV_HART_JOB_CHUNKS;
+			p_work->p_ctx = p_ctx;
+			p_work->first = first;
+			p_work->count = share;
+			p_work->src = src;
+			p_work->dst = dst;
+			p_work->raw_binary_size = raw_binary_size;
+			p_work->result = GENERIC_ERR_UNKNOWN;
+			__atomic_store_n(&p_work->state, N_SLBV_HART_WORK_POSTED, __ATOMIC_SEQ_CST);
+			/** Wake hart up */
+			C_SLBV_CLINT_MSIP(i) = 1;
+			first += share;
+		}
+		/** Main hart processes the rest with its own engine */
+		err = slbv_chunk_range(p_ctx,
+								(metal_scl_t*)p_ctx->p_metal_sifive_scl,
+								(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+								first,
+								nb_chunks - first,
+								src,
+								dst,
+								raw_binary_size);
+		/** Gather results */
+		for( i = 0;( i < nb_harts ) && share;i++ )
+		{
+			if( ( self == i ) || ( TRUE == slbv_hart_lost[i] ) )
+			{
+				continue;
+			}
+			p_work = &slbv_hart_work[i];
+			timeout = C_SLBV_HART_PICKUP_TIMEOUT;
+			while( N_SLBV_HART_WORK_POSTED == __atomic_load_n(&p_work->state, __ATOMIC_SEQ_CST) && timeout )
+			{
+				timeout--;
+			}
+			expected = N_SLBV_HART_WORK_POSTED;
+			if( __atomic_compare_exchange_n(&p_work->state,
+											&expected,
+											N_SLBV_HART_WORK_IDLE,
+											FALSE,
+											__ATOMIC_SEQ_CST,
+											__ATOMIC_SEQ_CST) )
+			{
+				/** Hart never took its share (absent or not parked), do it here */
+				err_hart = slbv_chunk_range(p_ctx,
+											(metal_scl_t*)p_ctx->p_metal_sifive_scl,
+											(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+											p_work->first,
+											p_work->count,
+											src,
+											dst,
+											raw_binary_size);
+			}
+			else
+			{
+				/** Hart is working, wait for its result within a budget matching its share */
+				budget = (uint64_t)p_work->count * slbv_context.chunk.size * C_SLBV_HART_WORK_CYCLES_PER_BYTE;
+				budget = M_WHOIS_MIN(budget, (uint64_t)( (uint_pltfrm)~0 >> 1 ));
+				M_CSR_READ(mcycle, start);
+				now = start;
+				while( ( N_SLBV_HART_WORK_DONE != __atomic_load_n(&p_work->state, __ATOMIC_SEQ_CST) ) &&
+						( budget > (uint64_t)( now - start ) ) )
+				{
+					M_CSR_READ(mcycle, now);
+				}
+				if( N_SLBV_HART_WORK_DONE == __atomic_load_n(&p_work->state, __ATOMIC_SEQ_CST) )
+				{
+					err_hart = p_work->result;
+					__atomic_store_n(&p_work->state, N_SLBV_HART_WORK_IDLE, __ATOMIC_SEQ_CST);
+				}
+				else
+				{
+					/** Hart trapped or stalled : its chunks are not trusted, boot attempt fails */
+					slbv_hart_lost[i] = TRUE;
+					err_hart = N_SLBV_ERR_HART_TIMEOUT;
+				}
+			}
+			/** Keep first error */
+			if( NO_ERROR == err )
+			{
+				err = err_hart;
+			}
+		}
+	}
+	/** End Of Function */
+	return err;
+}
+#endif /* _WITH_SLBV_MULTI_HART_ */
+#endif /* _WITH_SLBV_CHUNKED_IMAGE_ */
+
+#if defined(_WITH_SLBV_INCREMENTAL_) || defined(_WITH_SLBV_WARM_RESET_)
+/******************************************************************************/
+/** Boot-session MAC key : hash of OTP seed and session number or nonce */
+int_pltfrm slbv_mac_derive_key(t_context *p_ctx, uint64_t session, uint8_t *p_key)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint8_t										seed[C_OTP_BOOT_MAC_SEED_SIZE + sizeof(uint64_t)] __attribute__((aligned(0x8)));
+	uint8_t										digest[SHA384_BYTE_HASHSIZE] __attribute__((aligned(0x10)));
+
+	/** Check input pointer */
+	if( !p_ctx || !p_key )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_mac_derive_key_out;
+	}
+	err = sbrm_read_otp(p_ctx, C_OTP_BOOT_MAC_SEED_OFST, seed, C_OTP_BOOT_MAC_SEED_SIZE);
+	if( NO_ERROR != err )
+	{
+		goto slbv_mac_derive_key_out;
+	}
+	memcpy((void*)&seed[C_OTP_BOOT_MAC_SEED_SIZE], (const void*)&session, sizeof(uint64_t));
+	err = slbv_hash(p_ctx,
+						(metal_scl_t*)p_ctx->p_metal_sifive_scl,
+						(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+						(const uint8_t*)seed,
+						sizeof(seed),
+						digest);
+	if( NO_ERROR == err )
+	{
+		memcpy((void*)p_key, (const void*)digest, C_SLBV_MAC_KEY_SIZE);
+	}
+slbv_mac_derive_key_out:
+	/** Do not leave secrets on stack */
+	memset((void*)seed, 0x00, sizeof(seed));
+	memset((void*)digest, 0x00, sizeof(digest));
+	/** End Of Function */
+	return err;
+}
+#endif /* _WITH_SLBV_INCREMENTAL_ || _WITH_SLBV_WARM_RESET_ */
+
+#ifdef _WITH_SLBV_INCREMENTAL_
+/******************************************************************************/
+/** Install chunks, re-hashing only those whose tag from previous boot does not match */
+int_pltfrm slbv_inc_process(t_context *p_ctx, uint_pltfrm src, uint_pltfrm dst, uint32_t raw_binary_size)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	volatile t_slbv_inc_record					*p_rec = (volatile t_slbv_inc_record*)__sbr_retention_start_addr;
+	uint32_t									nb_chunks;
+	uint32_t									session;
+	uint32_t									offset;
+	uint32_t									size;
+	uint32_t									i;
+	uint64_t									tag;
+	uint_pltfrm									ret_end = (uint_pltfrm)__sbr_retention_end_addr;
+
+	/** Check input pointer */
+	if( !p_ctx || !src || !dst || !slbv_context.chunk.p_desc )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_inc_process_out;
+	}
+	nb_chunks = slbv_context.chunk.p_desc->nb_chunks;
+	slbv_context.inc.reused = FALSE;
+	slbv_context.inc.nb_rehashed = 0;
+#ifdef _WITH_SLBV_WARM_RESET_
+	/** Verified boot state record sits at end of retention area */
+	ret_end -= sizeof(t_slbv_warm_record);
+#endif /* _WITH_SLBV_WARM_RESET_ */
+	if( ( ( (uint_pltfrm)p_rec + sizeof(t_slbv_inc_record) ) > ret_end ) ||
+		( ( dst < ( (uint_pltfrm)p_rec + sizeof(t_slbv_inc_record) ) ) && ( ( dst + raw_binary_size ) > (uint_pltfrm)p_rec ) ) )
+	{
+		/** No room for record, every chunk is checked */
+		err = slbv_chunk_process(p_ctx, src, dst, raw_binary_size, FALSE);
+		goto slbv_inc_process_out;
+	}
+	/** Record is only trusted if it describes this very image, with a genuine MAC */
+	session = p_rec->session;
+	if( ( C_SLBV_INC_RECORD_MAGIC == p_rec->magic ) &&
+		( (uint64_t)dst == p_rec->dst ) &&
+		( raw_binary_size == p_rec->raw_size ) &&
+		( nb_chunks == p_rec->nb_chunks ) &&
+		!memcmp((const void*)p_rec->leaves_digest, (const void*)p_ctx->digest, C_SLBV_CHUNK_HASH_SIZE) )
+	{
+		err = slbv_mac_derive_key(p_ctx, session, slbv_context.inc.key);
+		if( NO_ERROR != err )
+		{
+			goto slbv_inc_process_out;
+		}
+		tag = slbv_siphash(slbv_context.inc.key,
+							C_SLBV_INC_RECORD_PREFIX,
+							(const uint8_t*)p_rec,
+							offsetof(t_slbv_inc_record, mac));
+		slbv_context.inc.reused = ( tag == p_rec->mac ) ? TRUE : FALSE;
+	}
+	if( FALSE == slbv_context.inc.reused )
+	{
+		/** New session : tags from any former record become useless */
+		p_rec->magic = 0;
+		session++;
+		err = slbv_mac_derive_key(p_ctx, session, slbv_context.inc.key);
+		if( NO_ERROR != err )
+		{
+			goto slbv_inc_process_out;
+		}
+	}
+	for( i = 0, offset = 0;i < nb_chunks;i++, offset += size )
+	{
+		/** Last chunk may be partial */
+		size = ( ( raw_binary_size - offset ) > slbv_context.chunk.size ) ? slbv_context.chunk.size : ( raw_binary_size - offset );
+		tag = slbv_siphash(slbv_context.inc.key,
+							( (uint64_t)session << 32 ) | i,
+							(const uint8_t*)( dst + offset ),
+							size);
+		if( ( TRUE == slbv_context.inc.reused ) && ( tag == p_rec->tag[i] ) )
+		{
+			/** Chunk untouched since it has been verified */
+			continue;
+		}
+		/** Copy chunk again from boot device, then hash it */
+		err = slbv_chunk_check(p_ctx,
+								(metal_scl_t*)p_ctx->p_metal_sifive_scl,
+								(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+								i,
+								src + offset,
+								dst + offset,
+								size);
+		if( NO_ERROR != err )
+		{
+			/** Do not leave partially verified code in destination area */
+			memset((void*)dst, 0x00, raw_binary_size);
+			p_rec->magic = 0;
+			goto slbv_inc_process_out;
+		}
+		slbv_context.inc.nb_rehashed++;
+		p_rec->tag[i] = slbv_siphash(slbv_context.inc.key,
+									( (uint64_t)session << 32 ) | i,
+									(const uint8_t*)( dst + offset ),
+									size);
+	}
+	/** Seal record for next boot */
+	p_rec->magic = C_SLBV_INC_RECORD_MAGIC;
+	p_rec->session = session;
+	p_rec->dst = (uint64_t)dst;
+	p_rec->raw_size = raw_binary_size;
+	p_rec->nb_chunks = nb_chunks;
+	memcpy((void*)p_rec->leaves_digest, (const void*)p_ctx->digest, C_SLBV_CHUNK_HASH_SIZE);
+	p_rec->mac = slbv_siphash(slbv_context.inc.key,
+								C_SLBV_INC_RECORD_PREFIX,
+								(const uint8_t*)p_rec,
+								offsetof(t_slbv_inc_record, mac));
+	err = NO_ERROR;
+slbv_inc_process_out:
+	/** Key must not outlive ROM */
+	memset((void*)slbv_context.inc.key, 0x00, C_SLBV_MAC_KEY_SIZE);
+	/** End Of Function */
+	return err;
+}
+#endif /* _WITH_SLBV_INCREMENTAL_ */
+
+#ifdef _WITH_SLBV_WARM_RESET_
+/******************************************************************************/
+/** Hash of CSK slot OTP area */
+int_pltfrm slbv_warm_csk_digest(t_context *p_ctx, uint32_t slot, uint8_t *p_digest)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	t_key_data									csk_area;
+
+	/** Check input pointer */
+	if( !p_ctx || !p_digest )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_warm_csk_digest_out;
+	}
+	if( C_OTP_CSK_SLOT_MAX < slot )
+	{
+		err = N_SLBV_ERR_NO_CSK_AVAILABLE;
+		goto slbv_warm_csk_digest_out;
+	}
+	err = sbrm_read_otp(p_ctx, C_OTP_CSK_AREA_OFST + ( slot * C_OTP_CSK_AERA_SIZE ), (uint8_t*)&csk_area, C_OTP_CSK_AERA_SIZE);
+	if( NO_ERROR != err )
+	{
+		goto slbv_warm_csk_digest_out;
+	}
+	err = slbv_hash(p_ctx,
+						(metal_scl_t*)p_ctx->p_metal_sifive_scl,
+						(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+						(const uint8_t*)&csk_area,
+						C_OTP_CSK_AERA_SIZE,
+						p_digest);
+slbv_warm_csk_digest_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Fresh random number for each cold boot - retention RAM keeps no counter */
+int_pltfrm slbv_warm_nonce(t_context *p_ctx, uint64_t *p_nonce)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	metal_scl_t									*p_scl;
+	uint32_t									word[2] = { 0, 0 };
+
+	/** Check input pointer */
+	if( !p_ctx || !p_ctx->p_metal_sifive_scl || !p_nonce )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_warm_nonce_out;
+	}
+	p_scl = (metal_scl_t*)p_ctx->p_metal_sifive_scl;
+	if( !p_scl->trng_func.get_data )
+	{
+		/** No entropy source : no warm record */
+		err = N_SLBV_ERR_WARM_RECORD_INVALID;
+		goto slbv_warm_nonce_out;
+	}
+	err = p_scl->trng_func.get_data(p_scl, &word[0]);
+	if( NO_ERROR == err )
+	{
+		err = p_scl->trng_func.get_data(p_scl, &word[1]);
+	}
+	if( NO_ERROR != err )
+	{
+		goto slbv_warm_nonce_out;
+	}
+	*p_nonce = ( (uint64_t)word[1] << 32 ) | word[0];
+slbv_warm_nonce_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Record verified boot state, right before jump of a cold boot */
+void slbv_warm_seal(t_context *p_ctx)
+{
+	volatile t_slbv_warm_record					*p_rec = (volatile t_slbv_warm_record*)( (uint_pltfrm)__sbr_retention_end_addr - sizeof(t_slbv_warm_record) );
+	t_km_context								*p_km_context;
+	uint8_t										key[C_SLBV_MAC_KEY_SIZE] __attribute__((aligned(0x8)));
+	uint64_t									nonce = 0;
+
+	/** Check input pointer */
+	if( !p_ctx || !p_ctx->p_km_context )
+	{
+		goto slbv_warm_seal_out;
+	}
+	p_km_context = (t_km_context*)p_ctx->p_km_context;
+	/** Multi-segment images are not recorded, neither are XiP images verified on demand */
+	if( ( 0 == slbv_context.warm.image_size ) ||
+		( ( slbv_context.warm.image_addr < ( (uint_pltfrm)p_rec + sizeof(t_slbv_warm_record) ) ) &&
+		( ( slbv_context.warm.image_addr + slbv_context.warm.image_size ) > (uint_pltfrm)p_rec ) ) )
+	{
+		goto slbv_warm_seal_out;
+	}
+#ifdef _WITH_SLBV_LAZY_XIP_
+	if( TRUE == slbv_context.lazy.pending )
+	{
+		goto slbv_warm_seal_out;
+	}
+#endif /* _WITH_SLBV_LAZY_XIP_ */
+	p_rec->csk_slot = p_km_context->sign_key[N_KM_INDEX_CSK].slot;
+	if( ( NO_ERROR != sbrm_read_otp(p_ctx, C_OTP_LCP_OFST, (uint8_t*)&p_rec->lcp, C_OTP_LCP_SIZE) ) ||
+		( NO_ERROR != slbv_warm_csk_digest(p_ctx, p_rec->csk_slot, (uint8_t*)p_rec->csk_digest) ) ||
+		( NO_ERROR != slbv_hash(p_ctx,
+								(metal_scl_t*)p_ctx->p_metal_sifive_scl,
+								(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+								(const uint8_t*)slbv_context.warm.image_addr,
+								slbv_context.warm.image_size,
+								(uint8_t*)p_rec->image_digest) ) ||
+		( NO_ERROR != slbv_warm_nonce(p_ctx, &nonce) ) ||
+		( NO_ERROR != slbv_mac_derive_key(p_ctx, nonce, key) ) )
+	{
+		goto slbv_warm_seal_out;
+	}
+	p_rec->nonce = nonce;
+	p_rec->nb_warm = 0;
+	p_rec->image_addr = (uint64_t)slbv_context.warm.image_addr;
+	p_rec->image_size = slbv_context.warm.image_size;
+	p_rec->firmware_version = slbv_context.warm.firmware_version;
+	p_rec->jump_addr = (uint64_t)(uint_pltfrm)slbv_context.jump_fct_ptr;
+	p_rec->magic = C_SLBV_WARM_RECORD_MAGIC;
+	p_rec->mac = slbv_siphash(key, C_SLBV_WARM_RECORD_PREFIX, (const uint8_t*)p_rec, offsetof(t_slbv_warm_record, mac));
+slbv_warm_seal_out:
+	/** Key must not outlive ROM */
+	memset((void*)key, 0x00, sizeof(key));
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+/** Warm reset : with genuine verified boot state, only binary integrity is confirmed */
+int_pltfrm slbv_warm_boot(t_context *p_ctx)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	volatile t_slbv_warm_record					*p_rec = (volatile t_slbv_warm_record*)( (uint_pltfrm)__sbr_retention_end_addr - sizeof(t_slbv_warm_record) );
+	uint8_t										key[C_SLBV_MAC_KEY_SIZE] __attribute__((aligned(0x8)));
+	uint8_t										digest[SHA384_BYTE_HASHSIZE] __attribute__((aligned(0x10)));
+	uint32_t									lcp = 0;
+	uint32_t									version = 0;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_warm_boot_out;
+	}
+	if( C_SLBV_WARM_RECORD_MAGIC != p_rec->magic )
+	{
+		/** Cold boot, or record dropped */
+		err = N_SLBV_ERR_WARM_RECORD_INVALID;
+		goto slbv_warm_boot_out;
+	}
+	if( C_SLBV_WARM_BOOT_MAX <= p_rec->nb_warm )
+	{
+		/** Time for a full boot */
+		err = N_SLBV_ERR_WARM_RECORD_INVALID;
+		goto slbv_warm_boot_out;
+	}
+	/** Record authenticity */
+	err = slbv_mac_derive_key(p_ctx, p_rec->nonce, key);
+	if( NO_ERROR != err )
+	{
+		goto slbv_warm_boot_out;
+	}
+	if( slbv_siphash(key, C_SLBV_WARM_RECORD_PREFIX, (const uint8_t*)p_rec, offsetof(t_slbv_warm_record, mac)) != p_rec->mac )
+	{
+		err = N_SLBV_ERR_WARM_RECORD_INVALID;
+		goto slbv_warm_boot_out;
+	}
+	/** Life cycle must not have moved */
+	err = sbrm_read_otp(p_ctx, C_OTP_LCP_OFST, (uint8_t*)&lcp, C_OTP_LCP_SIZE);
+	if( ( NO_ERROR != err ) || ( lcp != p_rec->lcp ) )
+	{
+		err = N_SLBV_ERR_WARM_STATE_MISMATCH;
+		goto slbv_warm_boot_out;
+	}
+	/** Anti-rollback counter may have moved forward since cold boot */
+	err = slbv_get_application_version(p_ctx, &version);
+	if( N_SLBV_ERR_NO_APP_REF_VERSION == err )
+	{
+		/** Same very default version as cold path */
+		version = (uint32_t)1UL;
+		err = NO_ERROR;
+	}
+	if( ( NO_ERROR != err ) || ( version > p_rec->firmware_version ) )
+	{
+		err = N_SLBV_ERR_WARM_STATE_MISMATCH;
+		goto slbv_warm_boot_out;
+	}
+	/** Same CSK, and no newer one programmed since */
+	err = slbv_warm_csk_digest(p_ctx, p_rec->csk_slot, digest);
+	if( ( NO_ERROR != err ) ||
+		memcmp((const void*)digest, (const void*)p_rec->csk_digest, sizeof(digest)) ||
+		( ( C_OTP_CSK_SLOT_MAX > p_rec->csk_slot ) &&
+		( NO_ERROR != km_check_key_slot(p_ctx, (uint8_t)( p_rec->csk_slot + 1 ), N_KM_KEYID_CSK) ) ) )
+	{
+		err = N_SLBV_ERR_WARM_STATE_MISMATCH;
+		goto slbv_warm_boot_out;
+	}
+	/** Binary integrity */
+	err = slbv_hash(p_ctx,
+						(metal_scl_t*)p_ctx->p_metal_sifive_scl,
+						(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+						(const uint8_t*)(uint_pltfrm)p_rec->image_addr,
+						p_rec->image_size,
+						digest);
+	if( ( NO_ERROR != err ) || memcmp((const void*)digest, (const void*)p_rec->image_digest, sizeof(digest)) )
+	{
+		err = N_SLBV_ERR_WARM_STATE_MISMATCH;
+		goto slbv_warm_boot_out;
+	}
+	/** Count this warm boot */
+	p_rec->nb_warm++;
+	p_rec->mac = slbv_siphash(key, C_SLBV_WARM_RECORD_PREFIX, (const uint8_t*)p_rec, offsetof(t_slbv_warm_record, mac));
+	memset((void*)key, 0x00, sizeof(key));
+#ifdef _WITH_SBRM_PROFILING_
+	sbrm_prof_mark(N_SBRM_PROF_WARM_JUMP);
+#endif /* _WITH_SBRM_PROFILING_ */
+	/** Jump into SLB/SFL */
+	slbv_context.jump_fct_ptr = (void*)(uint_pltfrm)p_rec->jump_addr;
+	slbv_context.jump_fct_ptr();
+	/** Should not come back */
+	err = GENERIC_ERR_CRITICAL;
+slbv_warm_boot_out:
+	if( ( NO_ERROR != err ) && ( C_SLBV_WARM_RECORD_MAGIC == p_rec->magic ) )
+	{
+		/** Record is not to be tried again : cold path seals a new one */
+		p_rec->magic = 0;
+	}
+	/** Key must not outlive ROM */
+	memset((void*)key, 0x00, sizeof(key));
+	/** End Of Function */
+	return err;
+}
+#endif /* _WITH_SLBV_WARM_RESET_ */
+
+#ifdef _WITH_SLBV_LAZY_XIP_
+/******************************************************************************/
+/** Program one PMP entry - entry is switched off while its address changes */
+void slbv_pmp_set(uint32_t entry, uint_pltfrm addr, uint8_t cfg)
+{
+#if __riscv_xlen == 64
+	uint_pltfrm									shift = ( entry & 0x7 ) << 3;
+
+	/** pmpcfg0 holds entries 0 to 7 */
+	__asm__ volatile("csrc pmpcfg0, %0" :: "r"( (uint_pltfrm)0xff << shift ));
+#elif __riscv_xlen == 32
+	uint_pltfrm									shift = ( entry & 0x3 ) << 3;
+
+	/** pmpcfg0 holds entries 0 to 3, pmpcfg1 entries 4 to 7 */
+	if( 4 > entry )
+	{
+		__asm__ volatile("csrc pmpcfg0, %0" :: "r"( (uint_pltfrm)0xff << shift ));
+	}
+	else
+	{
+		__asm__ volatile("csrc pmpcfg1, %0" :: "r"( (uint_pltfrm)0xff << shift ));
+	}
+#else
+#error [__riscv_xlen] A value for bus width must be defined
+#endif /* __riscv_xlen */
+	/** CSR number must be an immediate */
+	switch( entry )
+	{
+		case 0:
+			__asm__ volatile("csrw pmpaddr0, %0" :: "r"(addr));
+			break;
+		case 1:
+			__asm__ volatile("csrw pmpaddr1, %0" :: "r"(addr));
+			break;
+		case 2:
+			__asm__ volatile("csrw pmpaddr2, %0" :: "r"(addr));
+			break;
+		case 3:
+			__asm__ volatile("csrw pmpaddr3, %0" :: "r"(addr));
+			break;
+		case 4:
+			__asm__ volatile("csrw pmpaddr4, %0" :: "r"(addr));
+			break;
+		case 5:
+			__asm__ volatile("csrw pmpaddr5, %0" :: "r"(addr));
+			break;
+		case 6:
+			__asm__ volatile("csrw pmpaddr6, %0" :: "r"(addr));
+			break;
+		case 7:
+			__asm__ volatile("csrw pmpaddr7, %0" :: "r"(addr));
+			break;
+		default:
+			/** Entry not owned by ROM */
+			return;
+	}
+	if( C_SLBV_PMP_CFG_A_OFF != cfg )
+	{
+#if __riscv_xlen == 64
+		__asm__ volatile("csrs pmpcfg0, %0" :: "r"( (uint_pltfrm)cfg << shift ));
+#else
+		if( 4 > entry )
+		{
+			__asm__ volatile("csrs pmpcfg0, %0" :: "r"( (uint_pltfrm)cfg << shift ));
+		}
+		else
+		{
+			__asm__ volatile("csrs pmpcfg1, %0" :: "r"( (uint_pltfrm)cfg << shift ));
+		}
+#endif /* __riscv_xlen */
+	}
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+/** Probe trap : CSR access raised illegal instruction, skip it and report CSR as missing */
+__attribute__((naked, aligned(4))) void slbv_lazy_probe_trap(void)
+{
+	__asm__ volatile(
+		"csrr t0, mepc\n"
+		"addi t0, t0, 4\n"
+		"csrw mepc, t0\n"
+		"li a0, 0\n"
+		"mret\n");
+}
+
+/******************************************************************************/
+/** Smepmp check : mseccfg must be implemented and Rule Locking Bypass settable */
+uint8_t slbv_lazy_rlb_available(void)
+{
+	register uint_pltfrm						present __asm__("a0") = TRUE;
+	uint_pltfrm									prev_mtvec;
+	uint_pltfrm									mseccfg = 0;
+
+	/** Reading mseccfg traps when Smepmp is not implemented */
+	__asm__ volatile("csrr %0, mtvec" : "=r"(prev_mtvec));
+	__asm__ volatile("csrw mtvec, %0" :: "r"((uint_pltfrm)&slbv_lazy_probe_trap));
+	__asm__ volatile("csrr t0, %1" : "+r"(present) : "i"(C_SLBV_CSR_MSECCFG) : "t0", "memory");
+	__asm__ volatile("csrw mtvec, %0" :: "r"(prev_mtvec));
+	if( TRUE == present )
+	{
+		/** RLB stays cleared when a rule has already been locked without it */
+		__asm__ volatile("csrs %0, %1" :: "i"(C_SLBV_CSR_MSECCFG), "r"(C_SLBV_MSECCFG_RLB_MASK));
+		__asm__ volatile("csrr %0, %1" : "=r"(mseccfg) : "i"(C_SLBV_CSR_MSECCFG));
+		__asm__ volatile("csrc %0, %1" :: "i"(C_SLBV_CSR_MSECCFG), "r"(C_SLBV_MSECCFG_RLB_MASK));
+	}
+	/** End Of Function */
+	return ( ( TRUE == present ) && ( mseccfg & C_SLBV_MSECCFG_RLB_MASK ) ) ? TRUE : FALSE;
+}
+
+/******************************************************************************/
+/** Check whether XiP chunked image can be verified on demand, and if so get it ready */
+int_pltfrm slbv_lazy_prepare(t_context *p_ctx, uint_pltfrm base, uint32_t raw_binary_size)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint8_t										digest[C_SLBV_CHUNK_HASH_SIZE] __attribute__((aligned(0x10)));
+	uint32_t									nb_chunks;
+
+	/** Check input pointer */
+	if( !p_ctx || !base || !slbv_context.chunk.p_desc || !slbv_context.chunk.p_leaves )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_lazy_prepare_out;
+	}
+	nb_chunks = slbv_context.chunk.p_desc->nb_chunks;
+	/** PMP windows are naturally aligned : binary must start on a chunk boundary */
+	/** Locked deny rule can only be lifted by ROM with Smepmp Rule Locking Bypass */
+	if( ( C_SLBV_LAZY_CHUNK_NB_MAX < nb_chunks ) ||
+		( base & ( slbv_context.chunk.size - 1 ) ) ||
+		( TRUE != slbv_lazy_rlb_available() ) )
+	{
+		/** Not eligible, chunks are checked upfront */
+		err = NO_ERROR;
+		goto slbv_lazy_prepare_out;
+	}
+	/** Take a copy of leaves table, then check it against digest already matched with signed root */
+	memcpy((void*)slbv_context.lazy.leaves, (const void*)slbv_context.chunk.p_leaves, nb_chunks * C_SLBV_CHUNK_HASH_SIZE);
+	err = slbv_hash(p_ctx,
+						(metal_scl_t*)p_ctx->p_metal_sifive_scl,
+						(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+						(const uint8_t*)slbv_context.lazy.leaves,
+						nb_chunks * C_SLBV_CHUNK_HASH_SIZE,
+						digest);
+	if( NO_ERROR != err )
+	{
+		goto slbv_lazy_prepare_out;
+	}
+	if( memcmp((const void*)digest, (const void*)p_ctx->digest, C_SLBV_CHUNK_HASH_SIZE) )
+	{
+		/** Leaves table changed since it has been checked */
+		err = N_SLBV_ERR_CHUNK_ROOT_MISMATCH;
+		goto slbv_lazy_prepare_out;
+	}
+	/** From now on, only RAM copy is used */
+	slbv_context.chunk.p_leaves = (volatile uint8_t*)slbv_context.lazy.leaves;
+	slbv_context.lazy.base = base;
+	slbv_context.lazy.size = raw_binary_size;
+	slbv_context.lazy.nb_chunks = nb_chunks;
+	slbv_context.lazy.nb_verified = 0;
+	slbv_context.lazy.nb_windows = 0;
+	memset((void*)slbv_context.lazy.verified, 0x00, sizeof(slbv_context.lazy.verified));
+	slbv_context.lazy.pending = TRUE;
+slbv_lazy_prepare_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Deny any access to XiP binary, and catch resulting faults */
+void slbv_lazy_arm(t_context *p_ctx)
+{
+	uint32_t									i;
+	uint_pltfrm									end;
+
+	/** Trap handler works on ROM context */
+	slbv_context.lazy.p_ctx = p_ctx;
+	/** Rule Locking Bypass must be set before any rule gets locked - Smepmp checked by slbv_lazy_prepare */
+	__asm__ volatile("csrs %0, %1" :: "i"(C_SLBV_CSR_MSECCFG), "r"(C_SLBV_MSECCFG_RLB_MASK));
+	/** No window opened yet */
+	for( i = 0;i < C_SLBV_LAZY_PMP_WINDOW_NB;i++ )
+	{
+		slbv_pmp_set(i, 0, C_SLBV_PMP_CFG_A_OFF);
+	}
+	/** Locked TOR rule without any permission : applies to M-mode too */
+	end = ( slbv_context.lazy.base + slbv_context.lazy.size + 3 ) & ~(uint_pltfrm)0x3;
+	slbv_pmp_set(C_SLBV_LAZY_PMP_BOTTOM, slbv_context.lazy.base >> 2, C_SLBV_PMP_CFG_A_OFF);
+	slbv_pmp_set(C_SLBV_LAZY_PMP_DENY, end >> 2, C_SLBV_PMP_CFG_A_TOR | C_SLBV_PMP_CFG_L);
+	/** Install ROM trap vector, direct mode */
+	__asm__ volatile("csrr %0, mtvec" : "=r"(slbv_context.lazy.prev_mtvec));
+	__asm__ volatile("csrw mtvec, %0" :: "r"((uint_pltfrm)&slbv_lazy_trap_entry));
+	slbv_context.lazy.armed = TRUE;
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+/** Whole binary is verified : give PMP entries and trap vector back */
+void slbv_lazy_disarm(void)
+{
+	/** Drop deny rule, windows are useless without it */
+	slbv_pmp_set(C_SLBV_LAZY_PMP_DENY, 0, C_SLBV_PMP_CFG_A_OFF);
+	/** Locked rules are not bypassable anymore */
+	__asm__ volatile("csrc %0, %1" :: "i"(C_SLBV_CSR_MSECCFG), "r"(C_SLBV_MSECCFG_RLB_MASK));
+	__asm__ volatile("csrw mtvec, %0" :: "r"(slbv_context.lazy.prev_mtvec));
+	slbv_context.lazy.armed = FALSE;
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+/** Open window on freshly verified chunk, merged with its verified buddies */
+void slbv_lazy_open_window(uint32_t index)
+{
+	uint32_t									first = index;
+	uint32_t									size_log2 = slbv_context.chunk.p_desc->chunk_size_log2;
+	uint32_t									count;
+	uint32_t									buddy;
+	uint32_t									i;
+	uint32_t									j;
+
+	/** Grow naturally aligned group while buddy group is fully verified */
+	while( 1 )
+	{
+		count = 0x1UL << ( size_log2 - slbv_context.chunk.p_desc->chunk_size_log2 );
+		buddy = first ^ count;
+		if( ( ( buddy + count ) > slbv_context.lazy.nb_chunks ) ||
+			( ( slbv_context.lazy.base + ( (uint_pltfrm)( first & buddy ) << slbv_context.chunk.p_desc->chunk_size_log2 ) ) & ( ( (uint_pltfrm)0x1 << ( size_log2 + 1 ) ) - 1 ) ) )
+		{
+			break;
+		}
+		for( i = buddy;i < ( buddy + count );i++ )
+		{
+			if( !( slbv_context.lazy.verified[i >> 5] & ( 0x1UL << ( i & 0x1f ) ) ) )
+			{
+				break;
+			}
+		}
+		if( i != ( buddy + count ) )
+		{
+			break;
+		}
+		first &= buddy;
+		size_log2++;
+	}
+	/** Windows now covered by this group are freed */
+	for( i = 0, j = 0;i < slbv_context.lazy.nb_windows;i++ )
+	{
+		if( ( slbv_context.lazy.window[i].first < first ) ||
+			( slbv_context.lazy.window[i].first >= ( first + ( 0x1UL << ( size_log2 - slbv_context.chunk.p_desc->chunk_size_log2 ) ) ) ) )
+		{
+			slbv_context.lazy.window[j++] = slbv_context.lazy.window[i];
+		}
+	}
+	slbv_context.lazy.window[j].first = first;
+	slbv_context.lazy.window[j].size_log2 = size_log2;
+	slbv_context.lazy.nb_windows = j + 1;
+	/** Rewrite window entries, lowest entries have priority over deny rule */
+	for( i = 0;i < C_SLBV_LAZY_PMP_WINDOW_NB;i++ )
+	{
+		if( i < slbv_context.lazy.nb_windows )
+		{
+			/** NAPOT encoding : base >> 2, then trailing ones for size */
+			slbv_pmp_set(i,
+						( ( slbv_context.lazy.base + ( (uint_pltfrm)slbv_context.lazy.window[i].first << slbv_context.chunk.p_desc->chunk_size_log2 ) ) >> 2 ) |
+						( ( (uint_pltfrm)0x1 << ( slbv_context.lazy.window[i].size_log2 - 3 ) ) - 1 ),
+						C_SLBV_PMP_CFG_R | C_SLBV_PMP_CFG_X | C_SLBV_PMP_CFG_A_NAPOT);
+		}
+		else
+		{
+			slbv_pmp_set(i, 0, C_SLBV_PMP_CFG_A_OFF);
+		}
+	}
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+/** Access fault on XiP binary : verify faulting chunk and let code go on */
+uint_pltfrm slbv_lazy_trap_handler(uint_pltfrm mcause, uint_pltfrm mtval)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	t_context									*p_ctx = slbv_context.lazy.p_ctx;
+	uint_pltfrm									end;
+	uint32_t									index;
+	uint32_t									first;
+	uint32_t									count;
+
+	/** Only faults on unverified chunks are expected, anything else is fatal */
+	if( ( TRUE != slbv_context.lazy.armed ) ||
+		( ( C_SLBV_MCAUSE_INSTR_ACCESS_FAULT != mcause ) && ( C_SLBV_MCAUSE_LOAD_ACCESS_FAULT != mcause ) ) ||
+		( slbv_context.lazy.base > mtval ) ||
+		( ( slbv_context.lazy.base + slbv_context.lazy.size ) <= mtval ) )
+	{
+		goto slbv_lazy_trap_handler_out;
+	}
+	index = (uint32_t)( ( mtval - slbv_context.lazy.base ) >> slbv_context.chunk.p_desc->chunk_size_log2 );
+	if( slbv_context.lazy.verified[index >> 5] & ( 0x1UL << ( index & 0x1f ) ) )
+	{
+		/** Window should already be opened */
+		goto slbv_lazy_trap_handler_out;
+	}
+	/** Deny rule off while ROM reads binary - allowed by Rule Locking Bypass */
+	slbv_pmp_set(C_SLBV_LAZY_PMP_DENY, 0, C_SLBV_PMP_CFG_A_OFF);
+	if( C_SLBV_LAZY_PMP_WINDOW_NB > slbv_context.lazy.nb_windows )
+	{
+		/** Faulting chunk only */
+		first = index;
+		count = 1;
+	}
+	else
+	{
+		/** No window left : whatever remains is verified now */
+		first = 0;
+		count = slbv_context.lazy.nb_chunks;
+	}
+	for( index = first, err = NO_ERROR;( index < ( first + count ) ) && ( NO_ERROR == err );index++ )
+	{
+		if( slbv_context.lazy.verified[index >> 5] & ( 0x1UL << ( index & 0x1f ) ) )
+		{
+			continue;
+		}
+		err = slbv_chunk_range(p_ctx,
+								(metal_scl_t*)p_ctx->p_metal_sifive_scl,
+								(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+								index,
+								1,
+								slbv_context.lazy.base,
+								slbv_context.lazy.base,
+								slbv_context.lazy.size);
+		if( NO_ERROR == err )
+		{
+			slbv_context.lazy.verified[index >> 5] |= ( 0x1UL << ( index & 0x1f ) );
+			slbv_context.lazy.nb_verified++;
+		}
+	}
+	if( NO_ERROR != err )
+	{
+		/** Corrupted chunk must never run */
+		goto slbv_lazy_trap_handler_out;
+	}
+	if( slbv_context.lazy.nb_chunks == slbv_context.lazy.nb_verified )
+	{
+		/** Nothing left to fence off */
+		slbv_lazy_disarm();
+	}
+	else
+	{
+		slbv_lazy_open_window(first);
+		/** Deny rule back in place */
+		end = ( slbv_context.lazy.base + slbv_context.lazy.size + 3 ) & ~(uint_pltfrm)0x3;
+		slbv_pmp_set(C_SLBV_LAZY_PMP_DENY, end >> 2, C_SLBV_PMP_CFG_A_TOR | C_SLBV_PMP_CFG_L);
+	}
+	/** End Of Function */
+	return TRUE;
+slbv_lazy_trap_handler_out:
+	/** Something goes wrong, let's reset the platform */
+	sbrm_platform_reset(p_ctx);
+	/** End Of Function */
+	return FALSE;
+}
+
+/******************************************************************************/
+/** Trap entry : caller-saved registers go on interrupted code stack, handler is C */
+__attribute__((naked, aligned(4))) void slbv_lazy_trap_entry(void)
+{
+	__asm__ volatile(
+		"addi sp, sp, -" M_SLBV_LAZY_FRAME_SIZE "\n"
+		M_SLBV_LAZY_SAVE(ra, 0) M_SLBV_LAZY_SAVE(t0, 1) M_SLBV_LAZY_SAVE(t1, 2) M_SLBV_LAZY_SAVE(t2, 3)
+		M_SLBV_LAZY_SAVE(t3, 4) M_SLBV_LAZY_SAVE(t4, 5) M_SLBV_LAZY_SAVE(t5, 6) M_SLBV_LAZY_SAVE(t6, 7)
+		M_SLBV_LAZY_SAVE(a0, 8) M_SLBV_LAZY_SAVE(a1, 9) M_SLBV_LAZY_SAVE(a2, 10) M_SLBV_LAZY_SAVE(a3, 11)
+		M_SLBV_LAZY_SAVE(a4, 12) M_SLBV_LAZY_SAVE(a5, 13) M_SLBV_LAZY_SAVE(a6, 14) M_SLBV_LAZY_SAVE(a7, 15)
+		"csrr a0, mcause\n"
+		"csrr a1, mtval\n"
+		"call slbv_lazy_trap_handler\n"
+		M_SLBV_LAZY_RESTORE(ra, 0) M_SLBV_LAZY_RESTORE(t0, 1) M_SLBV_LAZY_RESTORE(t1, 2) M_SLBV_LAZY_RESTORE(t2, 3)
+		M_SLBV_LAZY_RESTORE(t3, 4) M_SLBV_LAZY_RESTORE(t4, 5) M_SLBV_LAZY_RESTORE(t5, 6) M_SLBV_LAZY_RESTORE(t6, 7)
+		M_SLBV_LAZY_RESTORE(a0, 8) M_SLBV_LAZY_RESTORE(a1, 9) M_SLBV_LAZY_RESTORE(a2, 10) M_SLBV_LAZY_RESTORE(a3, 11)
+		M_SLBV_LAZY_RESTORE(a4, 12) M_SLBV_LAZY_RESTORE(a5, 13) M_SLBV_LAZY_RESTORE(a6, 14) M_SLBV_LAZY_RESTORE(a7, 15)
+		"addi sp, sp, " M_SLBV_LAZY_FRAME_SIZE "\n"
+		"mret\n");
+}
+#endif /* _WITH_SLBV_LAZY_XIP_ */
+
+#ifdef _WITH_SLBV_COMPRESSED_IMAGE_
+/******************************************************************************/
+/** Decode one LZ4 block, output may reference data from previous blocks */
+int_pltfrm slbv_lz4_decode_block(const uint8_t *p_in, uint32_t in_len, uint8_t *p_out, uint32_t *p_pos, uint32_t out_max)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint32_t									in = 0;
+	uint32_t									pos;
+	uint32_t									length;
+	uint32_t									offset;
+	uint8_t										token;
+	uint8_t										byte;
+
+	/** Check input pointer */
+	if( !p_in || !p_out || !p_pos )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_lz4_decode_block_out;
+	}
+	/** Resume output where previous block stopped */
+	pos = *p_pos;
+	while( in < in_len )
+	{
+		token = p_in[in++];
+		/** Literals length */
+		length = (uint32_t)( token >> C_SLBV_LZ4_TOKEN_LITERAL_OFST );
+		if( C_SLBV_LZ4_TOKEN_LENGTH_MASK == length )
+		{
+			do
+			{
+				if( in >= in_len )
+				{
+					err = N_SLBV_ERR_DECOMPRESSION_FAILURE;
+					goto slbv_lz4_decode_block_out;
+				}
+				byte = p_in[in++];
+				length += byte;
+			} while( 0xff == byte );
+		}
+		if( ( length > ( in_len - in ) ) || ( length > ( out_max - pos ) ) )
+		{
+			/** Literals overrun input or output */
+			err = N_SLBV_ERR_DECOMPRESSION_FAILURE;
+			goto slbv_lz4_decode_block_out;
+		}
+		memcpy((void*)&p_out[pos], (const void*)&p_in[in], length);
+		in += length;
+		pos += length;
+		/** Last sequence of block has literals only */
+		if( in == in_len )
+		{
+			break;
+		}
+		/** Match offset, little endian */
+		if( sizeof(uint16_t) > ( in_len - in ) )
+		{
+			err = N_SLBV_ERR_DECOMPRESSION_FAILURE;
+			goto slbv_lz4_decode_block_out;
+		}
+		offset = (uint32_t)p_in[in] | ( (uint32_t)p_in[in + 1] << 8 );
+		in += sizeof(uint16_t);
+		if( !offset || ( offset > pos ) )
+		{
+			/** Reference out of decompressed data */
+			err = N_SLBV_ERR_DECOMPRESSION_FAILURE;
+			goto slbv_lz4_decode_block_out;
+		}
+		/** Match length */
+		length = (uint32_t)( token & C_SLBV_LZ4_TOKEN_LENGTH_MASK );
+		if( C_SLBV_LZ4_TOKEN_LENGTH_MASK == length )
+		{
+			do
+			{
+				if( in >= in_len )
+				{
+					err = N_SLBV_ERR_DECOMPRESSION_FAILURE;
+					goto slbv_lz4_decode_block_out;
+				}
+				byte = p_in[in++];
+				length += byte;
+			} while( 0xff == byte );
+		}
+		length += C_SLBV_LZ4_MIN_MATCH;
+		if( length > ( out_max - pos ) )
+		{
+			err = N_SLBV_ERR_DECOMPRESSION_FAILURE;
+			goto slbv_lz4_decode_block_out;
+		}
+		/** Byte per byte, source and destination may overlap */
+		while( length-- )
+		{
+			p_out[pos] = p_out[pos - offset];
+			pos++;
+		}
+	}
+	/** Update output position */
+	*p_pos = pos;
+	err = NO_ERROR;
+slbv_lz4_decode_block_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Hash [src, src_end[ into current hash context while decompressing stream to 'dst' */
+int_pltfrm slbv_comp_hash_install(t_context *p_ctx, uint_pltfrm src, uint_pltfrm src_end, uint_pltfrm dst, uint32_t dst_size)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint32_t									pos = 0;
+	uint32_t									block_hdr;
+	uint32_t									block_size;
+
+	/** Check input pointer */
+	if( !p_ctx || !src || !dst )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_comp_hash_install_out;
+	}
+	else if( ( src + sizeof(t_slbv_comp_desc) ) > src_end )
+	{
+		err = N_SLBV_ERR_DECOMPRESSION_FAILURE;
+		goto slbv_comp_hash_install_out;
+	}
+#ifdef _WITH_GPIO_CHARAC_
+	/** Set GPIO SHA high */
+	metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 1);
+#endif /* _WITH_GPIO_CHARAC_ */
+	/** Stream descriptor */
+	err = scl_sha_core((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+						(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+						(const uint8_t*)src,
+						sizeof(t_slbv_comp_desc));
+	src += sizeof(t_slbv_comp_desc);
+	/** Blocks, up to end marker */
+	while( SCL_OK == err )
+	{
+		if( ( src + sizeof(uint32_t) ) > src_end )
+		{
+			/** End marker is missing */
+			err = N_SLBV_ERR_DECOMPRESSION_FAILURE;
+			goto slbv_comp_hash_install_out;
+		}
+		memcpy((void*)&block_hdr, (const void*)src, sizeof(uint32_t));
+		block_size = ( block_hdr >> C_SLBV_COMP_BLOCK_SIZE_OFST ) & C_SLBV_COMP_BLOCK_SIZE_MASK_NOOFST;
+		if( ( block_size > C_SLBV_COMP_BLOCK_SIZE_MAX ) ||
+			( ( src + sizeof(uint32_t) + block_size ) > src_end ) )
+		{
+			/** Block does not fit in signed area */
+			err = N_SLBV_ERR_DECOMPRESSION_FAILURE;
+			goto slbv_comp_hash_install_out;
+		}
+		/** Hash block header and data */
+		err = scl_sha_core((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+							(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+							(const uint8_t*)src,
+							sizeof(uint32_t) + block_size);
+		src += sizeof(uint32_t);
+		if( ( SCL_OK != err ) || !block_size )
+		{
+			/** Crypto failure or end marker */
+			break;
+		}
+		/** Then decode block, just fetched from boot medium */
+		if( block_hdr & C_SLBV_COMP_BLOCK_STORED_MASK )
+		{
+			/** Block is stored uncompressed */
+			if( block_size > ( dst_size - pos ) )
+			{
+				err = N_SLBV_ERR_DECOMPRESSION_FAILURE;
+				goto slbv_comp_hash_install_out;
+			}
+			memcpy((void*)( dst + pos ), (const void*)src, block_size);
+			pos += block_size;
+		}
+		else
+		{
+			err = slbv_lz4_decode_block((const uint8_t*)src, block_size, (uint8_t*)dst, &pos, dst_size);
+			if( NO_ERROR != err )
+			{
+				goto slbv_comp_hash_install_out;
+			}
+		}
+		src += block_size;
+	}
+	/** Trailing signed data, if any */
+	if( ( SCL_OK == err ) && ( src < src_end ) )
+	{
+		err = scl_sha_core((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+							(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+							(const uint8_t*)src,
+							src_end - src);
+	}
+	if( SCL_OK != err )
+	{
+		/** Should not happen */
+		err = GENERIC_ERR_CRITICAL;
+	}
+	else if( pos != dst_size )
+	{
+		/** Decompressed size does not match descriptor */
+		err = N_SLBV_ERR_DECOMPRESSION_FAILURE;
+	}
+	else
+	{
+		/** No error */
+		err = NO_ERROR;
+	}
+slbv_comp_hash_install_out:
+#ifdef _WITH_GPIO_CHARAC_
+	/** Set GPIO SHA low */
+	metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 0);
+#endif /* _WITH_GPIO_CHARAC_ */
+	/** End Of Function */
+	return err;
+}
+#endif /* _WITH_SLBV_COMPRESSED_IMAGE_ */
+
+#ifdef _WITH_SLBV_ENCRYPTED_IMAGE_
+/******************************************************************************/
+/** Copy, hash then decrypt chunk per chunk : ciphertext is read once from boot medium */
+int_pltfrm slbv_enc_hash_install(t_context *p_ctx, uint_pltfrm src, uint_pltfrm src_end, uint_pltfrm dst, uint32_t dst_size)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	volatile t_slbv_enc_desc					*p_desc = (volatile t_slbv_enc_desc*)src;
+	t_slbv_aes_ctx								aes;
+	uint8_t										key[C_OTP_IMG_KEY_SIZE];
+	uint8_t										counter[C_SLBV_AES_BLOCK_SIZE];
+	uint32_t									offset;
+	uint32_t									size;
+	uint32_t									i;
+
+	/** Initialize local buffers, they are wiped at exit */
+	memset((void*)&aes, 0x00, sizeof(t_slbv_aes_ctx));
+	memset((void*)key, 0x00, sizeof(key));
+	/** Check input pointer */
+	if( !p_ctx || !src || !dst )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_enc_hash_install_out;
+	}
+	else if( ( src + sizeof(t_slbv_enc_desc) + dst_size ) > src_end )
+	{
+		/** Ciphertext does not fit in signed area */
+		err = N_SLBV_ERR_DECRYPTION_FAILURE;
+		goto slbv_enc_hash_install_out;
+	}
+	/** Retrieve image decryption key */
+	err = sbrm_read_otp(p_ctx, C_OTP_IMG_KEY_OFST, key, C_OTP_IMG_KEY_SIZE);
+	if( NO_ERROR != err )
+	{
+		err = N_SLBV_ERR_NO_DECRYPTION_KEY;
+		goto slbv_enc_hash_install_out;
+	}
+	/** Virgin key is not a key */
+	for( i = 0;( i < p_desc->key_size ) && ( C_PATTERN_VIRGIN_8BITS == key[i] );i++ );
+	if( i == p_desc->key_size )
+	{
+		err = N_SLBV_ERR_NO_DECRYPTION_KEY;
+		goto slbv_enc_hash_install_out;
+	}
+	err = slbv_aes_setkey(&aes, key, p_desc->key_size);
+	if( NO_ERROR != err )
+	{
+		goto slbv_enc_hash_install_out;
+	}
+	memcpy((void*)counter, (const void*)p_desc->iv, C_SLBV_AES_BLOCK_SIZE);
+#ifdef _WITH_GPIO_CHARAC_
+	/** Set GPIO SHA high */
+	metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 1);
+#endif /* _WITH_GPIO_CHARAC_ */
+	/** Stream descriptor */
+	err = scl_sha_core((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+						(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+						(const uint8_t*)src,
+						sizeof(t_slbv_enc_desc));
+	src += sizeof(t_slbv_enc_desc);
+	/** Ciphertext */
+	for( offset = 0;( offset < dst_size ) && ( SCL_OK == err );offset += size )
+	{
+		size = M_WHOIS_MIN(dst_size - offset, C_SLBV_ENC_CHUNK_SIZE);
+		/** Fetch chunk from boot medium */
+		memcpy((void*)( dst + offset ), (const void*)( src + offset ), size);
+		/** Hash what has been fetched */
+		err = scl_sha_core((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+							(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+							(const uint8_t*)( dst + offset ),
+							size);
+		if( SCL_OK != err )
+		{
+			break;
+		}
+		/** Then decrypt it in place, while still in cache */
+		err = slbv_aes_ctr_xcrypt(p_ctx, &aes, counter, (const uint8_t*)( dst + offset ), (uint8_t*)( dst + offset ), size);
+		if( NO_ERROR != err )
+		{
+			goto slbv_enc_hash_install_out;
+		}
+	}
+	src += dst_size;
+	/** Trailing signed data, if any */
+	if( ( SCL_OK == err ) && ( src < src_end ) )
+	{
+		err = scl_sha_core((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+							(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+							(const uint8_t*)src,
+							src_end - src);
+	}
+	if( SCL_OK != err )
+	{
+		/** Should not happen */
+		err = GENERIC_ERR_CRITICAL;
+	}
+	else
+	{
+		/** No error */
+		err = NO_ERROR;
+	}
+slbv_enc_hash_install_out:
+#ifdef _WITH_GPIO_CHARAC_
+	if( p_ctx )
+	{
+		/** Set GPIO SHA low */
+		metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 0);
+	}
+#endif /* _WITH_GPIO_CHARAC_ */
+	/** Wipe key material */
+	memset((void*)&aes, 0x00, sizeof(t_slbv_aes_ctx));
+	memset((void*)key, 0x00, sizeof(key));
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Measure AES-CTR throughput on 'length' bytes of free RAM */
+int_pltfrm slbv_aes_benchmark(t_context *p_ctx, uint32_t length, uint32_t core_freq_hz, uint64_t *p_cycles, uint32_t *p_mbps_x100)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	t_slbv_aes_ctx								aes;
+	uint8_t										key[C_AES256_SIZE];
+	uint8_t										counter[C_SLBV_AES_BLOCK_SIZE];
+	uint_pltfrm									start;
+	uint_pltfrm									stop;
+
+	/** Check input pointer */
+	if( !p_ctx || !p_cycles || !p_mbps_x100 )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else if( !length || ( ( p_ctx->free_ram_start + length ) > p_ctx->free_ram_end ) )
+	{
+		/** Buffer must fit in free RAM */
+		err = N_SLBV_ERR_NOT_IN_RANGE;
+	}
+	else
+	{
+		/** Dummy key and counter */
+		memset((void*)key, 0xa5, sizeof(key));
+		memset((void*)counter, 0x00, sizeof(counter));
+		err = slbv_aes_setkey(&aes, key, C_AES256_SIZE);
+		if( NO_ERROR == err )
+		{
+			M_CSR_READ(mcycle, start);
+			err = slbv_aes_ctr_xcrypt(p_ctx,
+										&aes,
+										counter,
+										(const uint8_t*)p_ctx->free_ram_start,
+										(uint8_t*)p_ctx->free_ram_start,
+										length);
+			M_CSR_READ(mcycle, stop);
+			*p_cycles = (uint64_t)( stop - start );
+			/** MB/s = length * freq / cycles / 2^20, with 2 decimals */
+			*p_mbps_x100 = ( *p_cycles ) ? (uint32_t)( ( (uint64_t)length * core_freq_hz / *p_cycles * 100 ) / C_GENERIC_MEGA ) : 0;
+		}
+		memset((void*)&aes, 0x00, sizeof(t_slbv_aes_ctx));
+	}
+	/** End Of Function */
+	return err;
+}
+#endif /* _WITH_SLBV_ENCRYPTED_IMAGE_ */
+
+#ifdef _WITH_SLBV_MANIFEST_
+/******************************************************************************/
+/** Install and check every segment listed in (already verified) manifest */
+int_pltfrm slbv_manifest_process(t_context *p_ctx, e_slbv_slb_id slb_id)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	t_slbv_manifest								*p_manifest = &slbv_context.manifest.table;
+	t_slbv_manifest_seg							*p_seg;
+	uint_pltfrm									src;
+	uint_pltfrm									dst;
+	uint_pltfrm									exec;
+	uint_pltfrm									manifest_end;
+	uint32_t									i;
+	uint8_t										boot_found = FALSE;
+	uint8_t										digest[SHA384_BYTE_HASHSIZE] __attribute__((aligned(0x10)));
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_manifest_process_out;
+	}
+	/** Only RAM copy of manifest is used, as bounded and signed */
+	manifest_end = slbv_context.manifest.table_end;
+	slbv_context.manifest.nb_installed = 0;
+	for( i = 0;( i < p_manifest->nb_segments ) && ( i < C_SLBV_MANIFEST_SEG_MAX );i++ )
+	{
+		p_seg = &p_manifest->segment[i];
+		src = (uint_pltfrm)slbv_context.p_hdr + p_seg->offset;
+		/** Segment data must be inside image, after manifest */
+		if( !p_seg->size ||
+			( src < manifest_end ) ||
+			( ( (uint64_t)p_seg->offset + p_seg->size ) > slbv_context.p_hdr->secure_appli_image_size ) )
+		{
+			err = N_SLBV_ERR_MANIFEST_INVALID;
+			goto slbv_manifest_process_out;
+		}
+		memcpy((void*)&dst, (const void*)p_seg->copy_address, sizeof(uint_pltfrm));
+		memcpy((void*)&exec, (const void*)p_seg->execution_address, sizeof(uint_pltfrm));
 #if __riscv_xlen == 32
-		/** 32bits */
-		if( C_PATTERN_VIRGIN_32BITS == addr_copy )
+		if( C_PATTERN_VIRGIN_32BITS == dst )
 #elif __riscv_xlen == 64
-		/** 64bits */
-		if( C_PATTERN_VIRGIN_64BITS == addr_copy )
+		if( C_PATTERN_VIRGIN_64BITS == dst )
 #else
 #error [__riscv_xlen] A value for bus width must be defined
 #endif /* __riscv_xlen */
 		{
-			/** Ok, it's eXecute in Place then updated boundaries */
-			boundary_down = (uint_pltfrm)&__qspi_start;
-			boundary_up = boundary_down + (uint_pltfrm)&__qspi_size;
-			/** Update addr_copy to reflect XiP choice */
-			addr_copy = boundary_down;
-			/** Refresh token */
-			token_xip = TRUE;
-		}
-		/** Check is copy address is in range if not XIP */
-		else if( ( (uint_pltfrm)boundary_down <= addr_copy) && ( (uint_pltfrm)boundary_up >= ( addr_copy + raw_binary_size ) ) )
-		{
-			/** Ok, destination area is in range */
+			/** eXecute in Place, segment is checked where it is */
+			dst = src;
 		}
-		else
+		else if( ( (uint_pltfrm)&__sbr_free_start_addr > dst ) ||
+				( ( (uint_pltfrm)&__sbr_free_end_addr - dst ) < p_seg->size ) )
 		{
 			/** Copy address not in expected area */
 			err = N_SLBV_ERR_NOT_IN_RANGE;
-			goto slbv_check_slb_out;
+			goto slbv_manifest_process_out;
 		}
-		/** Check if execution address is in destination area (copy address + binary size - 1 opcode size ) */
-		if( ( addr_copy <= addr_exec ) &&
-			( ( addr_copy + slbv_context.p_hdr->secure_appli_image_size - sizeof(uint32_t) ) >= addr_exec) )
+		else if( TRUE == slbv_area_overlaps(dst, p_seg->size, slbv_context.manifest.installed, slbv_context.manifest.nb_installed) )
 		{
-			/** Set 64bits execution address to context structure */
-			slbv_context.jump_fct_ptr = (void*)addr_exec;
+			/** Segments must not overlap, a later one would overwrite checked data */
+			err = N_SLBV_ERR_MANIFEST_INVALID;
+			goto slbv_manifest_process_out;
 		}
-		else
+		/** Execution address must be in this segment, as installed and checked */
+		if( ( sizeof(uint16_t) > p_seg->size ) ||
+			( dst > exec ) ||
+			( ( exec - dst ) > ( p_seg->size - sizeof(uint16_t) ) ) )
 		{
 			/** Execution address does not fit in */
 			err = N_SLBV_ERR_EXEC_NOT_IN_RANGE;
-			goto slbv_check_slb_out;
-		}
-		/** Certificate(s) management *****************************************/
-		/** Check algorithm */
-		if( N_KM_ALGO_ECDSA384 != slbv_context.p_hdr->algo )
-		{
-			/** Algorithm not supported */
-			err = N_SLBV_ERR_ALGO_NOT_SUPPORTED;
-			goto slbv_check_slb_out;
+			goto slbv_manifest_process_out;
 		}
-		/** Set number of signatures to verify */
-		if( C_SEC_HDR_ONE_SIGNATURE == slbv_context.p_hdr->nb_signatures )
+		/** Install segment then hash what has been installed */
+		if( dst != src )
 		{
-			/**  */
-			loop = 1;
+			memcpy((void*)dst, (const void*)src, p_seg->size);
+			slbv_context.manifest.installed[slbv_context.manifest.nb_installed].dst = dst;
+			slbv_context.manifest.installed[slbv_context.manifest.nb_installed].size = p_seg->size;
+			slbv_context.manifest.nb_installed++;
 		}
-#ifdef __WITH_2_SIGNATURES_SUPORT_
-		else if ( C_SEC_HDR_TWO_SIGNATURES == slbv_context.p_hdr->nb_signatures )
+		err = slbv_hash(p_ctx,
+						(metal_scl_t*)p_ctx->p_metal_sifive_scl,
+						(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+						(const uint8_t*)dst,
+						p_seg->size,
+						digest);
+		if( NO_ERROR != err )
 		{
-			/**  */
-			loop = 2;
+			goto slbv_manifest_process_out;
 		}
-#endif /* __WITH_2_SIGNATURES_SUPORT_ */
-		else
+		if( memcmp((const void*)digest, (const void*)p_seg->digest, SHA384_BYTE_HASHSIZE) )
 		{
-			/** Value is not in range */
-			err = N_SLBV_ERR_NOT_SUPPORTED;
-			goto slbv_check_slb_out;
+			/** Segment does not match manifest */
+			err = N_SLBV_ERR_MANIFEST_SEGMENT_MISMATCH;
+			goto slbv_manifest_process_out;
 		}
-		/** Check key(s) coherence */
-		if( ( C_SEC_HDR_ONE_SIGNATURE == slbv_context.p_hdr->nb_signatures ) &&
-				( N_KM_KEYID_CSK != slbv_context.p_hdr->sign_keyid_1 ) )
+		/** Keep entry point */
+		slbv_context.manifest.entry[i] = exec;
+		if( (uint8_t)slb_id == p_seg->slb_id )
 		{
-			/**  */
-			err = N_SLBV_ERR_KEY_INCOHERENCE;
-			goto slbv_check_slb_out;
+			/** Segment for core running Secure Boot ROM : last one wins */
+			slbv_context.jump_fct_ptr = (void*)exec;
+			boot_found = TRUE;
 		}
-		else if( C_EDCSA384_SIZE_BITS != slbv_context.p_hdr->signature_size_bits )
+	}
+	if( FALSE == boot_found )
+	{
+		/** Nothing to boot on this core */
+		err = N_SLBV_ERR_MANIFEST_NO_BOOT_SEGMENT;
+	}
+slbv_manifest_process_out:
+	if( NO_ERROR != err )
+	{
+		/** Do not leave unverified code in destination areas */
+		for( i = 0;i < slbv_context.manifest.nb_installed;i++ )
 		{
-			/** Bad key size */
-			err = N_SLBV_ERR_WRONG_KEY_SIZE;
-			goto slbv_check_slb_out;
+			memset((void*)slbv_context.manifest.installed[i].dst, 0x00, slbv_context.manifest.installed[i].size);
 		}
-		/** Check signature(s) - Enter the loop */
-		for( i = 0;i < loop;i++ )
-		{
-			/** Initialize key buffer */
-			memset((void*)&key_data, 0x00, sizeof(t_key_data));
-			/** Assign pointers */
-			key.p_descriptor = (uint32_t*)&key_data.algo;
-			key.ecdsa.p_x = (uint8_t*)key_data.key;
-			key.ecdsa.p_y = key.ecdsa.p_x + C_EDCSA384_SIZE;
-			key.certificate.p_x = (uint8_t*)key_data.certificate;
-			key.certificate.p_y = key.certificate.p_x + C_EDCSA384_SIZE;
-			switch( i )
-			{
-				case 0:
-					key_sig = slbv_context.p_hdr->sign_keyid_1;
-					break;
-				case 1:
-					key_sig = slbv_context.p_hdr->sign_keyid_2;
-					break;
-				default:
-					err = GENERIC_ERR_CRITICAL;
-					goto slbv_check_slb_out;
-			}
-			/** Retrieve key */
-			err = km_get_key(p_ctx,
-								key_sig,
-								(t_km_key*)&key,
-								(uint32_t*)&tmp);
-			if( err )
-			{
-				/** Valid CSK not available/found */
-				err = N_SLBV_ERR_NO_CSK_AVAILABLE;
-				goto slbv_check_slb_out;
-			}
-			/**  */
-			/** Initialization of hash buffer */
-#ifdef _WITH_GPIO_CHARAC_
-			/** Green LED Off/On */
-			metal_led_off(p_ctx->led[1]);
-			metal_led_on(p_ctx->led[1]);
-			/** Set GPIO SHA high */
-			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 1);
-#endif /* _WITH_GPIO_CHARAC_ */
-			err = scl_sha_init((metal_scl_t*)p_ctx->p_metal_sifive_scl,
-								(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
-								SCL_HASH_SHA384);
-#ifdef _WITH_GPIO_CHARAC_
-			/** Set GPIO SHA low */
-			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 0);
-#endif /* _WITH_GPIO_CHARAC_ */
-			if( SCL_OK != err )
-			{
-				/** Critical error */
-				err = N_SLBV_ERR_CRYPTO_FAILURE;
-				goto slbv_check_slb_out;
-			}
-			/** Hash header without signature */
-			p_tmp = (volatile uint8_t*)slbv_context.p_hdr;
-			/** Remove signature from structure size */
-			tmp_size = (volatile uint32_t)sizeof(t_secure_header) - C_SIGNATURE_MAX_SIZE;
-#ifdef _WITH_GPIO_CHARAC_
-			/** Set GPIO SHA high */
-			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 1);
-#endif /* _WITH_GPIO_CHARAC_ */
-			err = scl_sha_core((metal_scl_t*)p_ctx->p_metal_sifive_scl,
-								(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
-								(const uint8_t*)p_tmp,
-								tmp_size);
-#ifdef _WITH_GPIO_CHARAC_
-			/** Set GPIO SHA low */
-			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 0);
-#endif /* _WITH_GPIO_CHARAC_ */
-			if( SCL_OK != err )
-			{
-				/** Should not happen */
-				err = GENERIC_ERR_CRITICAL;
-				goto slbv_check_slb_out;
-			}
+		slbv_context.manifest.nb_installed = 0;
+	}
+	/** End Of Function */
+	return err;
+}
 
-			/** Hash binary image, starting from just after signature */
-			p_tmp = (volatile uint8_t*)slbv_context.p_hdr + sizeof(t_secure_header);
-			/**  */
-			tmp_size = (volatile uint32_t)slbv_context.p_hdr->secure_appli_image_size - sizeof(t_secure_header);
-			/** If 2 signatures then remove one ECDSA384 signature size */
-			if( C_SEC_HDR_TWO_SIGNATURES == slbv_context.p_hdr->nb_signatures )
-			{
-				tmp_size -= C_SIGNATURE_MAX_SIZE;
-			}
-			/** Hash binary image */
-#ifdef _WITH_GPIO_CHARAC_
-			/** Set GPIO SHA high */
-			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 1);
-#endif /* _WITH_GPIO_CHARAC_ */
-			err = scl_sha_core((metal_scl_t*)p_ctx->p_metal_sifive_scl,
-								(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
-								(const uint8_t*)p_tmp,
-								tmp_size);
-#ifdef _WITH_GPIO_CHARAC_
-			/** Set GPIO SHA low */
-			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 0);
-#endif /* _WITH_GPIO_CHARAC_ */
-			if( SCL_OK != err )
-			{
-				/** Should not happen */
-				err = GENERIC_ERR_CRITICAL;
-				goto slbv_check_slb_out;
-			}
-			/** Then finish computation */
-			hash_len = sizeof(p_ctx->digest);
-			memset((void*)p_ctx->digest, 0x00, SHA384_BYTE_HASHSIZE);
-#ifdef _WITH_GPIO_CHARAC_
-			/** Set GPIO SHA high */
-			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 1);
-#endif /* _WITH_GPIO_CHARAC_ */
-			err = scl_sha_finish((metal_scl_t*)p_ctx->p_metal_sifive_scl,
-									(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
-									p_ctx->digest,
-									&hash_len);
-#ifdef _WITH_GPIO_CHARAC_
-			/** Set GPIO SHA low */
-			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 0);
-#endif /* _WITH_GPIO_CHARAC_ */
-			if( SCL_OK != err )
-			{
-				/** Critical error */
-				err = GENERIC_ERR_CRITICAL;
-				goto slbv_check_slb_out;
-			}
-			/** Assign parameters */
-			Q.x = key.ecdsa.p_x;
-			Q.y = key.ecdsa.p_y;
-			signature.r = (uint8_t*)( slbv_context.p_hdr->signature + ( i * C_SIGNATURE_MAX_SIZE ) );
-			signature.s = signature.r + C_EDCSA384_SIZE;
-			/** Check certificate */
-#ifdef _WITH_GPIO_CHARAC_
-			/** Set GPIO check ECDSA high */
-			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA_ECDSA, 1);
-#endif /* _WITH_GPIO_CHARAC_ */
-			err = scl_ecdsa_verification((metal_scl_t*)p_ctx->p_metal_sifive_scl,
-											&ecc_secp384r1,
-											(const ecc_affine_const_point_t *const)&Q,
-											(const ecdsa_signature_const_t *const)&signature,
-											p_ctx->digest,
-											SHA384_BYTE_HASHSIZE);
-#ifdef _WITH_GPIO_CHARAC_
-			/** Set GPIO check ECDSA low */
-			metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA_ECDSA, 0);
-			/** Green LED Off */
-			metal_led_off(p_ctx->led[1]);
-#endif /* _WITH_GPIO_CHARAC_ */
-			if( SCL_OK != err )
-			{
-				/** SLB is not granted to be executed on this platform */
-				err = N_SLBV_ERR_CRYPTO_FAILURE;
-				goto slbv_check_slb_out;
-			}
-			else
+#ifdef _WITH_SLBV_MULTI_HART_
+/******************************************************************************/
+/** Post a jump work to every parked hart listed in segments' hart mask */
+int_pltfrm slbv_manifest_release_harts(t_context *p_ctx)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	volatile t_slbv_manifest_seg				*p_seg;
+	volatile t_slbv_hart_work					*p_work;
+	uint32_t									self;
+	uint32_t									i;
+	uint32_t									hart;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else if( FALSE == slbv_context.manifest.enabled )
+	{
+		/** Nothing to do */
+		err = NO_ERROR;
+	}
+	else
+	{
+		self = (uint32_t)metal_cpu_get_current_hartid();
+		for( i = 0;( i < slbv_context.manifest.table.nb_segments ) && ( i < C_SLBV_MANIFEST_SEG_MAX );i++ )
+		{
+			p_seg = &slbv_context.manifest.table.segment[i];
+			for( hart = 0;hart < C_SLBV_HART_NB_MAX;hart++ )
 			{
-				/** No error */
-				err = NO_ERROR;
+				if( ( self == hart ) || ( TRUE == slbv_hart_lost[hart] ) || !( p_seg->hart_mask & ( 0x1UL << hart ) ) )
+				{
+					continue;
+				}
+				p_work = &slbv_hart_work[hart];
+				p_work->type = N_SLBV_HART_JOB_JUMP;
+				p_work->entry = slbv_context.manifest.entry[i];
+				__atomic_store_n(&p_work->state, N_SLBV_HART_WORK_POSTED, __ATOMIC_SEQ_CST);
+				/** Wake hart up */
+				C_SLBV_CLINT_MSIP(hart) = 1;
 			}
 		}
-		/** Check if FSBL is XIP or not, if so install it */
-		if( FALSE == token_xip )
-		{
-			/** If not, SLB has been checked ok, let's copy it at destination area */
-			memcpy((void*)addr_copy,
-					(const void*)( slbv_context.p_hdr + slbv_context.p_hdr->fimware_start_offset ),
-					raw_binary_size);
-		}
+		/** No error */
+		err = NO_ERROR;
 	}
-slbv_check_slb_out:
 	/** End Of Function */
 	return err;
 }
-
+#endif /* _WITH_SLBV_MULTI_HART_ */
+#endif /* _WITH_SLBV_MANIFEST_ */
 
 /******************************************************************************/
 /* End Of file */
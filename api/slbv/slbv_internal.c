@@ -38,6 +38,10 @@
 #include <patch.h>
 #include <otp_mapping.h>
 /** Other includes */
+#ifdef _WITH_GPT_
+#include <sbrm.h>
+#include <sbrm_internal.h>
+#endif /* _WITH_GPT_ */
 /** Local includes */
 #include <slbv.h>
 #include <slbv_internal.h>
@@ -59,8 +63,92 @@ const gpt_guid gpt_guid_sifive_fsbl = {{
 const gpt_guid gpt_guid_sifive_bare_metal = {{
   0x53, 0xb3, 0x54, 0x2e, 0x71, 0x12, 0x42, 0x48, 0x80, 0x6f, 0xe4, 0x36, 0xd6, 0xaf, 0x69, 0x85
 }};
+// Partition map read from boot device
+__attribute__((section(".bss"))) gpt_partition_cache gpt_cache;
 #endif /* _WITH_GPT_ */
 
+#ifdef _WITH_SLBV_ENCRYPTED_IMAGE_
+/** AES forward S-box */
+const uint8_t slbv_aes_sbox[256] =
+{
+	0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+	0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+	0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+	0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+	0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+	0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+	0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+	0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+	0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+	0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+	0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+	0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+	0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+	0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+	0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+	0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+/** T-table, built at first use to save ROM : other tables are byte rotations of it */
+__attribute__((section(".bss"))) uint32_t slbv_aes_te0[256];
+#ifndef _WITHOUT_SELFTESTS_
+/** Known-answer vectors : FIPS-197 appendix C.1 and C.3 for single block,
+ * SP 800-38A F.5.1 and F.5.5 for CTR mode */
+__attribute__((section(".rodata"))) const uint8_t slbv_aes_kat_key[C_AES256_SIZE] =
+{
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+	0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+__attribute__((section(".rodata"))) const uint8_t slbv_aes_kat_pt[C_SLBV_AES_BLOCK_SIZE] =
+{
+	0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+__attribute__((section(".rodata"))) const uint8_t slbv_aes_kat_ct[2][C_SLBV_AES_BLOCK_SIZE] =
+{
+	/** AES-128 */
+	{ 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a },
+	/** AES-256 */
+	{ 0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf, 0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89 }
+};
+__attribute__((section(".rodata"))) const uint8_t slbv_aes_ctr_kat_key[2][C_AES256_SIZE] =
+{
+	/** AES-128, first half only */
+	{ 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c },
+	/** AES-256 */
+	{ 0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+	  0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4 }
+};
+__attribute__((section(".rodata"))) const uint8_t slbv_aes_ctr_kat_counter[C_SLBV_AES_BLOCK_SIZE] =
+{
+	0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff
+};
+__attribute__((section(".rodata"))) const uint8_t slbv_aes_ctr_kat_pt[4 * C_SLBV_AES_BLOCK_SIZE] =
+{
+	0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+	0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+	0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+	0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+};
+__attribute__((section(".rodata"))) const uint8_t slbv_aes_ctr_kat_ct[2][4 * C_SLBV_AES_BLOCK_SIZE] =
+{
+	/** CTR-AES128.Encrypt */
+	{ 0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+	  0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff, 0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+	  0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+	  0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee },
+	/** CTR-AES256.Encrypt */
+	{ 0x60, 0x1e, 0xc3, 0x13, 0x77, 0x57, 0x89, 0xa5, 0xb7, 0xa7, 0xf5, 0x04, 0xbb, 0xf3, 0xd2, 0x28,
+	  0xf4, 0x43, 0xe3, 0xca, 0x4d, 0x62, 0xb5, 0x9a, 0xca, 0x84, 0xe9, 0x90, 0xca, 0xca, 0xf5, 0xc5,
+	  0x2b, 0x09, 0x30, 0xda, 0xa2, 0x3d, 0xe9, 0x4c, 0xe8, 0x70, 0x17, 0xba, 0x2d, 0x84, 0x98, 0x8d,
+	  0xdf, 0xc9, 0xc5, 0x8d, 0xb6, 0x7a, 0xad, 0xa6, 0x13, 0xc2, 0xdd, 0x08, 0x45, 0x79, 0x41, 0xa6 }
+};
+#endif /* _WITHOUT_SELFTESTS_ */
+#endif /* _WITH_SLBV_ENCRYPTED_IMAGE_ */
+#ifdef _WITH_SLBV_EMMC_
+/** ADMA2 descriptor chain, and EXT_CSD register copy */
+__attribute__((section(".bss"),aligned(0x8))) t_sdhci_adma2_desc slbv_emmc_adma2_desc[C_SLBV_EMMC_ADMA2_DESC_NB];
+__attribute__((section(".bss"),aligned(0x8))) uint8_t slbv_emmc_ext_csd[C_SLBV_EMMC_BLOCK_SIZE];
+#endif /* _WITH_SLBV_EMMC_ */
+
 #ifdef _WITH_GPT_
 /******************************************************************************/
 int32_t guid_equal(const gpt_guid* a, const gpt_guid* b)
@@ -92,6 +180,104 @@ gpt_partition_range gpt_find_partition_by_guid(const void* entries, const gpt_gu
   return (gpt_partition_range) { .first_lba = 0, .last_lba = 0 };
 }
 
+/******************************************************************************/
+/**
+ * Check signature, size and CRC of GPT header. Header is left unchanged.
+ */
+int32_t gpt_check_header(gpt_header* header)
+{
+  uint32_t crc = 0;
+  uint32_t header_crc = header->header_crc;
+
+  if (header->signature != GPT_HEADER_SIGNATURE ||
+      header->header_size < GPT_HEADER_BYTES ||
+      header->header_size > GPT_BLOCK_SIZE) {
+    return ERROR_CODE_GPT_HEADER_INVALID;
+  }
+  // Entries must be at least 128 bytes wide, and array must fit in one burst
+  if (header->partition_entry_size < sizeof(gpt_partition_entry) ||
+      (header->partition_entry_size % sizeof(gpt_partition_entry)) ||
+      !header->num_partition_entries ||
+      header->num_partition_entries > (GPT_PARTITION_ARRAY_MAX_BYTES / header->partition_entry_size)) {
+    return ERROR_CODE_GPT_HEADER_INVALID;
+  }
+  // CRC is computed with its own field zeroed
+  header->header_crc = 0;
+  sbrm_compute_crc(&crc, (uint8_t*) header, header->header_size);
+  header->header_crc = header_crc;
+  if (crc != header_crc) {
+    return ERROR_CODE_GPT_HEADER_INVALID;
+  }
+  return 0;
+}
+
+/******************************************************************************/
+/**
+ * Check partition array CRC then keep non-empty entries in RAM map.
+ */
+int32_t gpt_cache_fill(uintptr_t device, const void* entries, const gpt_header* header)
+{
+  uint32_t crc = 0;
+  const gpt_guid empty = {{ 0 }};
+
+  gpt_cache.device = 0;
+  gpt_cache.num_entries = 0;
+  sbrm_compute_crc(&crc, (uint8_t*) entries, header->num_partition_entries * header->partition_entry_size);
+  if (crc != header->partition_array_crc) {
+    return ERROR_CODE_GPT_ARRAY_CRC;
+  }
+  for (uint32_t i = 0; i < header->num_partition_entries && gpt_cache.num_entries < GPT_CACHE_MAX_ENTRIES; i++) {
+    const gpt_partition_entry* entry = (const gpt_partition_entry*) ((uintptr_t) entries + i * header->partition_entry_size);
+    if (guid_equal(&entry->partition_type_guid, &empty)) {
+      continue;
+    }
+    gpt_cache.entries[gpt_cache.num_entries].partition_type_guid = entry->partition_type_guid;
+    gpt_cache.entries[gpt_cache.num_entries].range = (gpt_partition_range) {
+      .first_lba = entry->first_lba,
+      .last_lba = entry->last_lba,
+    };
+    gpt_cache.num_entries++;
+  }
+  gpt_cache.device = device;
+  return 0;
+}
+
+/******************************************************************************/
+/**
+ * Look for partition in RAM map. Invalid range if map belongs to another
+ * device or partition is not there.
+ */
+gpt_partition_range gpt_cache_lookup(uintptr_t device, const gpt_guid* guid)
+{
+  if (device && device == gpt_cache.device) {
+    for (uint32_t i = 0; i < gpt_cache.num_entries; i++) {
+      if (guid_equal(&gpt_cache.entries[i].partition_type_guid, guid)) {
+        return gpt_cache.entries[i].range;
+      }
+    }
+  }
+  return gpt_invalid_partition_range();
+}
+
+/******************************************************************************/
+/**
+ * Number of bytes worth loading from a partition, given its first block : a
+ * secure image stops at its signed size, anything else is loaded entirely.
+ */
+uint64_t gpt_image_size(const void* first_block, gpt_partition_range range)
+{
+  const t_secure_header* header = (const t_secure_header*) first_block;
+  uint64_t partition_size = (range.last_lba + 1 - range.first_lba) * GPT_BLOCK_SIZE;
+
+  if (header->magic_word1 != C_SFLV_MAGIC_WORD1 ||
+      header->magic_word2 != C_SFLV_MAGIC_WORD2 ||
+      !header->secure_appli_image_size ||
+      header->secure_appli_image_size > partition_size) {
+    return partition_size;
+  }
+  return header->secure_appli_image_size;
+}
+
 /******************************************************************************/
 int32_t get_boot_spi_device(uint32_t mode_select)
 {
@@ -177,30 +363,38 @@ int32_t initialize_sd(spi_ctrl* spictrl, uint32_t peripheral_input_khz, int32_t
 }
 
 /******************************************************************************/
-gpt_partition_range find_sd_gpt_partition(
+/**
+ * Read and check GPT header, then whole partition array with a single CMD18,
+ * and fill partition map. Nothing is read if map already holds this card.
+ */
+int32_t find_sd_gpt_partition(
   spi_ctrl* spictrl,
-  uint64_t partition_entries_lba,
-  uint32_t num_partition_entries,
-  uint32_t partition_entry_size,
   const gpt_guid* partition_type_guid,
-  void* block_buf  // Used to temporarily load blocks of SD card
+  void* array_buf,  // Used to load partition array, GPT_PARTITION_ARRAY_MAX_BYTES at most
+  gpt_partition_range* range
 )
 {
-  // Exclusive end
-  uint64_t partition_entries_lba_end = (
-    partition_entries_lba +
-    (num_partition_entries * partition_entry_size + GPT_BLOCK_SIZE - 1) / GPT_BLOCK_SIZE
-  );
-  for (uint64_t i = partition_entries_lba; i < partition_entries_lba_end; i++) {
-    sd_copy(spictrl, block_buf, i, 1);
-    gpt_partition_range range = gpt_find_partition_by_guid(
-      block_buf, partition_type_guid, GPT_BLOCK_SIZE / partition_entry_size
+  uint8_t gpt_buf[GPT_BLOCK_SIZE];
+  gpt_header* header = (gpt_header*) gpt_buf;
+  int32_t error;
+
+  if (gpt_cache.device != (uintptr_t) spictrl) {
+    error = sd_copy(spictrl, gpt_buf, GPT_HEADER_LBA, 1);
+    if (error) return decode_sd_copy_error(error);
+    error = gpt_check_header(header);
+    if (error) return error;
+    error = sd_copy(
+      spictrl,
+      array_buf,
+      header->partition_entries_lba,
+      (header->num_partition_entries * header->partition_entry_size + GPT_BLOCK_SIZE - 1) / GPT_BLOCK_SIZE
     );
-    if (gpt_is_valid_partition_range(range)) {
-      return range;
-    }
+    if (error) return decode_sd_copy_error(error);
+    error = gpt_cache_fill((uintptr_t) spictrl, array_buf, header);
+    if (error) return error;
   }
-  return gpt_invalid_partition_range();
+  *range = gpt_cache_lookup((uintptr_t) spictrl, partition_type_guid);
+  return 0;
 }
 
 
@@ -218,37 +412,30 @@ int32_t decode_sd_copy_error(int32_t error)
 /******************************************************************************/
 int32_t load_sd_gpt_partition(spi_ctrl* spictrl, void* dst, const gpt_guid* partition_type_guid)
 {
-  uint8_t gpt_buf[GPT_BLOCK_SIZE];
   int32_t error;
-  error = sd_copy(spictrl, gpt_buf, GPT_HEADER_LBA, 1);
-  if (error) return decode_sd_copy_error(error);
-
   gpt_partition_range part_range;
-  {
-    // header will be overwritten by find_sd_gpt_partition(), so locally
-    // scope it.
-    gpt_header* header = (gpt_header*) gpt_buf;
-    part_range = find_sd_gpt_partition(
-      spictrl,
-      header->partition_entries_lba,
-      header->num_partition_entries,
-      header->partition_entry_size,
-      partition_type_guid,
-      gpt_buf
-    );
-  }
+
+  // Partition array is loaded where partition itself will be
+  error = find_sd_gpt_partition(spictrl, partition_type_guid, dst, &part_range);
+  if (error) return error;
 
   if (!gpt_is_valid_partition_range(part_range)) {
     return ERROR_CODE_GPT_PARTITION_NOT_FOUND;
   }
 
-  error = sd_copy(
-    spictrl,
-    dst,
-    part_range.first_lba,
-    part_range.last_lba + 1 - part_range.first_lba
-  );
+  // First block gives image size, then only remaining signed blocks are read
+  error = sd_copy(spictrl, dst, part_range.first_lba, 1);
   if (error) return decode_sd_copy_error(error);
+  uint64_t num_blocks = (gpt_image_size(dst, part_range) + GPT_BLOCK_SIZE - 1) / GPT_BLOCK_SIZE;
+  if (num_blocks > 1) {
+    error = sd_copy(
+      spictrl,
+      (void*) ((uintptr_t) dst + GPT_BLOCK_SIZE),
+      part_range.first_lba + 1,
+      num_blocks - 1
+    );
+    if (error) return decode_sd_copy_error(error);
+  }
   return 0;
 }
 
@@ -294,7 +481,7 @@ inline int32_t _initialize_spi_flash_mmap(spi_ctrl* spictrl, uint32_t spi_clk_in
   }).raw_bits;
 
   spictrl->fctrl.en = 1;
-  __asm__ __volatile__ ("fence io, io");
+  M_FENCE_IO();
   return 0;
 }
 
@@ -342,11 +529,9 @@ int32_t load_mmap_gpt_partition(const void* gpt_base, void* payload_dest, const
   if (!gpt_is_valid_partition_range(range)) {
     return ERROR_CODE_GPT_PARTITION_NOT_FOUND;
   }
-  memcpy(
-    payload_dest,
-    (void*) ((uintptr_t) gpt_base + range.first_lba * GPT_BLOCK_SIZE),
-    (range.last_lba + 1 - range.first_lba) * GPT_BLOCK_SIZE
-  );
+  const void* partition = (const void*) ((uintptr_t) gpt_base + range.first_lba * GPT_BLOCK_SIZE);
+  // Header is readable in place, copy signed image only
+  memcpy(payload_dest, partition, gpt_image_size(partition, range));
   return 0;
 }
 
@@ -355,30 +540,38 @@ int32_t load_mmap_gpt_partition(const void* gpt_base, void* payload_dest, const
 // SPI flash non-memory-mapped
 
 /******************************************************************************/
-gpt_partition_range find_spiflash_gpt_partition(
+/**
+ * Same as find_sd_gpt_partition(), partition array is read with a single
+ * continuous read command.
+ */
+int32_t find_spiflash_gpt_partition(
   spi_ctrl* spictrl,
-  uint64_t partition_entries_lba,
-  uint32_t num_partition_entries,
-  uint32_t partition_entry_size,
   const gpt_guid* partition_type_guid,
-  void* block_buf  // Used to temporarily load blocks of SD card
+  void* array_buf,  // Used to load partition array, GPT_PARTITION_ARRAY_MAX_BYTES at most
+  gpt_partition_range* range
 )
 {
-  // Exclusive end
-  uint64_t partition_entries_lba_end = (
-    partition_entries_lba +
-    (num_partition_entries * partition_entry_size + GPT_BLOCK_SIZE - 1) / GPT_BLOCK_SIZE
-  );
-  for (uint64_t i = partition_entries_lba; i < partition_entries_lba_end; i++) {
-    spi_copy(spictrl, block_buf, i * GPT_BLOCK_SIZE, GPT_BLOCK_SIZE);
-    gpt_partition_range range = gpt_find_partition_by_guid(
-      block_buf, partition_type_guid, GPT_BLOCK_SIZE / partition_entry_size
+  uint8_t gpt_buf[GPT_BLOCK_SIZE];
+  gpt_header* header = (gpt_header*) gpt_buf;
+  int32_t error;
+
+  if (gpt_cache.device != (uintptr_t) spictrl) {
+    error = spi_copy(spictrl, gpt_buf, GPT_HEADER_LBA * GPT_BLOCK_SIZE, GPT_BLOCK_SIZE);
+    if (error) return ERROR_CODE_SPI_COPY_FAILED;
+    error = gpt_check_header(header);
+    if (error) return error;
+    error = spi_copy(
+      spictrl,
+      array_buf,
+      header->partition_entries_lba * GPT_BLOCK_SIZE,
+      header->num_partition_entries * header->partition_entry_size
     );
-    if (gpt_is_valid_partition_range(range)) {
-      return range;
-    }
+    if (error) return ERROR_CODE_SPI_COPY_FAILED;
+    error = gpt_cache_fill((uintptr_t) spictrl, array_buf, header);
+    if (error) return error;
   }
-  return gpt_invalid_partition_range();
+  *range = gpt_cache_lookup((uintptr_t) spictrl, partition_type_guid);
+  return 0;
 }
 
 
@@ -388,35 +581,30 @@ gpt_partition_range find_spiflash_gpt_partition(
 /******************************************************************************/
 int32_t load_spiflash_gpt_partition(spi_ctrl* spictrl, void* dst, const gpt_guid* partition_type_guid)
 {
-  uint8_t gpt_buf[GPT_BLOCK_SIZE];
   int32_t error;
-  error = spi_copy(spictrl, gpt_buf, GPT_HEADER_LBA * GPT_BLOCK_SIZE, GPT_HEADER_BYTES);
-  if (error) return ERROR_CODE_SPI_COPY_FAILED;
-
   gpt_partition_range part_range;
-  {
-    gpt_header* header = (gpt_header*) gpt_buf;
-    part_range = find_spiflash_gpt_partition(
-      spictrl,
-      header->partition_entries_lba,
-      header->num_partition_entries,
-      header->partition_entry_size,
-      partition_type_guid,
-      gpt_buf
-    );
-  }
+
+  // Partition array is loaded where partition itself will be
+  error = find_spiflash_gpt_partition(spictrl, partition_type_guid, dst, &part_range);
+  if (error) return error;
 
   if (!gpt_is_valid_partition_range(part_range)) {
     return ERROR_CODE_GPT_PARTITION_NOT_FOUND;
   }
 
-  error = spi_copy(
-    spictrl,
-    dst,
-    part_range.first_lba * GPT_BLOCK_SIZE,
-    (part_range.last_lba + 1 - part_range.first_lba) * GPT_BLOCK_SIZE
-  );
+  // First block gives image size, then only remaining signed bytes are read
+  error = spi_copy(spictrl, dst, part_range.first_lba * GPT_BLOCK_SIZE, GPT_BLOCK_SIZE);
   if (error) return ERROR_CODE_SPI_COPY_FAILED;
+  uint64_t size = gpt_image_size(dst, part_range);
+  if (size > GPT_BLOCK_SIZE) {
+    error = spi_copy(
+      spictrl,
+      (void*) ((uintptr_t) dst + GPT_BLOCK_SIZE),
+      (part_range.first_lba + 1) * GPT_BLOCK_SIZE,
+      size - GPT_BLOCK_SIZE
+    );
+    if (error) return ERROR_CODE_SPI_COPY_FAILED;
+  }
   return 0;
 }
 
@@ -532,6 +720,923 @@ void ux00boot_load_gpt_partition(void* dst, const gpt_guid* partition_type_guid,
 }
 #endif /* _WITH_GPT_ */
 
+#ifdef _WITH_SLBV_ENCRYPTED_IMAGE_
+/******************************************************************************/
+void slbv_aes_init_tables(void)
+{
+	uint32_t									i;
+	uint32_t									s;
+	uint32_t									s2;
+
+	/** Already built */
+	if( slbv_aes_te0[0] )
+	{
+		return;
+	}
+	for( i = 0;i < 256;i++ )
+	{
+		s = slbv_aes_sbox[i];
+		/** xtime */
+		s2 = ( ( s << 1 ) ^ ( ( s & 0x80 ) ? 0x1b : 0x00 ) ) & 0xff;
+		/** Column { 2s, s, s, 3s }, big endian */
+		slbv_aes_te0[i] = ( s2 << 24 ) | ( s << 16 ) | ( s << 8 ) | ( s2 ^ s );
+	}
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+int_pltfrm slbv_aes_setkey(t_slbv_aes_ctx *p_aes, const uint8_t *p_key, uint32_t key_size)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint32_t									nk;
+	uint32_t									i;
+	uint32_t									tmp;
+	uint8_t										rcon = 0x01;
+
+	/** Check input pointer */
+	if( !p_aes || !p_key )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else if( ( C_AES128_SIZE != key_size ) && ( C_AES256_SIZE != key_size ) )
+	{
+		/** Only AES-128 and AES-256 */
+		err = N_SLBV_ERR_DECRYPTION_FAILURE;
+	}
+	else
+	{
+		slbv_aes_init_tables();
+		memcpy((void*)p_aes->key, (const void*)p_key, key_size);
+		p_aes->key_size = key_size;
+		p_aes->nb_rounds = ( C_AES128_SIZE == key_size ) ? C_SLBV_AES_NB_ROUNDS_128 : C_SLBV_AES_NB_ROUNDS_256;
+		nk = key_size / sizeof(uint32_t);
+		/** First round keys are the key itself */
+		for( i = 0;i < nk;i++ )
+		{
+			p_aes->rk[i] = ( (uint32_t)p_key[4 * i] << 24 ) | ( (uint32_t)p_key[( 4 * i ) + 1] << 16 ) |
+							( (uint32_t)p_key[( 4 * i ) + 2] << 8 ) | (uint32_t)p_key[( 4 * i ) + 3];
+		}
+		/** Key expansion */
+		for( i = nk;i < ( 4 * ( p_aes->nb_rounds + 1 ) );i++ )
+		{
+			tmp = p_aes->rk[i - 1];
+			if( 0 == ( i % nk ) )
+			{
+				/** RotWord, SubWord, Rcon */
+				tmp = ( (uint32_t)slbv_aes_sbox[( tmp >> 16 ) & 0xff] << 24 ) |
+						( (uint32_t)slbv_aes_sbox[( tmp >> 8 ) & 0xff] << 16 ) |
+						( (uint32_t)slbv_aes_sbox[tmp & 0xff] << 8 ) |
+						(uint32_t)slbv_aes_sbox[( tmp >> 24 ) & 0xff];
+				tmp ^= (uint32_t)rcon << 24;
+				rcon = (uint8_t)( ( rcon << 1 ) ^ ( ( rcon & 0x80 ) ? 0x1b : 0x00 ) );
+			}
+			else if( ( 8 == nk ) && ( 4 == ( i % nk ) ) )
+			{
+				/** SubWord only, for AES-256 */
+				tmp = ( (uint32_t)slbv_aes_sbox[( tmp >> 24 ) & 0xff] << 24 ) |
+						( (uint32_t)slbv_aes_sbox[( tmp >> 16 ) & 0xff] << 16 ) |
+						( (uint32_t)slbv_aes_sbox[( tmp >> 8 ) & 0xff] << 8 ) |
+						(uint32_t)slbv_aes_sbox[tmp & 0xff];
+			}
+			p_aes->rk[i] = p_aes->rk[i - nk] ^ tmp;
+		}
+		/** No error */
+		err = NO_ERROR;
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+void slbv_aes_encrypt_block(const t_slbv_aes_ctx *p_aes, const uint8_t *p_in, uint8_t *p_out)
+{
+	uint32_t									s[4];
+	uint32_t									t[4];
+	uint32_t									r;
+	uint32_t									i;
+	const uint32_t								*p_rk = p_aes->rk;
+
+	/** Load state and add first round key */
+	for( i = 0;i < 4;i++ )
+	{
+		s[i] = ( ( (uint32_t)p_in[4 * i] << 24 ) | ( (uint32_t)p_in[( 4 * i ) + 1] << 16 ) |
+				( (uint32_t)p_in[( 4 * i ) + 2] << 8 ) | (uint32_t)p_in[( 4 * i ) + 3] ) ^ p_rk[i];
+	}
+	/** Full rounds : SubBytes, ShiftRows and MixColumns through T-table */
+	for( r = 1;r < p_aes->nb_rounds;r++ )
+	{
+		p_rk += 4;
+		for( i = 0;i < 4;i++ )
+		{
+			t[i] = slbv_aes_te0[s[i] >> 24] ^
+					M_SLBV_ROR32(slbv_aes_te0[( s[( i + 1 ) & 0x3] >> 16 ) & 0xff], 8) ^
+					M_SLBV_ROR32(slbv_aes_te0[( s[( i + 2 ) & 0x3] >> 8 ) & 0xff], 16) ^
+					M_SLBV_ROR32(slbv_aes_te0[s[( i + 3 ) & 0x3] & 0xff], 24) ^
+					p_rk[i];
+		}
+		memcpy((void*)s, (const void*)t, sizeof(s));
+	}
+	/** Last round : no MixColumns */
+	p_rk += 4;
+	for( i = 0;i < 4;i++ )
+	{
+		t[i] = ( ( (uint32_t)slbv_aes_sbox[s[i] >> 24] << 24 ) |
+				( (uint32_t)slbv_aes_sbox[( s[( i + 1 ) & 0x3] >> 16 ) & 0xff] << 16 ) |
+				( (uint32_t)slbv_aes_sbox[( s[( i + 2 ) & 0x3] >> 8 ) & 0xff] << 8 ) |
+				(uint32_t)slbv_aes_sbox[s[( i + 3 ) & 0x3] & 0xff] ) ^ p_rk[i];
+		p_out[4 * i] = (uint8_t)( t[i] >> 24 );
+		p_out[( 4 * i ) + 1] = (uint8_t)( t[i] >> 16 );
+		p_out[( 4 * i ) + 2] = (uint8_t)( t[i] >> 8 );
+		p_out[( 4 * i ) + 3] = (uint8_t)t[i];
+	}
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+/** Counter is big endian and updated, so that successive calls chain */
+int_pltfrm slbv_aes_ctr_xcrypt(t_context *p_ctx,
+								t_slbv_aes_ctx *p_aes,
+								uint8_t *p_counter,
+								const uint8_t *p_in,
+								uint8_t *p_out,
+								uint32_t length)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint8_t										keystream[C_SLBV_AES_BLOCK_SIZE];
+	uint32_t									offset;
+	uint32_t									size;
+	uint32_t									i;
+	int32_t										j;
+
+	/** Check input pointer */
+	if( !p_ctx || !p_aes || !p_counter || !p_in || !p_out )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_aes_ctr_xcrypt_out;
+	}
+#if defined(HCA_HAS_AES)
+	/** AES engine of HCA */
+	err = p_ctx->p_metal_sifive_scl->aes_func.setkey((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+														( C_AES128_SIZE == p_aes->key_size ) ? SCL_AES_KEY128 : SCL_AES_KEY256,
+														(const uint64_t*)p_aes->key,
+														SCL_BIG_ENDIAN_MODE,
+														SCL_ENCRYPT);
+	if( SCL_OK == err )
+	{
+		err = p_ctx->p_metal_sifive_scl->aes_func.setiv((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+														(const uint64_t*)p_counter);
+	}
+	if( SCL_OK == err )
+	{
+		err = p_ctx->p_metal_sifive_scl->aes_func.cipher((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+															SCL_AES_CTR,
+															SCL_ENCRYPT,
+															SCL_BIG_ENDIAN_MODE,
+															p_in,
+															length,
+															p_out);
+	}
+	if( SCL_OK != err )
+	{
+		err = N_SLBV_ERR_DECRYPTION_FAILURE;
+		goto slbv_aes_ctr_xcrypt_out;
+	}
+#endif /* HCA_HAS_AES */
+	for( offset = 0;offset < length;offset += size )
+	{
+		size = M_WHOIS_MIN(length - offset, C_SLBV_AES_BLOCK_SIZE);
+#if !defined(HCA_HAS_AES)
+		/** Software T-table kernel */
+		slbv_aes_encrypt_block(p_aes, p_counter, keystream);
+		for( i = 0;i < size;i++ )
+		{
+			p_out[offset + i] = p_in[offset + i] ^ keystream[i];
+		}
+#else
+		(void)keystream;
+		(void)i;
+#endif /* HCA_HAS_AES */
+		/** Increment counter, also done when HCA is used to keep next IV */
+		for( j = ( C_SLBV_AES_BLOCK_SIZE - 1 );j >= 0;j-- )
+		{
+			if( ++p_counter[j] )
+			{
+				break;
+			}
+		}
+	}
+	/** Wipe key stream */
+	memset((void*)keystream, 0x00, sizeof(keystream));
+	/** No error */
+	err = NO_ERROR;
+slbv_aes_ctr_xcrypt_out:
+	/** End Of Function */
+	return err;
+}
+
+#ifndef _WITHOUT_SELFTESTS_
+/******************************************************************************/
+/** Known-answer tests of AES block and AES-CTR, on path used for image decryption */
+int_pltfrm slbv_aes_selftest(t_context *p_ctx)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	t_slbv_aes_ctx								aes;
+	uint8_t										counter[C_SLBV_AES_BLOCK_SIZE];
+	uint8_t										out[4 * C_SLBV_AES_BLOCK_SIZE];
+	uint32_t									i;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_aes_selftest_out;
+	}
+	for( i = 0;i < 2;i++ )
+	{
+#if !defined(HCA_HAS_AES)
+		/** Single block, FIPS-197 */
+		err = slbv_aes_setkey(&aes, slbv_aes_kat_key, ( i ? C_AES256_SIZE : C_AES128_SIZE ));
+		if( err )
+		{
+			goto slbv_aes_selftest_out;
+		}
+		slbv_aes_encrypt_block(&aes, slbv_aes_kat_pt, out);
+		if( memcmp((const void*)out, (const void*)slbv_aes_kat_ct[i], C_SLBV_AES_BLOCK_SIZE) )
+		{
+			err = N_SLBV_ERR_DECRYPTION_FAILURE;
+			goto slbv_aes_selftest_out;
+		}
+#endif /* HCA_HAS_AES */
+		/** CTR mode, SP 800-38A : one block then three, to check counter chaining */
+		err = slbv_aes_setkey(&aes, slbv_aes_ctr_kat_key[i], ( i ? C_AES256_SIZE : C_AES128_SIZE ));
+		if( err )
+		{
+			goto slbv_aes_selftest_out;
+		}
+		memcpy((void*)counter, (const void*)slbv_aes_ctr_kat_counter, sizeof(counter));
+		err = slbv_aes_ctr_xcrypt(p_ctx, &aes, counter, slbv_aes_ctr_kat_pt, out, C_SLBV_AES_BLOCK_SIZE);
+		if( NO_ERROR == err )
+		{
+			err = slbv_aes_ctr_xcrypt(p_ctx,
+										&aes,
+										counter,
+										&slbv_aes_ctr_kat_pt[C_SLBV_AES_BLOCK_SIZE],
+										&out[C_SLBV_AES_BLOCK_SIZE],
+										( sizeof(out) - C_SLBV_AES_BLOCK_SIZE ));
+		}
+		if( err )
+		{
+			goto slbv_aes_selftest_out;
+		}
+		else if( memcmp((const void*)out, (const void*)slbv_aes_ctr_kat_ct[i], sizeof(out)) )
+		{
+			err = N_SLBV_ERR_DECRYPTION_FAILURE;
+			goto slbv_aes_selftest_out;
+		}
+	}
+	/** No error */
+	err = NO_ERROR;
+slbv_aes_selftest_out:
+	/** Wipe key material */
+	memset((void*)&aes, 0x00, sizeof(t_slbv_aes_ctx));
+	/** End Of Function */
+	return err;
+}
+#endif /* _WITHOUT_SELFTESTS_ */
+#endif /* _WITH_SLBV_ENCRYPTED_IMAGE_ */
+
+#ifdef _WITH_SLBV_EMMC_
+/******************************************************************************/
+/** Wait for all 'mask' normal interrupt status bits, then acknowledge them */
+int_pltfrm slbv_emmc_wait_int(volatile t_reg_sdhci *p_reg, uint16_t mask)
+{
+	int_pltfrm 									err = N_SLBV_ERR_EMMC_TROUBLE;
+	uint32_t									timeout = C_SLBV_EMMC_TIMEOUT;
+	uint16_t									status;
+
+	while( timeout-- )
+	{
+		status = p_reg->norm_int_status;
+		if( status & C_SDHCI_INT_ERROR_MASK )
+		{
+			/** Acknowledge everything, command or transfer failed */
+			p_reg->err_int_status = p_reg->err_int_status;
+			p_reg->norm_int_status = status;
+			break;
+		}
+		if( mask == ( status & mask ) )
+		{
+			/** Write 1 to clear */
+			p_reg->norm_int_status = mask;
+			err = NO_ERROR;
+			break;
+		}
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Send command, transfer mode and data registers must be set beforehand */
+int_pltfrm slbv_emmc_cmd(volatile t_reg_sdhci *p_reg, uint32_t index, uint32_t arg, uint16_t flags, uint32_t *p_resp)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint32_t									timeout = C_SLBV_EMMC_TIMEOUT;
+	uint32_t									inhibit = C_SDHCI_PRESENT_CMD_INHIBIT_MASK;
+	uint32_t									i;
+
+	/** Data line is needed for data and busy signaling */
+	if( ( flags & C_SDHCI_CMD_DATA_PRESENT_MASK ) ||
+		( C_SDHCI_CMD_RESP_48_BUSY == ( flags & C_SDHCI_CMD_RESP_48_BUSY ) ) )
+	{
+		inhibit |= C_SDHCI_PRESENT_DAT_INHIBIT_MASK;
+	}
+	while( ( p_reg->present_state & inhibit ) && --timeout );
+	if( !timeout )
+	{
+		err = N_SLBV_ERR_EMMC_TROUBLE;
+		goto slbv_emmc_cmd_out;
+	}
+	p_reg->argument = arg;
+	p_reg->command = (uint16_t)( flags | ( index << C_SDHCI_CMD_INDEX_OFST ) );
+	err = slbv_emmc_wait_int(p_reg, C_SDHCI_INT_CMD_COMPLETE_MASK);
+	if( err )
+	{
+		goto slbv_emmc_cmd_out;
+	}
+	if( p_resp )
+	{
+		/** Long response spans the four registers */
+		for( i = 0;i < ( ( C_SDHCI_CMD_RESP_136 == ( flags & C_SDHCI_CMD_RESP_48_BUSY ) ) ? 4 : 1 );i++ )
+		{
+			p_resp[i] = p_reg->response[i];
+		}
+	}
+	if( C_SDHCI_CMD_RESP_48_BUSY == ( flags & C_SDHCI_CMD_RESP_48_BUSY ) )
+	{
+		/** Wait for end of busy */
+		err = slbv_emmc_wait_int(p_reg, C_SDHCI_INT_XFER_COMPLETE_MASK);
+	}
+slbv_emmc_cmd_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Program closest bus clock not above requested one */
+int_pltfrm slbv_emmc_set_clock(volatile t_reg_sdhci *p_reg, uint32_t khz)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint32_t									base_khz;
+	uint32_t									div = 0;
+	uint32_t									timeout = C_SLBV_EMMC_TIMEOUT;
+
+	/** Base clock in MHz */
+	base_khz = ( ( p_reg->capabilities[0] & C_SDHCI_CAPS0_BASE_CLK_MASK ) >> C_SDHCI_CAPS0_BASE_CLK_OFST ) * C_GENERIC_KILO;
+	if( !base_khz || !khz )
+	{
+		err = N_SLBV_ERR_NO_INTERFACE_EMMC;
+		goto slbv_emmc_set_clock_out;
+	}
+	/** Fsd = Fbase / ( 2 * div ), div = 0 meaning Fbase */
+	if( base_khz > khz )
+	{
+		div = ( base_khz + ( 2 * khz ) - 1 ) / ( 2 * khz );
+		div = ( C_SDHCI_CLOCK_DIV_MAX < div ) ? C_SDHCI_CLOCK_DIV_MAX : div;
+	}
+	/** Stop clock before changing it */
+	p_reg->clock_ctrl = 0;
+	p_reg->clock_ctrl = (uint16_t)( ( ( div & 0xff ) << C_SDHCI_CLOCK_DIV_LOW_OFST ) |
+									( ( ( div >> 8 ) & 0x3 ) << C_SDHCI_CLOCK_DIV_HIGH_OFST ) |
+									C_SDHCI_CLOCK_INT_EN_MASK );
+	while( !( p_reg->clock_ctrl & C_SDHCI_CLOCK_INT_STABLE_MASK ) && --timeout );
+	if( !timeout )
+	{
+		err = N_SLBV_ERR_EMMC_TROUBLE;
+		goto slbv_emmc_set_clock_out;
+	}
+	p_reg->clock_ctrl |= C_SDHCI_CLOCK_SD_EN_MASK;
+	/** No error */
+	err = NO_ERROR;
+slbv_emmc_set_clock_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Write one EXT_CSD byte then wait for device to be ready again */
+int_pltfrm slbv_emmc_switch(volatile t_reg_sdhci *p_reg, uint32_t index, uint32_t value)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint32_t									status = 0;
+	uint32_t									retries = C_SLBV_EMMC_OCR_RETRIES;
+
+	err = slbv_emmc_cmd(p_reg, C_SLBV_EMMC_CMD_SWITCH, M_SLBV_EMMC_SWITCH_ARG(index, value), C_SLBV_EMMC_RESP_R1B, &status);
+	while( ( NO_ERROR == err ) && retries-- )
+	{
+		err = slbv_emmc_cmd(p_reg, C_SLBV_EMMC_CMD_SEND_STATUS, ( C_SLBV_EMMC_RCA << 16 ), C_SLBV_EMMC_RESP_R1, &status);
+		if( ( NO_ERROR == err ) && ( status & C_SLBV_EMMC_STATUS_SWITCH_ERROR_MASK ) )
+		{
+			/** Device refused */
+			err = N_SLBV_ERR_EMMC_TROUBLE;
+		}
+		else if( ( NO_ERROR == err ) && ( status & C_SLBV_EMMC_STATUS_READY_MASK ) )
+		{
+			break;
+		}
+	}
+	if( ( NO_ERROR == err ) && !( status & C_SLBV_EMMC_STATUS_READY_MASK ) )
+	{
+		err = N_SLBV_ERR_EMMC_TROUBLE;
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Read blocks with ADMA2, one descriptor chain per command */
+int_pltfrm slbv_emmc_read(volatile t_reg_sdhci *p_reg, uint32_t lba, uint32_t nb_blocks, uint_pltfrm dst, uint16_t cmd_index)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint32_t									chunk;
+	uint32_t									remain;
+	uint32_t									length;
+	uint32_t									i;
+
+	/** Check input pointer */
+	if( !p_reg || !dst )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_emmc_read_out;
+	}
+	else if( ( ( (uint64_t)dst + ( (uint64_t)nb_blocks * C_SLBV_EMMC_BLOCK_SIZE ) ) > C_SLBV_EMMC_ADMA2_ADDR_LIMIT ) ||
+			( ( (uint64_t)(uint_pltfrm)slbv_emmc_adma2_desc + sizeof(slbv_emmc_adma2_desc) ) > C_SLBV_EMMC_ADMA2_ADDR_LIMIT ) )
+	{
+		/** 32 bits descriptors can not reach it */
+		err = N_SLBV_ERR_NOT_IN_RANGE;
+		goto slbv_emmc_read_out;
+	}
+	/** Nothing to do yet */
+	err = NO_ERROR;
+	while( nb_blocks )
+	{
+		/** As many blocks as one chain can carry */
+		chunk = ( C_SLBV_EMMC_ADMA2_DESC_NB * C_SDHCI_ADMA2_LENGTH_MAX ) / C_SLBV_EMMC_BLOCK_SIZE;
+		chunk = ( nb_blocks < chunk ) ? nb_blocks : chunk;
+		/** Build chain */
+		remain = chunk * C_SLBV_EMMC_BLOCK_SIZE;
+		for( i = 0;remain;i++ )
+		{
+			length = ( C_SDHCI_ADMA2_LENGTH_MAX < remain ) ? C_SDHCI_ADMA2_LENGTH_MAX : remain;
+			slbv_emmc_adma2_desc[i].attr = C_SDHCI_ADMA2_VALID | C_SDHCI_ADMA2_ACT_TRAN;
+			slbv_emmc_adma2_desc[i].length = (uint16_t)length;
+			slbv_emmc_adma2_desc[i].address = (uint32_t)dst;
+			dst += length;
+			remain -= length;
+		}
+		slbv_emmc_adma2_desc[i - 1].attr |= C_SDHCI_ADMA2_END;
+		M_FENCE_RW();
+		/** Program transfer */
+		p_reg->adma_addr_lo = (uint32_t)(uint_pltfrm)slbv_emmc_adma2_desc;
+		p_reg->adma_addr_hi = 0;
+		p_reg->blksize = C_SLBV_EMMC_BLOCK_SIZE;
+		p_reg->blkcnt = (uint16_t)chunk;
+		if( C_SLBV_EMMC_CMD_READ_MULTIPLE == cmd_index )
+		{
+			/** Stop transmission is sent by controller */
+			p_reg->xfer_mode = C_SDHCI_XFER_DMA_EN_MASK | C_SDHCI_XFER_BLKCNT_EN_MASK | C_SDHCI_XFER_AUTO_CMD12_MASK |
+								C_SDHCI_XFER_READ_MASK | C_SDHCI_XFER_MULTI_BLOCK_MASK;
+		}
+		else
+		{
+			/** Single block command (EXT_CSD) */
+			p_reg->xfer_mode = C_SDHCI_XFER_DMA_EN_MASK | C_SDHCI_XFER_READ_MASK;
+		}
+		err = slbv_emmc_cmd(p_reg, cmd_index, lba, C_SLBV_EMMC_RESP_R1 | C_SDHCI_CMD_DATA_PRESENT_MASK, NULL);
+		if( NO_ERROR == err )
+		{
+			err = slbv_emmc_wait_int(p_reg, C_SDHCI_INT_XFER_COMPLETE_MASK);
+		}
+		if( err )
+		{
+			break;
+		}
+		lba += chunk;
+		nb_blocks -= chunk;
+	}
+	M_FENCE_RW();
+slbv_emmc_read_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** HS200 sampling point tuning */
+int_pltfrm slbv_emmc_tune(volatile t_reg_sdhci *p_reg)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint32_t									i;
+	uint32_t									j;
+	volatile uint32_t							tmp;
+
+	p_reg->host_ctrl2 |= C_SDHCI_HOST_CTRL2_EXEC_TUNING_MASK;
+	for( i = 0;i < C_SLBV_EMMC_TUNING_RETRIES;i++ )
+	{
+		p_reg->blksize = C_SLBV_EMMC_TUNING_BLOCK_SIZE;
+		p_reg->blkcnt = 1;
+		p_reg->xfer_mode = C_SDHCI_XFER_READ_MASK;
+		err = slbv_emmc_cmd(p_reg, C_SLBV_EMMC_CMD_SEND_TUNING, 0, C_SLBV_EMMC_RESP_R1 | C_SDHCI_CMD_DATA_PRESENT_MASK, NULL);
+		if( NO_ERROR == err )
+		{
+			err = slbv_emmc_wait_int(p_reg, C_SDHCI_INT_BUF_READ_READY_MASK);
+		}
+		if( err )
+		{
+			break;
+		}
+		/** Drain tuning block */
+		for( j = 0;j < ( C_SLBV_EMMC_TUNING_BLOCK_SIZE / sizeof(uint32_t) );j++ )
+		{
+			tmp = p_reg->buffer;
+		}
+		(void)tmp;
+		if( !( p_reg->host_ctrl2 & C_SDHCI_HOST_CTRL2_EXEC_TUNING_MASK ) )
+		{
+			/** Controller is done */
+			break;
+		}
+	}
+	if( ( NO_ERROR == err ) &&
+		( ( p_reg->host_ctrl2 & C_SDHCI_HOST_CTRL2_EXEC_TUNING_MASK ) ||
+		!( p_reg->host_ctrl2 & C_SDHCI_HOST_CTRL2_SAMPLING_CLK_MASK ) ) )
+	{
+		/** No valid sampling point */
+		err = N_SLBV_ERR_EMMC_TROUBLE;
+	}
+	if( err )
+	{
+		p_reg->host_ctrl2 &= ~( C_SDHCI_HOST_CTRL2_EXEC_TUNING_MASK | C_SDHCI_HOST_CTRL2_SAMPLING_CLK_MASK );
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Controller reset and card back to idle state : card then needs CMD1 polling */
+int_pltfrm slbv_emmc_init_start(t_context *p_ctx)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	volatile t_reg_sdhci						*p_reg;
+	uint32_t									timeout = C_SLBV_EMMC_TIMEOUT;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_emmc_init_start_out;
+	}
+	slbv_context.emmc.ready = FALSE;
+	/** Controller may have been set elsewhere (simulation) */
+	if( !slbv_context.emmc.p_reg )
+	{
+		slbv_context.emmc.p_reg = (volatile t_reg_sdhci*)C_SLBV_EMMC_CTRL_BASE_ADDR;
+	}
+	p_reg = slbv_context.emmc.p_reg;
+	if( !( p_reg->capabilities[0] & C_SDHCI_CAPS0_ADMA2_MASK ) )
+	{
+		err = N_SLBV_ERR_NO_INTERFACE_EMMC;
+		goto slbv_emmc_init_start_out;
+	}
+	/** Reset controller */
+	p_reg->sw_reset = C_SDHCI_RESET_ALL_MASK;
+	while( ( p_reg->sw_reset & C_SDHCI_RESET_ALL_MASK ) && --timeout );
+	if( !timeout )
+	{
+		err = N_SLBV_ERR_EMMC_TROUBLE;
+		goto slbv_emmc_init_start_out;
+	}
+	/** Polled mode : status enabled, no signal */
+	p_reg->norm_int_status_en = 0xffff;
+	p_reg->err_int_status_en = 0xffff;
+	p_reg->norm_int_signal_en = 0;
+	p_reg->err_int_signal_en = 0;
+	p_reg->power_ctrl = C_SDHCI_POWER_3V3_ON;
+	p_reg->timeout_ctrl = 0xe;
+	p_reg->host_ctrl1 = ( C_SDHCI_HOST_CTRL1_DMA_ADMA2_32 << C_SDHCI_HOST_CTRL1_DMA_OFST ) & C_SDHCI_HOST_CTRL1_DMA_MASK;
+	err = slbv_emmc_set_clock(p_reg, C_SLBV_EMMC_CLK_IDENT_KHZ);
+	if( err )
+	{
+		goto slbv_emmc_init_start_out;
+	}
+	/** Identification */
+	err = slbv_emmc_cmd(p_reg, C_SLBV_EMMC_CMD_GO_IDLE, 0, C_SLBV_EMMC_RESP_NONE, NULL);
+slbv_emmc_init_start_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** One CMD1 : card tells whether its power up is over */
+int_pltfrm slbv_emmc_init_poll(t_context *p_ctx, uint8_t *p_ready)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint32_t									resp[4] = { 0 };
+
+	/** Check input pointer */
+	if( !p_ctx || !p_ready || !slbv_context.emmc.p_reg )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+		err = slbv_emmc_cmd(slbv_context.emmc.p_reg, C_SLBV_EMMC_CMD_SEND_OP_COND, C_SLBV_EMMC_OCR_ARG, C_SLBV_EMMC_RESP_R3, resp);
+		*p_ready = ( ( NO_ERROR == err ) && ( resp[0] & C_SLBV_EMMC_OCR_READY_MASK ) ) ? TRUE : FALSE;
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Card is powered up : addressing, bus width, bus speed and boot partition */
+int_pltfrm slbv_emmc_init_finish(t_context *p_ctx)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	volatile t_reg_sdhci						*p_reg;
+	uint32_t									resp[4] = { 0 };
+	uint8_t										part_cfg;
+	uint8_t										boot_enable;
+
+	/** Check input pointer */
+	if( !p_ctx || !slbv_context.emmc.p_reg )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_emmc_init_finish_out;
+	}
+	p_reg = slbv_context.emmc.p_reg;
+	err = slbv_emmc_cmd(p_reg, C_SLBV_EMMC_CMD_ALL_SEND_CID, 0, C_SLBV_EMMC_RESP_R2, resp);
+	if( NO_ERROR == err )
+	{
+		err = slbv_emmc_cmd(p_reg, C_SLBV_EMMC_CMD_SET_RCA, ( C_SLBV_EMMC_RCA << 16 ), C_SLBV_EMMC_RESP_R1, resp);
+	}
+	if( NO_ERROR == err )
+	{
+		err = slbv_emmc_cmd(p_reg, C_SLBV_EMMC_CMD_SELECT, ( C_SLBV_EMMC_RCA << 16 ), C_SLBV_EMMC_RESP_R1B, resp);
+	}
+	if( NO_ERROR == err )
+	{
+		/** Device capabilities and boot configuration */
+		err = slbv_emmc_read(p_reg, 0, 1, (uint_pltfrm)slbv_emmc_ext_csd, C_SLBV_EMMC_CMD_SEND_EXT_CSD);
+	}
+	if( NO_ERROR == err )
+	{
+		/** 8 bits bus */
+		err = slbv_emmc_switch(p_reg, C_SLBV_EMMC_EXT_CSD_BUS_WIDTH, C_SLBV_EMMC_BUS_WIDTH_8);
+	}
+	if( err )
+	{
+		goto slbv_emmc_init_finish_out;
+	}
+	p_reg->host_ctrl1 |= C_SDHCI_HOST_CTRL1_8BIT_MASK;
+	/** HS200 needs 1.8V I/O on both sides */
+	slbv_context.emmc.hs200 = FALSE;
+	if( ( TRUE == C_SLBV_EMMC_VCCQ_1V8 ) &&
+		( slbv_emmc_ext_csd[C_SLBV_EMMC_EXT_CSD_DEVICE_TYPE] & C_SLBV_EMMC_DEVICE_TYPE_HS200_1V8 ) &&
+		( p_reg->capabilities[1] & C_SDHCI_CAPS1_SDR104_MASK ) )
+	{
+		err = slbv_emmc_switch(p_reg, C_SLBV_EMMC_EXT_CSD_HS_TIMING, C_SLBV_EMMC_HS_TIMING_HS200);
+		if( NO_ERROR == err )
+		{
+			p_reg->host_ctrl2 = ( p_reg->host_ctrl2 & ~C_SDHCI_HOST_CTRL2_UHS_MASK ) |
+								C_SDHCI_HOST_CTRL2_UHS_SDR104 | C_SDHCI_HOST_CTRL2_1V8_MASK;
+			err = slbv_emmc_set_clock(p_reg, C_SLBV_EMMC_CLK_HS200_KHZ);
+		}
+		if( NO_ERROR == err )
+		{
+			err = slbv_emmc_tune(p_reg);
+		}
+		if( NO_ERROR == err )
+		{
+			slbv_context.emmc.hs200 = TRUE;
+		}
+		else
+		{
+			/** Back to identification clock before falling back on HS */
+			p_reg->host_ctrl2 &= ~C_SDHCI_HOST_CTRL2_UHS_MASK;
+			slbv_emmc_set_clock(p_reg, C_SLBV_EMMC_CLK_IDENT_KHZ);
+		}
+	}
+	if( FALSE == slbv_context.emmc.hs200 )
+	{
+		/** High speed, 52MHz */
+		err = slbv_emmc_switch(p_reg, C_SLBV_EMMC_EXT_CSD_HS_TIMING, C_SLBV_EMMC_HS_TIMING_HS);
+		if( NO_ERROR == err )
+		{
+			p_reg->host_ctrl1 |= C_SDHCI_HOST_CTRL1_HIGH_SPEED_MASK;
+			err = slbv_emmc_set_clock(p_reg, C_SLBV_EMMC_CLK_HS_KHZ);
+		}
+		if( err )
+		{
+			goto slbv_emmc_init_finish_out;
+		}
+	}
+	/** Read from boot partition enabled for boot, user area otherwise */
+	part_cfg = slbv_emmc_ext_csd[C_SLBV_EMMC_EXT_CSD_PARTITION_CONFIG];
+	boot_enable = ( part_cfg >> C_SLBV_EMMC_PART_CFG_ENABLE_OFST ) & C_SLBV_EMMC_PART_CFG_ENABLE_MASK_NOOFST;
+	if( ( 1 == boot_enable ) || ( 2 == boot_enable ) )
+	{
+		slbv_context.emmc.partition_size = (uint32_t)slbv_emmc_ext_csd[C_SLBV_EMMC_EXT_CSD_BOOT_SIZE_MULT] * C_SLBV_EMMC_BOOT_SIZE_UNIT;
+	}
+	else
+	{
+		/** User area, size is bounded by staging area only */
+		boot_enable = 0;
+		slbv_context.emmc.partition_size = 0;
+	}
+	err = slbv_emmc_switch(p_reg,
+							C_SLBV_EMMC_EXT_CSD_PARTITION_CONFIG,
+							( part_cfg & ~C_SLBV_EMMC_PART_CFG_ACCESS_MASK ) | boot_enable);
+	if( NO_ERROR == err )
+	{
+		/** Card can be read */
+		slbv_context.emmc.ready = TRUE;
+	}
+slbv_emmc_init_finish_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Identify device, switch to 8 bits HS200 (or HS) and select boot partition */
+int_pltfrm slbv_emmc_init(t_context *p_ctx)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	uint32_t									retries = C_SLBV_EMMC_OCR_RETRIES;
+	uint8_t										ready = FALSE;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_emmc_init_out;
+	}
+	err = slbv_emmc_init_start(p_ctx);
+	while( ( NO_ERROR == err ) && ( FALSE == ready ) && retries-- )
+	{
+		err = slbv_emmc_init_poll(p_ctx, &ready);
+	}
+	if( ( NO_ERROR == err ) && ( FALSE == ready ) )
+	{
+		/** Device never left busy state */
+		err = N_SLBV_ERR_EMMC_TROUBLE;
+	}
+	if( NO_ERROR == err )
+	{
+		err = slbv_emmc_init_finish(p_ctx);
+	}
+slbv_emmc_init_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+/** Stage signed image in RAM : header block first, then its signed length only */
+int_pltfrm slbv_emmc_load(t_context *p_ctx, uint_pltfrm dst, uint32_t dst_size)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+	volatile t_secure_header					*p_hdr = (volatile t_secure_header*)dst;
+	uint32_t									nb_blocks;
+
+	/** Check input pointer */
+	if( !p_ctx || !dst )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto slbv_emmc_load_out;
+	}
+	else if( C_SLBV_EMMC_BLOCK_SIZE > dst_size )
+	{
+		err = N_SLBV_ERR_NOT_IN_RANGE;
+		goto slbv_emmc_load_out;
+	}
+	if( FALSE == slbv_context.emmc.ready )
+	{
+		/** Not already initialized by boot device probing */
+		err = slbv_emmc_init(p_ctx);
+		if( err )
+		{
+			goto slbv_emmc_load_out;
+		}
+	}
+	err = slbv_emmc_read(slbv_context.emmc.p_reg, 0, 1, dst, C_SLBV_EMMC_CMD_READ_MULTIPLE);
+	if( err )
+	{
+		goto slbv_emmc_load_out;
+	}
+	if( ( C_SFLV_MAGIC_WORD1 != p_hdr->magic_word1 ) ||
+		( C_SFLV_MAGIC_WORD2 != p_hdr->magic_word2 ) )
+	{
+		/** Synchronization pattern(s), no match */
+		err = N_SLBV_ERR_SYNC_PTRN_FAILURE;
+		goto slbv_emmc_load_out;
+	}
+	/** Image is read by whole blocks : they must fit in partition and staging area */
+	nb_blocks = (uint32_t)( ( (uint64_t)p_hdr->secure_appli_image_size + C_SLBV_EMMC_BLOCK_SIZE - 1 ) / C_SLBV_EMMC_BLOCK_SIZE );
+	if( ( dst_size < ( (uint64_t)nb_blocks * C_SLBV_EMMC_BLOCK_SIZE ) ) ||
+		( slbv_context.emmc.partition_size && ( slbv_context.emmc.partition_size < ( (uint64_t)nb_blocks * C_SLBV_EMMC_BLOCK_SIZE ) ) ) )
+	{
+		err = N_SLBV_ERR_NOT_IN_RANGE;
+		goto slbv_emmc_load_out;
+	}
+	if( 1 < nb_blocks )
+	{
+		err = slbv_emmc_read(slbv_context.emmc.p_reg, 1, nb_blocks - 1, dst + C_SLBV_EMMC_BLOCK_SIZE, C_SLBV_EMMC_CMD_READ_MULTIPLE);
+		if( err )
+		{
+			goto slbv_emmc_load_out;
+		}
+	}
+	slbv_context.emmc.size = nb_blocks * C_SLBV_EMMC_BLOCK_SIZE;
+	slbv_context.emmc.loaded = TRUE;
+slbv_emmc_load_out:
+	/** End Of Function */
+	return err;
+}
+#endif /* _WITH_SLBV_EMMC_ */
+
+#if defined(_WITH_SLBV_INCREMENTAL_) || defined(_WITH_SLBV_WARM_RESET_)
+/******************************************************************************/
+/** SipHash-2-4 over ( prefix || data ) - little endian words, as on RISC-V */
+uint64_t slbv_siphash(const uint8_t *p_key, uint64_t prefix, const uint8_t *p_data, uint32_t length)
+{
+	uint64_t									k0;
+	uint64_t									k1;
+	uint64_t									v0;
+	uint64_t									v1;
+	uint64_t									v2;
+	uint64_t									v3;
+	uint64_t									m;
+	uint32_t									i;
+	uint32_t									j;
+	uint32_t									r;
+
+	/** Initialization */
+	memcpy((void*)&k0, (const void*)p_key, sizeof(uint64_t));
+	memcpy((void*)&k1, (const void*)( p_key + sizeof(uint64_t) ), sizeof(uint64_t));
+	v0 = k0 ^ 0x736f6d6570736575ULL;
+	v1 = k1 ^ 0x646f72616e646f6dULL;
+	v2 = k0 ^ 0x6c7967656e657261ULL;
+	v3 = k1 ^ 0x7465646279746573ULL;
+	/** Prefix is first message word, then full data words */
+	m = prefix;
+	i = 0;
+	do
+	{
+		v3 ^= m;
+		for( r = 0;r < C_SLBV_SIPHASH_C_ROUNDS;r++ )
+		{
+			M_SLBV_SIPROUND(v0, v1, v2, v3);
+		}
+		v0 ^= m;
+		if( ( i + sizeof(uint64_t) ) > length )
+		{
+			break;
+		}
+		memcpy((void*)&m, (const void*)( p_data + i ), sizeof(uint64_t));
+		i += sizeof(uint64_t);
+	} while( 1 );
+	/** Last word : remaining bytes, and message length in most significant byte */
+	m = (uint64_t)( ( length + sizeof(uint64_t) ) & 0xff ) << 56;
+	for( j = 0;i < length;i++, j += 8 )
+	{
+		m |= (uint64_t)p_data[i] << j;
+	}
+	v3 ^= m;
+	for( r = 0;r < C_SLBV_SIPHASH_C_ROUNDS;r++ )
+	{
+		M_SLBV_SIPROUND(v0, v1, v2, v3);
+	}
+	v0 ^= m;
+	/** Finalization */
+	v2 ^= 0xff;
+	for( r = 0;r < C_SLBV_SIPHASH_D_ROUNDS;r++ )
+	{
+		M_SLBV_SIPROUND(v0, v1, v2, v3);
+	}
+	/** End Of Function */
+	return ( v0 ^ v1 ^ v2 ^ v3 );
+}
+#endif /* _WITH_SLBV_INCREMENTAL_ || _WITH_SLBV_WARM_RESET_ */
+
 /******************************************************************************/
 
 /** End Of File */
@@ -99,6 +99,8 @@ int_pltfrm sp_init(void *p_ctx, void *p_in, uint32_t length_in)
 		sp_context.csk_last_slot = FALSE;
 		/** Local context structure assignment */
 		p_context->p_sp_context = (volatile void*)&sp_context;
+		/** Fill ROM services table for applets */
+		sp_rom_services_init(p_context);
 		/** Initialization of communication structure */
 		/** Initialization of port structure */
 		sp_context.port.uart.uart0 = (struct metal_uart *)metal_uart_get_device(C_SP_SUP_BUS_UART_ID);
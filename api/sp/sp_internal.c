@@ -53,6 +53,7 @@
 #include <km.h>
 #include <sbrm_internal.h>
 #include <sbrm.h>
+#include <slbv.h>
 #include <sp.h>
 #include <sp_internal.h>
 
@@ -61,11 +62,58 @@ extern t_context context;
 extern char __sbrm_free_start_addr;
 extern char __sbrm_free_end_addr;
 /** Local declarations */
+#ifdef _WITH_SUP_FRAGMENTATION_
+/** Applet area stops where fragment reassembly arena starts */
+#define	M_SP_APPLET_AREA_END()					( (uint_pltfrm)&__sbrm_free_end_addr - C_SP_SUP_FRAG_ARENA_SIZE )
+#else
+#define	M_SP_APPLET_AREA_END()					( (uint_pltfrm)&__sbrm_free_end_addr )
+#endif /* _WITH_SUP_FRAGMENTATION_ */
 __attribute__((section(".bss"))) t_sp_context sp_context;
 /** Array for key buffer
 * Size is Old CSK descriptor + Old CSK size max + CSK Descriptor + CSK size Max + CSK sign size max */
+#ifdef _WITH_SBRM_PROFILING_
+/** GETINFO response, built in same buffer, carries boot-time profile */
+__attribute__((section(".bss"))) uint8_t work_buf[M_WHOIS_MAX(M_WHOIS_MAX(C_KM_KEY_BUFFER_MAX_SIZE, sizeof(t_cmd_csk)), sizeof(t_getinfo_template))];
+#else
 __attribute__((section(".bss"))) uint8_t work_buf[M_WHOIS_MAX(C_KM_KEY_BUFFER_MAX_SIZE, sizeof(t_cmd_csk))];
+#endif /* _WITH_SBRM_PROFILING_ */
+/** ROM services given to SUP applets */
+__attribute__((section(".bss"))) t_sp_rom_services sp_rom_services;
+#ifdef _WITH_SUP_BATCH_
+/** Batch command payload and combined response buffers */
+__attribute__((section(".bss"), aligned(sizeof(uint32_t)))) uint8_t batch_buf[C_SP_SUP_BATCH_BUFFER_SIZE];
+__attribute__((section(".bss"), aligned(sizeof(uint32_t)))) uint8_t batch_rsp_buf[C_SP_SUP_BATCH_RSP_BUFFER_SIZE];
+#endif /* _WITH_SUP_BATCH_ */
 
+/** Transports */
+const t_sp_transport sp_transport_uart =
+{
+	.initialize_fct = sp_uart_initialize,
+	.receive_fct = sp_uart_receive_buffer,
+	.send_fct = sp_uart_send_buffer,
+	.stop_rx_fct = sp_uart_stop_rx,
+	.close_fct = sp_uart_close,
+};
+#ifdef _WITH_SUP_SPI_SLAVE_
+const t_sp_transport sp_transport_spis =
+{
+	.initialize_fct = sp_spis_initialize,
+	.receive_fct = sp_spis_receive_buffer,
+	.send_fct = sp_spis_send_buffer,
+	.stop_rx_fct = sp_spis_stop_rx,
+	.close_fct = sp_spis_close,
+};
+#endif /* _WITH_SUP_SPI_SLAVE_ */
+#ifdef _WITH_SUP_LOOPBACK_
+const t_sp_transport sp_transport_loopback =
+{
+	.initialize_fct = sp_loopback_initialize,
+	.receive_fct = sp_loopback_receive_buffer,
+	.send_fct = sp_loopback_send_buffer,
+	.stop_rx_fct = sp_loopback_stop_rx,
+	.close_fct = sp_loopback_close,
+};
+#endif /* _WITH_SUP_LOOPBACK_ */
 
 /** UART **********************************************************************/
 void sp_uart_isr(int32_t id, void *data)
@@ -298,6 +346,378 @@ sp_uart_send_buffer_out:
 	return err;
 }
 
+/******************************************************************************/
+int_pltfrm sp_uart_initialize(t_context *p_ctx)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+		/** Set baudrate */
+		metal_uart_init(sp_context.port.uart.uart0, sp_context.port.config[C_SP_SUP_PORT_CONF_BAUDRATE_OFST]);
+		err = NO_ERROR;
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+void sp_uart_stop_rx(t_context *p_ctx)
+{
+	/** Disable UART interruption */
+	M_UART_MASK_RX_IRQ(sp_context.port.uart.reg_uart);
+	/** Disable UART's RX */
+	M_UART_RX_DISABLE(sp_context.port.uart.reg_uart);
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+void sp_uart_close(t_context *p_ctx)
+{
+	/** Disable interruptions */
+	M_UART_MASK_RX_IRQ(sp_context.port.uart.reg_uart);
+	M_UART_MASK_TX_IRQ(sp_context.port.uart.reg_uart);
+	/** Disable RX and TX */
+	M_UART_RX_DISABLE(sp_context.port.uart.reg_uart);
+	M_UART_TX_DISABLE(sp_context.port.uart.reg_uart);
+	/** End Of Function */
+	return;
+}
+
+#ifdef _WITH_SUP_SPI_SLAVE_
+/** SPI slave *****************************************************************/
+int_pltfrm sp_spis_initialize(t_context *p_ctx)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+		/** Clock is given by Host, thus no baudrate to set */
+		sp_context.port.spis.reg_spis = (volatile t_reg_spis*)C_SP_SPIS_BASE_ADDR;
+		/** Select mode then enable */
+		sp_context.port.spis.reg_spis->ctrl = ( ( C_SP_SPIS_DEFAULT_MODE << C_SPIS_CTRL_MODE_OFST ) & C_SPIS_CTRL_MODE_MASK );
+		sp_context.port.spis.reg_spis->ctrl |= C_SPIS_CTRL_EN_MASK;
+		err = NO_ERROR;
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm sp_spis_receive_buffer(t_context *p_ctx, uint8_t *p_data, uint32_t *p_size)
+{
+	register uint32_t							tmp_rx;
+	uint32_t									i = 0;
+	uint32_t									loop = 0;
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointers */
+	if( !p_data || !p_ctx || !p_size )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else if( !*p_size )
+	{
+		/** Input size is null */
+		err = GENERIC_ERR_INVAL;
+	}
+	else
+	{
+		/** Poll RX FIFO - at tens of MHz, interruption per watermark costs more than polling */
+		while( ( i < *p_size ) && ( C_SP_SPIS_TIMEOUT_LOOP_NB > loop ) )
+		{
+			tmp_rx = sp_context.port.spis.reg_spis->rx;
+			if( tmp_rx & C_SPIS_RXDATA_EMPTY_MASK )
+			{
+				/** Nothing in FIFO yet */
+				loop++;
+			}
+			else
+			{
+				/** Get data */
+				p_data[i++] = (uint8_t)( tmp_rx & C_SPIS_RXDATA_DATA_MASK );
+				loop = 0;
+			}
+		}
+		if( i != *p_size )
+		{
+			/** Host stopped clocking */
+			err = N_SP_ERR_SUP_CNX_TIMEOUT;
+		}
+		else
+		{
+			/** No error */
+			err = NO_ERROR;
+		}
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm sp_spis_send_buffer(t_context *p_ctx, uint8_t *p_data, uint32_t size)
+{
+	uint32_t									i = 0;
+	uint32_t									loop = 0;
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointers */
+	if( !p_ctx || !p_data )
+	{
+		/** Pointers should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else if( !size )
+	{
+		/** Size should not be null */
+		err = GENERIC_ERR_INVAL;
+	}
+	else
+	{
+		/** Tell Host that response is available */
+		sp_context.port.spis.reg_spis->ctrl |= C_SPIS_CTRL_READY_MASK;
+		/** Fill TX FIFO as Host clocks data out */
+		while( ( i < size ) && ( C_SP_SPIS_TIMEOUT_LOOP_NB > loop ) )
+		{
+			if( sp_context.port.spis.reg_spis->tx & C_SPIS_TXDATA_FULL_MASK )
+			{
+				/** FIFO is full */
+				loop++;
+			}
+			else
+			{
+				sp_context.port.spis.reg_spis->tx = (uint32_t)p_data[i++];
+				loop = 0;
+			}
+		}
+		/** Release ready line */
+		sp_context.port.spis.reg_spis->ctrl &= ~C_SPIS_CTRL_READY_MASK;
+		if( i != size )
+		{
+			/** Not all of the characters have been sent */
+			err = N_SP_ERR_SUP_TX_COMMUNICATION_FAILURE;
+		}
+		else
+		{
+			/** All characters have been sent */
+			err = NO_ERROR;
+		}
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+void sp_spis_stop_rx(t_context *p_ctx)
+{
+	/** Nothing to do, reception is polled */
+	return;
+}
+
+/******************************************************************************/
+void sp_spis_close(t_context *p_ctx)
+{
+	/** Disable controller */
+	sp_context.port.spis.reg_spis->ctrl &= ~( C_SPIS_CTRL_EN_MASK | C_SPIS_CTRL_READY_MASK );
+	/** End Of Function */
+	return;
+}
+#endif /* _WITH_SUP_SPI_SLAVE_ */
+
+#ifdef _WITH_SUP_LOOPBACK_
+/** Host loopback *************************************************************/
+int_pltfrm sp_loopback_initialize(t_context *p_ctx)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+		/** Clear captured data, RX data is kept as Host may have fed it already */
+		sp_context.port.loopback.tx_size = 0;
+		err = NO_ERROR;
+#ifdef _HOST_NATIVE_
+		if( !sp_context.port.loopback.rx_lasting )
+		{
+			/** Host build : data comes from pipe given to the process */
+			sp_context.port.loopback.rx_lasting = metal_host_uart_rx(&sp_context.port.loopback.p_rx);
+		}
+#endif /* _HOST_NATIVE_ */
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm sp_loopback_feed(uint8_t *p_data, uint32_t size)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointer */
+	if( !p_data && size )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+		/** Data will be consumed by next receptions */
+		sp_context.port.loopback.p_rx = p_data;
+		sp_context.port.loopback.rx_lasting = size;
+		err = NO_ERROR;
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm sp_loopback_get_tx(uint8_t **p_data, uint32_t *p_size)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointers */
+	if( !p_data || !p_size )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+		/** Give captured data */
+		*p_data = sp_context.port.loopback.tx_buf;
+		*p_size = sp_context.port.loopback.tx_size;
+		err = NO_ERROR;
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm sp_loopback_receive_buffer(t_context *p_ctx, uint8_t *p_data, uint32_t *p_size)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointers */
+	if( !p_data || !p_ctx || !p_size )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else if( !*p_size )
+	{
+		/** Input size is null */
+		err = GENERIC_ERR_INVAL;
+	}
+	else if( sp_context.port.loopback.rx_lasting < *p_size )
+	{
+		/** Host did not feed enough data, same as a lost connection */
+		err = N_SP_ERR_SUP_CNX_TIMEOUT;
+	}
+	else
+	{
+		/** Consume fed data */
+		memcpy((void*)p_data, (const void*)sp_context.port.loopback.p_rx, *p_size);
+		sp_context.port.loopback.p_rx += *p_size;
+		sp_context.port.loopback.rx_lasting -= *p_size;
+		err = NO_ERROR;
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm sp_loopback_send_buffer(t_context *p_ctx, uint8_t *p_data, uint32_t size)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointers */
+	if( !p_ctx || !p_data )
+	{
+		/** Pointers should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else if( !size )
+	{
+		/** Size should not be null */
+		err = GENERIC_ERR_INVAL;
+	}
+	else if( ( sizeof(sp_context.port.loopback.tx_buf) - sp_context.port.loopback.tx_size ) < size )
+	{
+		/** Capture buffer is full */
+		err = N_SP_ERR_SUP_TX_COMMUNICATION_FAILURE;
+	}
+	else
+	{
+		/** Capture data */
+		memcpy((void*)&sp_context.port.loopback.tx_buf[sp_context.port.loopback.tx_size], (const void*)p_data, size);
+		sp_context.port.loopback.tx_size += size;
+		err = NO_ERROR;
+#ifdef _HOST_NATIVE_
+		/** Host build : data goes to pipe given to the process as well */
+		metal_host_uart_tx(p_data, size);
+#endif /* _HOST_NATIVE_ */
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+void sp_loopback_stop_rx(t_context *p_ctx)
+{
+	/** Nothing to do */
+	return;
+}
+
+/******************************************************************************/
+void sp_loopback_close(t_context *p_ctx)
+{
+	/** Drop data not consumed */
+	sp_context.port.loopback.p_rx = 0;
+	sp_context.port.loopback.rx_lasting = 0;
+	/** End Of Function */
+	return;
+}
+#endif /* _WITH_SUP_LOOPBACK_ */
+
+/******************************************************************************/
+int_pltfrm sp_sup_transport_send(t_context *p_ctx, uint8_t *p_data, uint32_t size)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check transport */
+	if( !sp_context.port.p_transport )
+	{
+		/** Port not initialized */
+		err = N_SP_ERR_SUP_NOT_INITIALIZED;
+	}
+	else
+	{
+		/** Send on selected bus */
+		err = sp_context.port.p_transport->send_fct(p_ctx, p_data, size);
+	}
+	/** End Of Function */
+	return err;
+}
+
 /******************************************************************************/
 int_pltfrm sp_check_stimulus(t_context *p_ctx)
 {
@@ -333,7 +753,7 @@ int_pltfrm sp_check_stimulus(t_context *p_ctx)
 			/** Set state for SUP */
 			sp_context.state = N_SP_STATE_NOT_INITIALIZED;
 			/** Read MSEL value @ 0x1000 */
-			if( *((uint32_t*)0x1000) )
+			if( *((uint32_t*)M_PLATFORM_ADDR(0x1000)) )
 			{
 				/** SUP session is to be opened */
 				sp_context.port.bus_id = N_SBRM_BUSID_UART;
@@ -533,6 +953,13 @@ int_pltfrm sp_sup_check_security(t_context *p_ctx)
 		/** Should not happen */
 		err = GENERIC_ERR_CRITICAL;
 	}
+#ifdef _WITH_SUP_FRAGMENTATION_
+	else if( !sp_context.security.nb_signatures && ( N_SP_SUP_SEGMENT_TYPE_FRAGMENT == sp_context.sup.rx_hdr.command_type ) )
+	{
+		/** Unsigned fragment, it will be covered by FRAGMENT-END packet signature */
+		err = NO_ERROR;
+	}
+#endif /* _WITH_SUP_FRAGMENTATION_ */
 	else
 	{
 		/** KM context is set */
@@ -871,24 +1298,77 @@ int_pltfrm sp_sup_process_cmd(t_context *p_ctx, uint8_t **p_data, uint32_t *p_le
 		/** Pointer should not be null */
 		err = GENERIC_ERR_NULL_PTR;
 	}
+#ifdef _WITH_SUP_FRAGMENTATION_
+	else if( N_SP_SUP_SEGMENT_TYPE_FRAGMENT_END == sp_context.sup.rx_hdr.command_type )
+	{
+		/** Reassembled command */
+		err = sp_sup_process_fragments(p_ctx, p_data, p_length);
+	}
+#endif /* _WITH_SUP_FRAGMENTATION_ */
+#ifdef _WITH_SUP_BATCH_
+	else if( N_SP_SUP_SEGMENT_TYPE_BATCH == sp_context.sup.rx_hdr.command_type )
+	{
+		/** Several sub-commands under the same signature */
+		err = sp_sup_process_batch(p_ctx, p_data, p_length);
+	}
+#endif /* _WITH_SUP_BATCH_ */
 	else
 	{
-		/** Check received command */
-		switch( sp_context.sup.rx_hdr.command_type )
+		/** Treat received command, payload has been stored at reception */
+		err = sp_sup_dispatch_cmd(p_ctx,
+									sp_context.sup.rx_hdr.command_type,
+									sp_context.sup.rx_hdr.address,
+									sp_context.sup.payload.p_data,
+									sp_context.sup.payload.size,
+									p_data,
+									p_length);
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm sp_sup_dispatch_cmd(t_context *p_ctx,
+								uint32_t command_type,
+								uint32_t address,
+								uint8_t *p_payload,
+								uint32_t payload_length,
+								uint8_t **p_data,
+								uint32_t *p_length)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointer */
+	if( !p_ctx || !p_length )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+		/** Check command */
+		switch( command_type )
 		{
 			case N_SP_SUP_SEGMENT_TYPE_COPY:
-				/** Copy data to destination address */
-//				err = sp_treat_copy();
-				/** Already done when receiving command header - :/ */
-				err = NO_ERROR;
+				/** Copy data to destination address - nothing done if already received in place */
+				err = sp_treat_copy(p_ctx, (uint_pltfrm)address, (uint_pltfrm)payload_length, p_payload);
+#ifdef _WITH_SUP_APPLET_CACHE_
+				if( NO_ERROR == err )
+				{
+					/** Keep track of written area, for applet cache */
+					sp_applet_cache_track_copy((uint_pltfrm)address, payload_length);
+				}
+#endif /* _WITH_SUP_APPLET_CACHE_ */
 				/** No specific data to return */
 				*p_length = 0;
 				break;
 			case N_SP_SUP_SEGMENT_TYPE_WRITECSK:
+				/** Specific address value to indicate that CSK must be programmed in last slot */
+				sp_context.csk_last_slot = ( C_SP_SUP_CSK_LAST_SLOT_ADDR == address ) ? TRUE : FALSE;
 				err = sp_treat_writekey(p_ctx,
 										N_KM_KEYID_CSK,
-										sp_context.sup.payload.p_data,
-										( sp_context.sup.rx_hdr.command_length - sizeof(uint32_t)));
+										p_payload,
+										payload_length);
 				if( NO_ERROR == err )
 				{
 					/** No specific data to return */
@@ -898,8 +1378,8 @@ int_pltfrm sp_sup_process_cmd(t_context *p_ctx, uint8_t **p_data, uint32_t *p_le
 			case N_SP_SUP_SEGMENT_TYPE_WRITECUK:
 				err = sp_treat_writekey(p_ctx,
 										N_KM_KEYID_CUK,
-										sp_context.sup.payload.p_data,
-										( sp_context.sup.rx_hdr.command_length - sizeof(uint32_t)));
+										p_payload,
+										payload_length);
 				if( NO_ERROR == err )
 				{
 					/** No specific data to return */
@@ -909,8 +1389,8 @@ int_pltfrm sp_sup_process_cmd(t_context *p_ctx, uint8_t **p_data, uint32_t *p_le
 			case N_SP_SUP_SEGMENT_TYPE_WRITEPMUSK:
 				err = sp_treat_writekey(p_ctx,
 										N_KM_KEYID_PSK,
-										sp_context.sup.payload.p_data,
-										( sp_context.sup.rx_hdr.command_length - sizeof(uint32_t)));
+										p_payload,
+										payload_length);
 				if( NO_ERROR == err )
 				{
 					/** No specific data to return */
@@ -921,13 +1401,41 @@ int_pltfrm sp_sup_process_cmd(t_context *p_ctx, uint8_t **p_data, uint32_t *p_le
 				err = sp_treat_getinfo(p_ctx, (uint8_t**)p_data, p_length);
 				break;
 			case N_SP_SUP_SEGMENT_TYPE_EXECUTE:
+				if( !p_payload || ( sizeof(uint32_t) > payload_length ) )
+				{
+					/** Jump address is the first word of payload */
+					err = N_SP_ERR_SUP_WRONG_CMD_LENGTH;
+					break;
+				}
+#ifdef _WITH_SUP_APPLET_CACHE_
+				/** Applet has been verified, record its load area before it runs - cache is optional thus error is ignored */
+				(void)sp_applet_cache_record((uint_pltfrm)*((uint32_t*)p_payload));
+#endif /* _WITH_SUP_APPLET_CACHE_ */
 				err = sp_treat_execute(p_ctx,
-										*((uint32_t*)work_buf),
-										sp_context.sup.payload.p_data,
-										( sp_context.sup.rx_hdr.command_length - sizeof(uint32_t)),
+										*((uint32_t*)p_payload),
+										p_payload,
+										payload_length,
 										(uint8_t**)p_data,
 										p_length);
 				break;
+#ifdef _WITH_SUP_FRAGMENTATION_
+			case N_SP_SUP_SEGMENT_TYPE_FRAGMENT:
+				/** Data is already in reassembly arena, just account for it */
+				sp_context.frag.fill = address + payload_length;
+				/** No specific data to return */
+				*p_length = 0;
+				err = NO_ERROR;
+				break;
+#endif /* _WITH_SUP_FRAGMENTATION_ */
+#ifdef _WITH_SUP_APPLET_CACHE_
+			case N_SP_SUP_SEGMENT_TYPE_EXECUTE_CACHED:
+				err = sp_treat_execute_cached(p_ctx,
+												p_payload,
+												payload_length,
+												(uint8_t**)p_data,
+												p_length);
+				break;
+#endif /* _WITH_SUP_APPLET_CACHE_ */
 			default:
 				err = N_SP_ERR_SUP_CMD_NOT_SUPPORTED;
 				break;
@@ -937,6 +1445,196 @@ int_pltfrm sp_sup_process_cmd(t_context *p_ctx, uint8_t **p_data, uint32_t *p_le
 	return err;
 }
 
+#ifdef _WITH_SUP_FRAGMENTATION_
+/******************************************************************************/
+int_pltfrm sp_sup_process_fragments(t_context *p_ctx, uint8_t **p_data, uint32_t *p_length)
+{
+	uint8_t										*p_msg;
+	t_sp_sup_frag_hdr							*p_hdr;
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointers */
+	if( !p_ctx || !p_data || !p_length )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto sp_sup_process_fragments_out;
+	}
+	/** Assign pointers */
+	p_hdr = (t_sp_sup_frag_hdr*)sp_context.frag.p_arena;
+	p_msg = sp_context.frag.p_arena + sizeof(t_sp_sup_frag_hdr);
+	/** Reassembled command must match received data */
+	if( !sp_context.frag.fill ||
+		( ( sp_context.frag.fill + sizeof(uint32_t) ) != p_hdr->command_length ) )
+	{
+		err = N_SP_ERR_SUP_WRONG_CMD_LENGTH;
+		goto sp_sup_process_fragments_out;
+	}
+	/** Check reassembled command */
+	switch( p_hdr->command_type )
+	{
+		case N_SP_SUP_SEGMENT_TYPE_COPY:
+			/** Destination must not overlap arena */
+			if( ( (uint_pltfrm)sp_context.frag.p_arena < ( (uint_pltfrm)p_hdr->address + sp_context.frag.fill ) ) &&
+				( (uint_pltfrm)p_hdr->address < ( (uint_pltfrm)p_msg + sp_context.frag.fill ) ) )
+			{
+				err = N_SP_ERR_SUP_NO_MORE_MEMORY;
+				goto sp_sup_process_fragments_out;
+			}
+			break;
+		case N_SP_SUP_SEGMENT_TYPE_GETINFO:
+		case N_SP_SUP_SEGMENT_TYPE_FRAGMENT:
+		case N_SP_SUP_SEGMENT_TYPE_FRAGMENT_END:
+#ifdef _WITH_SUP_BATCH_
+		case N_SP_SUP_SEGMENT_TYPE_BATCH:
+#endif /* _WITH_SUP_BATCH_ */
+			/** Not meaningful once reassembled */
+			err = N_SP_ERR_SUP_CMD_NOT_SUPPORTED;
+			goto sp_sup_process_fragments_out;
+		default:
+			break;
+	}
+	/** Treat reassembled command */
+	err = sp_sup_dispatch_cmd(p_ctx,
+								p_hdr->command_type,
+								p_hdr->address,
+								p_msg,
+								sp_context.frag.fill,
+								p_data,
+								p_length);
+sp_sup_process_fragments_out:
+	/** Reassembly is over, whatever the result */
+	sp_context.frag.fill = 0;
+	/** End Of Function */
+	return err;
+}
+#endif /* _WITH_SUP_FRAGMENTATION_ */
+
+#ifdef _WITH_SUP_BATCH_
+/******************************************************************************/
+int_pltfrm sp_sup_process_batch(t_context *p_ctx, uint8_t **p_data, uint32_t *p_length)
+{
+	uint32_t									i;
+	uint32_t									nb_cmd;
+	uint32_t									offset = 0;
+	uint32_t									rsp_offset = 0;
+	uint32_t									payload_length;
+	uint32_t									sub_length;
+	uint8_t										*p_sub_data;
+	t_sp_sup_batch_cmd_hdr						*p_cmd_hdr;
+	t_sp_sup_batch_rsp_hdr						*p_rsp_hdr;
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointers */
+	if( !p_ctx || !p_data || !p_length )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto sp_sup_process_batch_out;
+	}
+	/** 'address' field of batch command holds number of sub-commands */
+	nb_cmd = sp_context.sup.rx_hdr.address;
+	if( !nb_cmd || ( C_SP_SUP_BATCH_MAX_CMD_NB < nb_cmd ) )
+	{
+		/** Wrong number of sub-commands */
+		err = N_SP_ERR_SUP_BATCH_MALFORMED;
+		goto sp_sup_process_batch_out;
+	}
+	/** Combined response is built in its own buffer */
+	*p_data = (uint8_t*)batch_rsp_buf;
+	*p_length = 0;
+	/** Process sub-commands in order - stop at first failure */
+	for( i = 0;i < nb_cmd;i++ )
+	{
+		/** Sub-command header must fit in received payload */
+		if( ( offset + sizeof(t_sp_sup_batch_cmd_hdr) ) > sp_context.sup.payload.size )
+		{
+			err = N_SP_ERR_SUP_BATCH_MALFORMED;
+			goto sp_sup_process_batch_out;
+		}
+		p_cmd_hdr = (t_sp_sup_batch_cmd_hdr*)&batch_buf[offset];
+		offset += sizeof(t_sp_sup_batch_cmd_hdr);
+		/** Compute sub-command payload length, 'address' field excluded */
+		if( !p_cmd_hdr->command_length )
+		{
+			/** No payload - e.g. GETINFO */
+			payload_length = 0;
+		}
+		else if( ( sizeof(uint32_t) > p_cmd_hdr->command_length ) ||
+				( p_cmd_hdr->command_length & ( sizeof(uint32_t) - 1 ) ) ||
+				( ( p_cmd_hdr->command_length - sizeof(uint32_t) ) > ( sp_context.sup.payload.size - offset ) ) )
+		{
+			/** Sub-command payload must be 32bits aligned and fit in received payload */
+			err = N_SP_ERR_SUP_BATCH_MALFORMED;
+			goto sp_sup_process_batch_out;
+		}
+		else
+		{
+			payload_length = p_cmd_hdr->command_length - sizeof(uint32_t);
+		}
+		/** Nested batch is not allowed */
+		if( ( N_SP_SUP_SEGMENT_TYPE_BATCH == p_cmd_hdr->command_type )
+#ifdef _WITH_SUP_FRAGMENTATION_
+			/** Neither fragments, they are only meaningful as packets */
+			|| ( N_SP_SUP_SEGMENT_TYPE_FRAGMENT == p_cmd_hdr->command_type )
+			|| ( N_SP_SUP_SEGMENT_TYPE_FRAGMENT_END == p_cmd_hdr->command_type )
+#endif /* _WITH_SUP_FRAGMENTATION_ */
+			)
+		{
+			err = N_SP_ERR_SUP_BATCH_MALFORMED;
+			goto sp_sup_process_batch_out;
+		}
+		/** Treat sub-command */
+		sub_length = 0;
+		p_sub_data = 0;
+		err = sp_sup_dispatch_cmd(p_ctx,
+									p_cmd_hdr->command_type,
+									p_cmd_hdr->address,
+									( payload_length ? &batch_buf[offset] : 0 ),
+									payload_length,
+									&p_sub_data,
+									&sub_length);
+		offset += payload_length;
+		/** Returned data must fit in combined response */
+		if( ( NO_ERROR != err ) || !p_sub_data )
+		{
+			/** No data to return */
+			sub_length = 0;
+		}
+		if( ( rsp_offset + sizeof(t_sp_sup_batch_rsp_hdr) + sub_length ) > sizeof(batch_rsp_buf) )
+		{
+			err = N_SP_ERR_SUP_BATCH_RSP_OVERFLOW;
+			goto sp_sup_process_batch_out;
+		}
+		/** Append sub-command record */
+		p_rsp_hdr = (t_sp_sup_batch_rsp_hdr*)&batch_rsp_buf[rsp_offset];
+		p_rsp_hdr->command_type = p_cmd_hdr->command_type;
+		p_rsp_hdr->ret_error = (int32_t)err;
+		p_rsp_hdr->data_length = sub_length;
+		rsp_offset += sizeof(t_sp_sup_batch_rsp_hdr);
+		if( sub_length )
+		{
+			memcpy((void*)&batch_rsp_buf[rsp_offset], (const void*)p_sub_data, sub_length);
+			rsp_offset += sub_length;
+		}
+		*p_length = rsp_offset;
+		if( NO_ERROR != err )
+		{
+			/** Error code of failing sub-command is returned, records already built are kept */
+			goto sp_sup_process_batch_out;
+		}
+	}
+	/** Whole payload must have been consumed */
+	if( offset != sp_context.sup.payload.size )
+	{
+		err = N_SP_ERR_SUP_BATCH_MALFORMED;
+	}
+sp_sup_process_batch_out:
+	/** End Of Function */
+	return err;
+}
+#endif /* _WITH_SUP_BATCH_ */
+
 /******************************************************************************/
 int_pltfrm sp_sup_send_response(t_context *p_ctx, uint8_t *p_data, uint32_t length)
 {
@@ -956,7 +1654,7 @@ int_pltfrm sp_sup_send_response(t_context *p_ctx, uint8_t *p_data, uint32_t leng
 	else
 	{
 		/** Send  */
-		err = sp_uart_send_buffer(p_ctx, p_data, length);
+		err = sp_sup_transport_send(p_ctx, p_data, length);
 	}
 	/** End Of Function */
 	return err;
@@ -982,17 +1680,51 @@ int_pltfrm sp_sup_initialize_communication(t_context *p_ctx)
 		err = GENERIC_ERR_CRITICAL;
 		goto sp_sup_initialize_communication_out;
 	}
-	/** Initialize port */
+#ifdef _WITH_SUP_LOOPBACK_
+	/** Host build : memory loopback replaces any bus */
+	sp_context.port.bus_id = N_SBRM_BUSID_LOOPBACK;
+#elif defined(_WITH_SUP_SPI_SLAVE_)
+	/** SPI slave replaces UART only if explicitly programmed in OTP */
+	if( N_SBRM_BUSID_UART == sp_context.port.bus_id )
+	{
+		uint32_t								sup_bus = C_PATTERN_VIRGIN_32BITS;
+
+		err = sbrm_read_otp(p_ctx, C_OTP_SUP_BUS_OFST, (uint8_t*)&sup_bus, C_OTP_SUP_BUS_SIZE);
+		if( err )
+		{
+			/** Should not happen */
+			err = GENERIC_ERR_CRITICAL;
+			goto sp_sup_initialize_communication_out;
+		}
+		else if( C_OTP_SUP_BUS_SPI_NOOFST == sup_bus )
+		{
+			sp_context.port.bus_id = N_SBRM_BUSID_SPI;
+		}
+	}
+#endif /* _WITH_SUP_LOOPBACK_ */
+	/** Select transport */
 	switch( sp_context.port.bus_id )
 	{
 		case N_SBRM_BUSID_UART:
-			metal_uart_init(sp_context.port.uart.uart0, sp_context.port.config[C_SP_SUP_PORT_CONF_BAUDRATE_OFST]);
-			err = NO_ERROR;
+			sp_context.port.p_transport = &sp_transport_uart;
+			break;
+#ifdef _WITH_SUP_SPI_SLAVE_
+		case N_SBRM_BUSID_SPI:
+			sp_context.port.p_transport = &sp_transport_spis;
+			break;
+#endif /* _WITH_SUP_SPI_SLAVE_ */
+#ifdef _WITH_SUP_LOOPBACK_
+		case N_SBRM_BUSID_LOOPBACK:
+			sp_context.port.p_transport = &sp_transport_loopback;
 			break;
+#endif /* _WITH_SUP_LOOPBACK_ */
 		default:
+			sp_context.port.p_transport = 0;
 			err = N_SP_ERR_SUP_COM_PORT_NOT_HANDLED;
 			goto sp_sup_initialize_communication_out;
 	}
+	/** Initialize port */
+	err = sp_context.port.p_transport->initialize_fct(p_ctx);
 sp_sup_initialize_communication_out:
 	/** End Of Function */
 	return err;
@@ -1054,6 +1786,9 @@ int_pltfrm sp_sup_open_communication(t_context *p_ctx)
 			/** Packet cannot be retrieved for any reason, exit with error */
 			goto sp_sup_open_communication_out;
 		}
+#ifdef _WITH_SBRM_PROFILING_
+		sbrm_prof_mark(N_SBRM_PROF_SUP_PACKET);
+#endif /* _WITH_SBRM_PROFILING_ */
 		/** Check signature */
 		err = sp_sup_check_security((t_context*)p_ctx);
 		if ( err )
@@ -1090,6 +1825,9 @@ int_pltfrm sp_sup_open_communication(t_context *p_ctx)
 		/** Reinitialize parameters */
 		memset((void*)&sp_context.rx_communication, 0x00, sizeof(sp_context.rx_communication));
 		memset((void*)&sp_context.tx_communication, 0x00, sizeof(sp_context.tx_communication));
+#ifdef _WITH_SBRM_PROFILING_
+		sbrm_prof_mark(N_SBRM_PROF_SUP_PACKET_END);
+#endif /* _WITH_SBRM_PROFILING_ */
 	}
 sp_sup_open_communication_out:
 	/** End Of Function */
@@ -1105,20 +1843,49 @@ void sp_sup_close_communication(t_context *p_ctx)
 	{
 		/** Pointer should not be null */
 	}
-	else
+	else if( sp_context.port.p_transport )
 	{
 		/** Close bus */
-		/** Disable interruptions */
-		M_UART_MASK_RX_IRQ(sp_context.port.uart.reg_uart);
-		M_UART_MASK_TX_IRQ(sp_context.port.uart.reg_uart);
-		/** Disable RX and TX */
-		M_UART_RX_DISABLE(sp_context.port.uart.reg_uart);
-		M_UART_TX_DISABLE(sp_context.port.uart.reg_uart);
+		sp_context.port.p_transport->close_fct(p_ctx);
 	}
 	/** End Of Function */
 	return;
 }
 
+/******************************************************************************/
+int_pltfrm sp_treat_copy(t_context *p_ctx, uint_pltfrm address, uint_pltfrm length, uint8_t *p_data)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointers */
+	if( !p_ctx || ( length && !p_data ) )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	/** Check boundaries */
+	else if( ( (uint_pltfrm)&__sbrm_free_start_addr > address ) ||
+			( M_SP_APPLET_AREA_END() <= ( address + length ) ) ||
+			( address > ( address + length ) ) )
+	{
+		/** Data will not fit into internal RAM */
+		err = N_SP_ERR_SUP_NO_MORE_MEMORY;
+	}
+	else
+	{
+		/** Data may have been received in place already */
+		if( (uint8_t*)address != p_data )
+		{
+			/** Copy data to destination address */
+			memcpy((void*)address, (const void*)p_data, length);
+		}
+		/** No error */
+		err = NO_ERROR;
+	}
+	/** End Of Function */
+	return err;
+}
+
 /******************************************************************************/
 int_pltfrm sp_treat_writekey(t_context *p_ctx, e_km_keyid key_id, uint8_t *p_data, uint32_t length)
 {
@@ -1300,7 +2067,7 @@ sp_treat_writekey_out:
 int_pltfrm sp_treat_execute(t_context *p_ctx, uint_pltfrm jump_addr, uint8_t *p_arg, uint32_t length, uint8_t **p_data, uint32_t *p_length)
 {
 	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
-	uint_pltfrm (*applet_fct_ptr)(uint8_t* p_arg, uint32_t length, uint8_t **p_ret_data, uint32_t *p_ret_size);
+	uint_pltfrm (*applet_fct_ptr)(uint8_t* p_arg, uint32_t length, uint8_t **p_ret_data, uint32_t *p_ret_size, const t_sp_rom_services *p_svc);
 
 	/** Check input pointer */
 	if( !p_arg )
@@ -1323,8 +2090,8 @@ int_pltfrm sp_treat_execute(t_context *p_ctx, uint_pltfrm jump_addr, uint8_t *p_
 		}
 		/** Assign function pointer */
 		applet_fct_ptr = (uint_pltfrm*)jump_addr;
-		/** Call function */
-		err = applet_fct_ptr(p_arg, length, p_data, p_length);
+		/** Call function - ROM services table is given as last argument */
+		err = applet_fct_ptr(p_arg, length, p_data, p_length, (const t_sp_rom_services*)&sp_rom_services);
 
 	}
 sp_treat_execute_out:
@@ -1332,6 +2099,305 @@ sp_treat_execute_out:
 	return err;
 }
 
+#ifdef _WITH_SUP_APPLET_CACHE_
+/******************************************************************************/
+int_pltfrm sp_treat_execute_cached(t_context *p_ctx, uint8_t *p_payload, uint32_t length, uint8_t **p_data, uint32_t *p_length)
+{
+	uint8_t										i;
+	t_sp_sup_cached_exec						*p_cmd = (t_sp_sup_cached_exec*)p_payload;
+	t_sp_applet_cache_entry						*p_entry = 0;
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointers */
+	if( !p_ctx || !p_payload || !p_data || !p_length )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+		goto sp_treat_execute_cached_out;
+	}
+	else if( sizeof(t_sp_sup_cached_exec) > length )
+	{
+		/** Digest, immutable size and jump address are mandatory */
+		err = N_SP_ERR_SUP_WRONG_CMD_LENGTH;
+		goto sp_treat_execute_cached_out;
+	}
+	/** Look for load area holding jump address */
+	for( i = 0;i < C_SP_APPLET_CACHE_NB;i++ )
+	{
+		if( ( TRUE == sp_context.cache.entry[i].valid ) &&
+			( sp_context.cache.entry[i].address <= (uint_pltfrm)p_cmd->jump_addr ) &&
+			( ( sp_context.cache.entry[i].address + sp_context.cache.entry[i].length ) > (uint_pltfrm)p_cmd->jump_addr ) )
+		{
+			/** Found */
+			p_entry = &sp_context.cache.entry[i];
+			break;
+		}
+	}
+	if( !p_entry )
+	{
+		/** Applet must be uploaded again */
+		err = N_SP_ERR_SUP_APPLET_NOT_CACHED;
+		goto sp_treat_execute_cached_out;
+	}
+	/** Immutable part must lie in load image, and hold jump address */
+	if( !p_cmd->image_length ||
+		( p_entry->length < p_cmd->image_length ) ||
+		( ( p_entry->address + p_cmd->image_length ) <= (uint_pltfrm)p_cmd->jump_addr ) )
+	{
+		err = N_SP_ERR_SUP_JUMP_ADDR_FAILURE;
+		goto sp_treat_execute_cached_out;
+	}
+	/** Immutable part is checked against digest given in signed command, so
+	 * that applet writable data does not invalidate the entry */
+	err = sp_applet_cache_hash(p_ctx, p_entry->address, p_cmd->image_length, p_ctx->digest);
+	if( err )
+	{
+		goto sp_treat_execute_cached_out;
+	}
+	else if( memcmp((const void*)p_ctx->digest, (const void*)p_cmd->digest, sizeof(p_cmd->digest)) )
+	{
+		/** Content changed, entry is dropped */
+		p_entry->valid = FALSE;
+		err = N_SP_ERR_SUP_APPLET_NOT_CACHED;
+		goto sp_treat_execute_cached_out;
+	}
+	/** Arguments layout is the same as for EXECUTE command */
+	err = sp_treat_execute(p_ctx,
+							(uint_pltfrm)p_cmd->jump_addr,
+							(uint8_t*)&p_cmd->jump_addr,
+							( length - ( sizeof(p_cmd->digest) + sizeof(p_cmd->image_length) ) ),
+							p_data,
+							p_length);
+sp_treat_execute_cached_out:
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm sp_applet_cache_hash(t_context *p_ctx, uint_pltfrm address, uint32_t length, uint8_t *p_digest)
+{
+	size_t										hash_len = SHA384_BYTE_HASHSIZE;
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointers */
+	if( !p_ctx || !p_digest )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+#ifdef _WITH_GPIO_CHARAC_
+		/** Set GPIO SHA high */
+		metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 1);
+#endif /* _WITH_GPIO_CHARAC_ */
+		err = scl_sha((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+						SCL_HASH_SHA384,
+						(const uint8_t *const)address,
+						(size_t)length,
+						(uint8_t *const)p_digest,
+						&hash_len);
+#ifdef _WITH_GPIO_CHARAC_
+		/** Set GPIO SHA low */
+		metal_gpio_set_pin(p_ctx->gpio0, C_GPIO0_SHA, 0);
+#endif /* _WITH_GPIO_CHARAC_ */
+		if( SCL_OK != err )
+		{
+			/** Crypto library failure */
+			err = N_SP_ERR_SUP_CRYPTO_FAILURE;
+		}
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+void sp_applet_cache_track_copy(uint_pltfrm address, uint32_t length)
+{
+	uint8_t										i;
+
+	/** Cached applets overlapping written area are no more valid */
+	for( i = 0;i < C_SP_APPLET_CACHE_NB;i++ )
+	{
+		if( ( TRUE == sp_context.cache.entry[i].valid ) &&
+			( address < ( sp_context.cache.entry[i].address + sp_context.cache.entry[i].length ) ) &&
+			( sp_context.cache.entry[i].address < ( address + length ) ) )
+		{
+			sp_context.cache.entry[i].valid = FALSE;
+		}
+	}
+	/** Extend current area if contiguous, otherwise start a new one */
+	if( ( sp_context.cache.copy_end != address ) || ( sp_context.cache.copy_start == sp_context.cache.copy_end ) )
+	{
+		sp_context.cache.copy_start = address;
+	}
+	sp_context.cache.copy_end = address + length;
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+int_pltfrm sp_applet_cache_record(uint_pltfrm jump_addr)
+{
+	uint8_t										i;
+	uint32_t									length;
+	t_sp_applet_cache_entry						*p_entry;
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Only an area written by COPY commands and holding jump address can be cached */
+	if( ( sp_context.cache.copy_start > jump_addr ) || ( sp_context.cache.copy_end <= jump_addr ) )
+	{
+		err = N_SP_ERR_SUP_APPLET_NOT_CACHED;
+		goto sp_applet_cache_record_out;
+	}
+	length = (uint32_t)( sp_context.cache.copy_end - sp_context.cache.copy_start );
+	/** Area is recorded only : it is hashed if EXECUTE-CACHED asks for it */
+	for( i = 0;i < C_SP_APPLET_CACHE_NB;i++ )
+	{
+		if( ( TRUE == sp_context.cache.entry[i].valid ) &&
+			( sp_context.cache.copy_start < ( sp_context.cache.entry[i].address + sp_context.cache.entry[i].length ) ) &&
+			( sp_context.cache.entry[i].address < sp_context.cache.copy_end ) )
+		{
+			/** Same area already cached, drop the older entry */
+			sp_context.cache.entry[i].valid = FALSE;
+		}
+	}
+	/** Use next entry in round robin */
+	p_entry = &sp_context.cache.entry[sp_context.cache.next];
+	p_entry->address = sp_context.cache.copy_start;
+	p_entry->length = length;
+	p_entry->valid = TRUE;
+	sp_context.cache.next = ( sp_context.cache.next + 1 ) % C_SP_APPLET_CACHE_NB;
+	err = NO_ERROR;
+sp_applet_cache_record_out:
+	/** End Of Function */
+	return err;
+}
+#endif /* _WITH_SUP_APPLET_CACHE_ */
+
+/******************************************************************************/
+void sp_rom_services_init(t_context *p_ctx)
+{
+	/** Erase table */
+	memset((void*)&sp_rom_services, 0x00, sizeof(t_sp_rom_services));
+	/** Version and size allow applet to check available services */
+	sp_rom_services.version = C_SP_ROM_SVC_VERSION;
+	sp_rom_services.size = sizeof(t_sp_rom_services);
+	sp_rom_services.p_ctx = p_ctx;
+	/** Hash services */
+	sp_rom_services.sha_init = sp_svc_sha_init;
+	sp_rom_services.sha_core = sp_svc_sha_core;
+	sp_rom_services.sha_finish = sp_svc_sha_finish;
+	/** Key services */
+	sp_rom_services.get_key = km_get_key;
+	sp_rom_services.verify_signature = km_verify_signature;
+	/** Platform services */
+	sp_rom_services.read_otp = sbrm_read_otp;
+	sp_rom_services.com_send = sp_sup_transport_send;
+	sp_rom_services.compute_crc = sbrm_compute_crc;
+	/** Anti-rollback services */
+	sp_rom_services.get_application_version = slbv_get_application_version;
+	sp_rom_services.set_application_version = slbv_set_application_version;
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+int_pltfrm sp_svc_sha_init(t_context *p_ctx)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointer */
+	if( !p_ctx )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+		/** Initialize SHA384 on ROM hash context */
+		err = scl_sha_init((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+							(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+							SCL_HASH_SHA384);
+		if( SCL_OK != err )
+		{
+			/** Crypto library failure */
+			err = N_SP_ERR_SUP_CRYPTO_FAILURE;
+		}
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm sp_svc_sha_core(t_context *p_ctx, const uint8_t *p_data, uint32_t length)
+{
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointers */
+	if( !p_ctx || !p_data )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else
+	{
+		/** Update hash with data */
+		err = scl_sha_core((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+							(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+							p_data,
+							length);
+		if( SCL_OK != err )
+		{
+			/** Crypto library failure */
+			err = N_SP_ERR_SUP_CRYPTO_FAILURE;
+		}
+	}
+	/** End Of Function */
+	return err;
+}
+
+/******************************************************************************/
+int_pltfrm sp_svc_sha_finish(t_context *p_ctx, uint8_t *p_digest, uint32_t *p_length)
+{
+	size_t										hash_len = 0;
+	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
+
+	/** Check input pointers */
+	if( !p_ctx || !p_digest || !p_length )
+	{
+		/** Pointer should not be null */
+		err = GENERIC_ERR_NULL_PTR;
+	}
+	else if( SHA384_BYTE_HASHSIZE > *p_length )
+	{
+		/** Digest does not fit */
+		err = GENERIC_ERR_INVAL;
+	}
+	else
+	{
+		/** Finalize hash */
+		hash_len = *p_length;
+		err = scl_sha_finish((metal_scl_t*)p_ctx->p_metal_sifive_scl,
+								(scl_sha_ctx_t*)p_ctx->p_scl_hash_ctx,
+								p_digest,
+								&hash_len);
+		if( SCL_OK != err )
+		{
+			/** Crypto library failure */
+			err = N_SP_ERR_SUP_CRYPTO_FAILURE;
+		}
+		else
+		{
+			/** Return digest size */
+			*p_length = (uint32_t)hash_len;
+			err = NO_ERROR;
+		}
+	}
+	/** End Of Function */
+	return err;
+}
+
 /******************************************************************************/
 int_pltfrm sp_treat_getinfo(t_context *p_ctx, uint8_t** p_data, uint32_t *p_length)
 {
@@ -1399,9 +2465,13 @@ int_pltfrm sp_treat_getinfo(t_context *p_ctx, uint8_t** p_data, uint32_t *p_leng
 #endif /* _WITH_DOUBLE_RMA_MODE_ */
 		/** Retrieve Applet memory area */
 		p_tmp->applet_start = (uint_pltfrm)&__sbrm_free_start_addr;
-		p_tmp->applet_end = (uint_pltfrm)&__sbrm_free_end_addr;
+		p_tmp->applet_end = M_SP_APPLET_AREA_END();
 		/** Retrieve CSK free slot index */
 		p_tmp->csk_slot = p_km_ctx->index_free_csk;
+#ifdef _WITH_SBRM_PROFILING_
+		/** Retrieve boot-time profile */
+		memcpy((void*)&p_tmp->profile, (const void*)sbrm_prof_get_ring(), sizeof(t_sbrm_prof_ring));
+#endif /* _WITH_SBRM_PROFILING_ */
 		/** Set size of returned data */
 		*p_length = sizeof(t_getinfo_template);
 		err = NO_ERROR;
@@ -1513,7 +2583,7 @@ int_pltfrm sp_sup_cmd_hdr(uint8_t **p_data, uint32_t *p_size)
 				/** 'length' is given for all payload, don't forget to remove 32bits for 'address' from packet payload */
 				*p_size = sp_context.sup.rx_hdr.command_length - sizeof(uint32_t);
 				/** Check boundaries */
-				if( ( (volatile uint_pltfrm)&__sbrm_free_start_addr <= addr ) && ( (volatile uint_pltfrm)&__sbrm_free_end_addr > ( addr + *p_size ) ) )
+				if( ( (volatile uint_pltfrm)&__sbrm_free_start_addr <= addr ) && ( (volatile uint_pltfrm)M_SP_APPLET_AREA_END() > ( addr + *p_size ) ) )
 				{
 					/** Data to copy is in range */
 					*p_data = (uint8_t*)addr;
@@ -1596,6 +2666,115 @@ int_pltfrm sp_sup_cmd_hdr(uint8_t **p_data, uint32_t *p_size)
 				/** No error */
 				err = NO_ERROR;
 				break;
+#ifdef _WITH_SUP_FRAGMENTATION_
+			case N_SP_SUP_SEGMENT_TYPE_FRAGMENT:
+				/** Arena is at the end of free RAM, out of applet area */
+				sp_context.frag.p_arena = (uint8_t*)M_SP_APPLET_AREA_END();
+				/** First fragment restarts reassembly */
+				if( !sp_context.sup.rx_hdr.address )
+				{
+					sp_context.frag.fill = 0;
+				}
+				/** 'address' field holds fragment offset - fragments are expected in order */
+				if( ( (uint_pltfrm)&__sbrm_free_start_addr > (uint_pltfrm)sp_context.frag.p_arena ) ||
+					( sizeof(uint32_t) >= sp_context.sup.rx_hdr.command_length ) ||
+					( sp_context.frag.fill != sp_context.sup.rx_hdr.address ) ||
+					( ( C_SP_SUP_FRAG_ARENA_SIZE - sizeof(t_sp_sup_frag_hdr) - sp_context.frag.fill ) <
+						( sp_context.sup.rx_hdr.command_length - sizeof(uint32_t) ) ) )
+				{
+					/** Fragment can not be stored, reassembly is aborted */
+					err = N_SP_ERR_SUP_FRAG_SEQUENCE;
+					sp_context.frag.fill = 0;
+					sp_context.sup.payload.p_data = 0;
+					sp_context.sup.payload.size = 0;
+				}
+				else
+				{
+					/** Fragment data is appended to previous ones */
+					*p_data = sp_context.frag.p_arena + sizeof(t_sp_sup_frag_hdr) + sp_context.frag.fill;
+					*p_size = ( sp_context.sup.rx_hdr.command_length - sizeof(uint32_t) );
+					sp_context.sup.payload.p_data = *p_data;
+					sp_context.sup.payload.size = *p_size;
+					/** Prepare next step */
+					sp_context.sup.state_pkg = N_SP_SUP_RCV_PKT_SEG_PAYLOAD;
+					/** No error */
+					err = NO_ERROR;
+				}
+				break;
+			case N_SP_SUP_SEGMENT_TYPE_FRAGMENT_END:
+				if( !sp_context.frag.p_arena ||
+					( ( sizeof(t_sp_sup_frag_hdr) + sizeof(uint32_t) ) != sp_context.sup.rx_hdr.command_length ) )
+				{
+					/** Nothing to reassemble or wrong header length */
+					err = N_SP_ERR_SUP_WRONG_CMD_LENGTH;
+					sp_context.sup.payload.p_data = 0;
+					sp_context.sup.payload.size = 0;
+				}
+				else
+				{
+					/** Reassembled command header is stored right before fragments data */
+					*p_data = sp_context.frag.p_arena;
+					*p_size = sizeof(t_sp_sup_frag_hdr);
+					/** Signature covers command header and all fragments data */
+					sp_context.sup.payload.p_data = sp_context.frag.p_arena;
+					sp_context.sup.payload.size = sizeof(t_sp_sup_frag_hdr) + sp_context.frag.fill;
+					/** Prepare next step */
+					sp_context.sup.state_pkg = N_SP_SUP_RCV_PKT_SEG_PAYLOAD;
+					/** No error */
+					err = NO_ERROR;
+				}
+				break;
+#endif /* _WITH_SUP_FRAGMENTATION_ */
+#ifdef _WITH_SUP_APPLET_CACHE_
+			case N_SP_SUP_SEGMENT_TYPE_EXECUTE_CACHED:
+				/** Digest, immutable size, jump address and arguments must fit in 'work_buf' */
+				if( ( ( sizeof(t_sp_sup_cached_exec) + sizeof(uint32_t) ) > sp_context.sup.rx_hdr.command_length ) ||
+					( sizeof(work_buf) < ( sp_context.sup.rx_hdr.command_length - sizeof(uint32_t) ) ) )
+				{
+					/** Command can not be received */
+					err = N_SP_ERR_SUP_WRONG_CMD_LENGTH;
+					sp_context.sup.payload.p_data = 0;
+					sp_context.sup.payload.size = 0;
+				}
+				else
+				{
+					/** Here 'work_buf' is used as temporary buffer */
+					*p_data = (uint8_t*)work_buf;
+					*p_size = ( sp_context.sup.rx_hdr.command_length - sizeof(uint32_t) );
+					sp_context.sup.payload.p_data = *p_data;
+					sp_context.sup.payload.size = *p_size;
+					/** Prepare next step */
+					sp_context.sup.state_pkg = N_SP_SUP_RCV_PKT_SEG_PAYLOAD;
+					/** No error */
+					err = NO_ERROR;
+				}
+				break;
+#endif /* _WITH_SUP_APPLET_CACHE_ */
+#ifdef _WITH_SUP_BATCH_
+			case N_SP_SUP_SEGMENT_TYPE_BATCH:
+				/** 'address' field holds number of sub-commands, check payload fits in batch buffer */
+				if( ( sizeof(uint32_t) >= sp_context.sup.rx_hdr.command_length ) ||
+					( sizeof(batch_buf) < ( sp_context.sup.rx_hdr.command_length - sizeof(uint32_t) ) ) )
+				{
+					/** Batch can not be received */
+					err = N_SP_ERR_SUP_WRONG_CMD_LENGTH;
+					sp_context.sup.payload.p_data = 0;
+					sp_context.sup.payload.size = 0;
+				}
+				else
+				{
+					/** Sub-commands are received in batch buffer, covered by packet signature */
+					*p_data = (uint8_t*)batch_buf;
+					*p_size = ( sp_context.sup.rx_hdr.command_length - sizeof(uint32_t) );
+					sp_context.sup.payload.p_data = *p_data;
+					sp_context.sup.payload.size = *p_size;
+					/** Prepare next step */
+					sp_context.sup.state_pkg = N_SP_SUP_RCV_PKT_SEG_PAYLOAD;
+					/** No error */
+					err = NO_ERROR;
+				}
+				break;
+#endif /* _WITH_SUP_BATCH_ */
 			default:
 				/** Error should not happen */
 				err = N_SP_ERR_SUP_WRONG_CMD;
@@ -1646,6 +2825,15 @@ int_pltfrm sp_sup_secu(t_context *p_ctx, uint8_t **p_data, uint32_t *p_size)
 				err = NO_ERROR;
 			}
 		}
+#ifdef _WITH_SUP_FRAGMENTATION_
+		/** Fragments may be unsigned, whole message is checked with FRAGMENT-END packet */
+		if( !sp_context.security.nb_signatures && ( N_SP_SUP_SEGMENT_TYPE_FRAGMENT == sp_context.sup.rx_hdr.command_type ) )
+		{
+			/** Nothing to check */
+			err = NO_ERROR;
+		}
+		else
+#endif /* _WITH_SUP_FRAGMENTATION_ */
 		/** Packet must have, at least one signature */
 		if( !sp_context.security.nb_signatures || ( C_SP_SUP_MAX_SIGNATURE_ELMNT_NB < sp_context.security.nb_signatures ) )
 		{
@@ -1680,6 +2868,12 @@ int_pltfrm sp_sup_receive_packet(void *p_ctx)
 		err = GENERIC_ERR_NULL_PTR;
 		goto sp_sup_receive_packet_out;
 	}
+	else if( !sp_context.port.p_transport )
+	{
+		/** Port must have been initialized */
+		err = N_SP_ERR_SUP_NOT_INITIALIZED;
+		goto sp_sup_receive_packet_out;
+	}
 	/** Assign pointer */
 	p_context = (t_context*)p_ctx;
 	/** Initialize variables */
@@ -1692,7 +2886,7 @@ int_pltfrm sp_sup_receive_packet(void *p_ctx)
 	while( ( N_SP_STATE_END > sp_context.state ) && ( NO_ERROR == err ) )
 	{
 		/** Read expected number of bytes */
-		err = sp_uart_receive_buffer(p_ctx, (uint8_t*)p_tmp, (uint32_t*)&size_read);
+		err = sp_context.port.p_transport->receive_fct(p_context, (uint8_t*)p_tmp, (uint32_t*)&size_read);
 		/**  */
 		switch( sp_context.sup.state_pkg )
 		{
@@ -1875,10 +3069,10 @@ int_pltfrm sp_sup_receive_packet(void *p_ctx)
 	}
 sp_sup_receive_packet_out:
 	/** Stop bus reception */
-	/** Disable UART interruption */
-	M_UART_MASK_RX_IRQ(sp_context.port.uart.reg_uart);
-	/** Disable UART's RX */
-	M_UART_RX_DISABLE(sp_context.port.uart.reg_uart);
+	if( sp_context.port.p_transport )
+	{
+		sp_context.port.p_transport->stop_rx_fct((t_context*)p_ctx);
+	}
 	/** End Of Function */
 	return err;
 }
@@ -1934,7 +3128,7 @@ int_pltfrm sp_sup_packet_response(t_context *p_ctx,
 		}
 		/** Now start sending ... */
 		/** ... with header ... */
-		err = sp_uart_send_buffer(p_ctx, (uint8_t*)&sp_context.sup.tx_hdr, sizeof(t_sp_sup_tx_pckt_hdr));
+		err = sp_sup_transport_send(p_ctx, (uint8_t*)&sp_context.sup.tx_hdr, sizeof(t_sp_sup_tx_pckt_hdr));
 		if( err )
 		{
 			/** Error should not happen */
@@ -1944,7 +3138,7 @@ int_pltfrm sp_sup_packet_response(t_context *p_ctx,
 		/** ... then payload if any */
 		if ( length )
 		{
-			err = sp_uart_send_buffer(p_ctx, (uint8_t*)p_data, length);
+			err = sp_sup_transport_send(p_ctx, (uint8_t*)p_data, length);
 			if( err )
 			{
 				/** Error should not happen */
@@ -1953,7 +3147,7 @@ int_pltfrm sp_sup_packet_response(t_context *p_ctx,
 			}
 		}
 		/** ... and finish with CRC */
-		err = sp_uart_send_buffer(p_ctx, (uint8_t*)&crc, sizeof(uint32_t));
+		err = sp_sup_transport_send(p_ctx, (uint8_t*)&crc, sizeof(uint32_t));
 		if( err )
 		{
 			/** Error should not happen */
@@ -70,6 +70,16 @@ __attribute__((section(".bss"))) volatile t_context context;
 /** SCL context structure */
 #if METAL_SIFIVE_HCA_VERSION >= HCA_VERSION(0,5,0)
 metal_scl_t metal_sifive_scl = {
+#if defined(HCA_HAS_AES)
+    .aes_func = {
+        .setkey = hca_aes_setkey,
+        .setiv  = hca_aes_setiv,
+        .cipher = hca_aes_cipher,
+        .auth_init = hca_aes_auth_init,
+        .auth_core = hca_aes_auth_core,
+        .auth_finish = hca_aes_auth_finish
+    },
+#else
     .aes_func = {
         .setkey = default_aes_setkey,
         .setiv  = default_aes_setiv,
@@ -78,6 +88,7 @@ metal_scl_t metal_sifive_scl = {
         .auth_core = default_aes_auth_core,
         .auth_finish = default_aes_auth_finish
     },
+#endif /* HCA_HAS_AES */
 #if defined(HCA_HAS_SHA)
     .hash_func = {
         .sha_init = hca_sha_init,
@@ -129,6 +140,16 @@ metal_scl_t metal_sifive_scl = {
 };
 #else
 metal_scl_t metal_sifive_scl = {
+#if defined(HCA_HAS_AES)
+    .aes_func = {
+        .setkey = hca_aes_setkey,
+        .setiv  = hca_aes_setiv,
+        .cipher = hca_aes_cipher,
+        .auth_init = hca_aes_auth_init,
+        .auth_core = hca_aes_auth_core,
+        .auth_finish = hca_aes_auth_finish
+    },
+#else
     .aes_func = {
         .setkey = default_aes_setkey,
         .setiv  = default_aes_setiv,
@@ -137,6 +158,7 @@ metal_scl_t metal_sifive_scl = {
         .auth_core = default_aes_auth_core,
         .auth_finish = default_aes_auth_finish
     },
+#endif /* HCA_HAS_AES */
     .hash_func = {
         .sha_init = soft_sha_init,
         .sha_core = soft_sha_core,
@@ -197,7 +219,7 @@ int_pltfrm context_initialization(t_context *p_ctx)
 	else
 	{
 		/** Get Machine ISA information */
-		__asm__ volatile("csrr %0, misa" : "=r"(p_ctx->misa));
+		M_CSR_READ(misa, p_ctx->misa);
 		/** Assigning function pointers tables */
 		p_ctx->p_metal_sifive_scl = (volatile metal_scl_t*)&metal_sifive_scl;
 		/** Assignment for data pointers */
@@ -243,11 +265,34 @@ context_initialization_out:
 	return err;
 }
 
+#ifdef _WITH_SLBV_MULTI_HART_
+int_pltfrm main(void);
+
+/******************************************************************************/
+/** Overrides freedom-metal weak secondary_main : every hart comes here */
+int secondary_main(void)
+{
+	uint32_t									hartid = (uint32_t)metal_cpu_get_current_hartid();
+
+	if( C_SLBV_BOOT_HARTID == hartid )
+	{
+		/** Main flow */
+		return main();
+	}
+	/** Other harts wait for chunk hashing work */
+	slbv_hart_park(hartid);
+}
+
+#endif /* _WITH_SLBV_MULTI_HART_ */
 /******************************************************************************/
 int_pltfrm main(void)
 {
 	int_pltfrm 									err = GENERIC_ERR_UNKNOWN;
 
+#ifdef _WITH_SBRM_PROFILING_
+	/** Start boot-time profile, before anything else */
+	sbrm_prof_init();
+#endif /* _WITH_SBRM_PROFILING_ */
 #ifdef _FPGA_SPECIFIC_
 	/** Specific procedures and workarounds for FPGA platform */
 
@@ -255,6 +300,16 @@ int_pltfrm main(void)
 
 	/** OTP arrays are in .data section, therefore installed directly at platform initialization */
 #endif /** _FPGA_SPECIFIC_ */
+#ifdef _WITH_SLBV_WARM_RESET_
+	/** Warm reset : verified boot state from previous cold boot lets most of the flow be skipped */
+	if( ( NO_ERROR == context_initialization((t_context*)&context) ) &&
+		( NO_ERROR == sbrm_init((void*)&context, NULL, 0) ) &&
+		( NO_ERROR == slbv_init((void*)&context, NULL, 0) ) )
+	{
+		/** Only returns if record is missing or does not match platform state anymore */
+		slbv_warm_boot((t_context*)&context);
+	}
+#endif /* _WITH_SLBV_WARM_RESET_ */
 	/** Check SBR CRC */
 	err = sbrm_check_rom_crc();
 	if ( err )
@@ -276,6 +331,9 @@ int_pltfrm main(void)
 		/** It should not go by here */
 		goto main_out;
 	}
+#ifdef _WITH_SBRM_PROFILING_
+	sbrm_prof_mark(N_SBRM_PROF_CONTEXT_INIT);
+#endif /* _WITH_SBRM_PROFILING_ */
 	/** Initialize SBRM module */
 	err = sbrm_init((void*)&context, NULL, 0);
 	if ( err )
@@ -286,6 +344,9 @@ int_pltfrm main(void)
 		/** It should not go by here */
 		goto main_out;
 	}
+#ifdef _WITH_SBRM_PROFILING_
+	sbrm_prof_mark(N_SBRM_PROF_SBRM_INIT);
+#endif /* _WITH_SBRM_PROFILING_ */
 	/** Initialize PPM Module */
 	err = ppm_init((void*)&context, NULL, 0);
 	if( err )
@@ -296,6 +357,9 @@ int_pltfrm main(void)
 		/** It should not go by here */
 		goto main_out;
 	}
+#ifdef _WITH_SBRM_PROFILING_
+	sbrm_prof_mark(N_SBRM_PROF_PPM_INIT);
+#endif /* _WITH_SBRM_PROFILING_ */
 	/** Initialize SP module */
 	err = sp_init((void*)&context, NULL, 0);
 	if ( err )
@@ -306,6 +370,9 @@ int_pltfrm main(void)
 		/** It should not go by here */
 		goto main_out;
 	}
+#ifdef _WITH_SBRM_PROFILING_
+	sbrm_prof_mark(N_SBRM_PROF_SP_INIT);
+#endif /* _WITH_SBRM_PROFILING_ */
 	/** Initialize KM module */
 	err = km_init((void*)&context, NULL, 0);
 	if ( err )
@@ -316,6 +383,9 @@ int_pltfrm main(void)
 		/** It should not go by here */
 		goto main_out;
 	}
+#ifdef _WITH_SBRM_PROFILING_
+	sbrm_prof_mark(N_SBRM_PROF_KM_INIT);
+#endif /* _WITH_SBRM_PROFILING_ */
 	/** Initialize SLBV module */
 	err = slbv_init((void*)&context, NULL, 0);
 	if ( err )
@@ -326,6 +396,9 @@ int_pltfrm main(void)
 		/** It should not go by here */
 		goto main_out;
 	}
+#ifdef _WITH_SBRM_PROFILING_
+	sbrm_prof_mark(N_SBRM_PROF_SLBV_INIT);
+#endif /* _WITH_SBRM_PROFILING_ */
 	/** Perform self-tests */
 	err = sbrm_selftest((t_context*)&context);
 	if ( err )
@@ -336,6 +409,18 @@ int_pltfrm main(void)
 		/** It should not go by here */
 		goto main_out;
 	}
+#ifdef _WITH_SBRM_PROFILING_
+	sbrm_prof_mark(N_SBRM_PROF_SELFTEST);
+#endif /* _WITH_SBRM_PROFILING_ */
+#ifdef _WITH_SBRM_SELFTEST_ONLY_
+	/** Self-test build : stop once self-tests passed, no boot */
+	goto main_out;
+#endif /* _WITH_SBRM_SELFTEST_ONLY_ */
+#ifdef _WITH_SBRM_BENCH_
+	/** Benchmark build : measure primitives then stop, no boot */
+	err = sbrm_bench_run((t_context*)&context);
+	sbrm_shutdown((t_context*)&context);
+#endif /* _WITH_SBRM_BENCH_ */
 	/** Retrieve platform life cycle */
 	err = ppm_get_life_cycle((t_context*)&context);
 	if ( err )
@@ -0,0 +1,791 @@
+/******************************************************************************
+ *
+ * Secure BootRom (SBR)
+ *
+ ******************************************************************************
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+
+/**
+ * @file hal_stub.c
+ * @brief Host build only - freedom-metal HAL stub layer, lets main() boot flow
+ * run as a Linux process
+ *
+ * @copyright Copyright (c) 2020 SiFive, Inc
+ * @copyright SPDX-License-Identifier: MIT
+ */
+
+/** Global includes */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <stddef.h>
+#include <common.h>
+#include <metal/cpu.h>
+#include <metal/gpio.h>
+#include <metal/led.h>
+#include <metal/machine.h>
+#include <metal/shutdown.h>
+#include <metal/host.h>
+/** Other includes */
+#include <otp_mapping.h>
+#include <sbrm.h>
+/** Local includes */
+
+
+/** External declarations */
+extern uint8_t __otp_start;
+extern uint8_t __fake_otp_size;
+extern uint8_t __qspi_start;
+extern uint8_t __qspi_size;
+extern uint8_t __iflash_start;
+extern uint8_t __iflash_end;
+extern uint8_t __sbr_free_start_addr;
+extern uint8_t __sbr_free_end_addr;
+extern uint8_t __emmc_stage_start_addr;
+extern uint8_t __emmc_stage_end_addr;
+extern uint8_t __sdhci_start;
+extern uint8_t __sdhci_end;
+/** Local declarations */
+
+/** Structures ****************************************************************/
+struct metal_cpu
+{
+	int											hartid;
+};
+
+struct metal_interrupt
+{
+	int											enabled;
+};
+
+struct metal_uart
+{
+	/** Registers image, driver may write it although loopback transport is used */
+	uint32_t									reg[C_GENERIC_KILO / sizeof(uint32_t)];
+};
+
+struct metal_gpio
+{
+	uint32_t									pins;
+};
+
+struct metal_led
+{
+	int											on;
+};
+
+/** Stub devices */
+static struct metal_cpu							host_cpu;
+static struct metal_interrupt					host_cpu_intr;
+static struct metal_interrupt					host_plic;
+static struct metal_uart						host_uart0;
+static struct metal_led							host_led[3];
+struct metal_gpio								__metal_dt_gpio_20002000;
+/** Platform registers read by SBR : MSEL and SCR */
+static uint32_t									host_msel;
+static uint32_t									host_scr;
+/** Time references for cycle and instruction counters */
+static struct timespec							host_start;
+static struct timespec							host_cpu_start;
+/** UART pipes */
+static uint8_t									*p_host_uart_rx;
+static uint32_t									host_uart_rx_size;
+static int										host_uart_tx_fd = -1;
+#ifdef _WITH_SLBV_EMMC_
+/** SDHCI model : register page faults on each access, which is then single-stepped */
+#define	M_HOST_SDHCI							( (volatile t_reg_sdhci*)&__sdhci_start )
+static t_reg_sdhci								host_sdhci_before;
+static uintptr_t								host_sdhci_ofst;
+static int										host_sdhci_write;
+/** eMMC device behind it : boot partition 1 image, EXT_CSD and power up state */
+static uint8_t									*p_host_emmc;
+static size_t									host_emmc_size;
+static uint8_t									host_emmc_ext_csd[C_METAL_HOST_EMMC_BLOCK_SIZE];
+static uint32_t									host_emmc_busy;
+#endif /* _WITH_SLBV_EMMC_ */
+
+/******************************************************************************/
+static uint64_t metal_host_ns(clockid_t clock, const struct timespec *p_ref)
+{
+	struct timespec								now;
+
+	clock_gettime(clock, &now);
+	/** End Of Function */
+	return (uint64_t)( now.tv_sec - p_ref->tv_sec ) * 1000000000ULL + (uint64_t)now.tv_nsec - (uint64_t)p_ref->tv_nsec;
+}
+
+/******************************************************************************/
+/** Whole file (or pipe, until writer closes it) into a buffer */
+static uint8_t *metal_host_load(const char *p_path, uint8_t *p_dest, size_t max, size_t *p_size)
+{
+	FILE										*p_file;
+	size_t										size = 0;
+	size_t										alloc = 0;
+	size_t										nb;
+
+	*p_size = 0;
+	p_file = fopen(p_path, "rb");
+	if( !p_file )
+	{
+		fprintf(stderr, "[host] cannot open %s\n", p_path);
+		exit(C_METAL_HOST_EXIT_FAULT);
+	}
+	do
+	{
+		if( !p_dest && ( size == alloc ) )
+		{
+			/** Growing buffer */
+			alloc = alloc ? ( 2 * alloc ) : C_GENERIC_KILO;
+			p_dest = (uint8_t*)realloc(p_dest, alloc);
+			max = alloc;
+		}
+		nb = fread(&p_dest[size], 1, max - size, p_file);
+		size += nb;
+	} while( nb && ( size < max ) );
+	fclose(p_file);
+	*p_size = size;
+	/** End Of Function */
+	return p_dest;
+}
+
+/******************************************************************************/
+static int metal_host_in(const uint8_t *p_addr, uint8_t *p_start, uint8_t *p_end)
+{
+	return ( ( p_addr >= p_start ) && ( p_addr < p_end ) );
+}
+
+/******************************************************************************/
+static void metal_host_report(void)
+{
+#ifdef _WITH_SBRM_PROFILING_
+	volatile t_sbrm_prof_ring					*p_ring = sbrm_prof_get_ring();
+	uint32_t									i;
+	uint32_t									first;
+	uint64_t									prev;
+
+	if( C_SBRM_PROF_MAGIC != p_ring->magic )
+	{
+		return;
+	}
+	/** Oldest entries are overwritten once ring is full */
+	first = ( p_ring->count > C_SBRM_PROF_ENTRY_NB ) ? ( p_ring->count - C_SBRM_PROF_ENTRY_NB ) : 0;
+	prev = p_ring->entry[first % C_SBRM_PROF_ENTRY_NB].mcycle;
+	fprintf(stderr, "[host] stage hart ns delta_ns cpu_ns\n");
+	for( i = first;i < p_ring->count;i++ )
+	{
+		volatile t_sbrm_prof_entry				*p_entry = &p_ring->entry[i % C_SBRM_PROF_ENTRY_NB];
+
+		fprintf(stderr, "[host] %u %u %llu %llu %llu\n",
+				(unsigned int)p_entry->stage,
+				(unsigned int)p_entry->hartid,
+				(unsigned long long)p_entry->mcycle,
+				(unsigned long long)( p_entry->mcycle - prev ),
+				(unsigned long long)p_entry->minstret);
+		prev = p_entry->mcycle;
+	}
+#endif /* _WITH_SBRM_PROFILING_ */
+	/** End Of Function */
+	return;
+}
+
+#ifdef _WITH_SLBV_EMMC_
+/******************************************************************************/
+/** ADMA2 chain from ROM : 'length' bytes of 'p_src' from 'offset', erased beyond its end */
+static int metal_host_sdhci_dma(volatile t_reg_sdhci *p_reg, const uint8_t *p_src, size_t src_size, size_t offset, size_t length)
+{
+	t_sdhci_adma2_desc							*p_desc = (t_sdhci_adma2_desc*)(uintptr_t)( ( (uint64_t)p_reg->adma_addr_hi << 32 ) | p_reg->adma_addr_lo );
+	uint8_t										*p_dst;
+	size_t										size;
+	size_t										i;
+	uint32_t									nb;
+
+	for( nb = 0;length && ( nb < C_METAL_HOST_SDHCI_DESC_MAX );nb++, p_desc++ )
+	{
+		if( !( p_desc->attr & C_SDHCI_ADMA2_VALID ) )
+		{
+			break;
+		}
+		/** Null length stands for 64KiB */
+		size = p_desc->length ? p_desc->length : 0x10000;
+		size = ( size < length ) ? size : length;
+		p_dst = (uint8_t*)(uintptr_t)p_desc->address;
+		for( i = 0;i < size;i++ )
+		{
+			p_dst[i] = ( ( offset + i ) < src_size ) ? p_src[offset + i] : C_PATTERN_VIRGIN_8BITS;
+		}
+		offset += size;
+		length -= size;
+		if( p_desc->attr & C_SDHCI_ADMA2_END )
+		{
+			break;
+		}
+	}
+	/** End Of Function */
+	return length ? -1 : 0;
+}
+
+/******************************************************************************/
+/** Command register written : eMMC answers at once */
+static void metal_host_sdhci_command(volatile t_reg_sdhci *p_reg)
+{
+	uint32_t									index = ( p_reg->command >> C_SDHCI_CMD_INDEX_OFST ) & 0x3f;
+	uint32_t									arg = p_reg->argument;
+	uint16_t									status = C_SDHCI_INT_CMD_COMPLETE_MASK;
+	size_t										length = (size_t)p_reg->blkcnt * C_METAL_HOST_EMMC_BLOCK_SIZE;
+	int											err = 0;
+
+	switch( index )
+	{
+		case 0:
+			/** GO_IDLE_STATE : power up takes a few CMD1, user area selected */
+			host_emmc_busy = C_METAL_HOST_EMMC_BUSY_POLLS;
+			host_emmc_ext_csd[179] &= ~0x7;
+			break;
+		case 1:
+			/** SEND_OP_COND : sector mode, ready once busy polls are over */
+			p_reg->response[0] = 0x40ff8080 | ( host_emmc_busy ? 0 : 0x80000000 );
+			host_emmc_busy -= host_emmc_busy ? 1 : 0;
+			break;
+		case 2:
+			/** ALL_SEND_CID */
+			p_reg->response[0] = 0x00000000;
+			p_reg->response[1] = 0x484f5354;
+			p_reg->response[2] = 0x534d4d43;
+			p_reg->response[3] = 0x00150100;
+			break;
+		case 3:
+		case 13:
+			/** SET_RELATIVE_ADDR, SEND_STATUS : transfer state, ready for data */
+			p_reg->response[0] = C_METAL_HOST_EMMC_STATUS_TRAN;
+			break;
+		case 6:
+			/** SWITCH, write byte access only */
+			if( 0x3 == ( ( arg >> 24 ) & 0x3 ) )
+			{
+				host_emmc_ext_csd[( arg >> 16 ) & 0xff] = (uint8_t)( arg >> 8 );
+			}
+			p_reg->response[0] = C_METAL_HOST_EMMC_STATUS_TRAN;
+			/** End of busy */
+			status |= C_SDHCI_INT_XFER_COMPLETE_MASK;
+			break;
+		case 7:
+			/** SELECT_CARD */
+			p_reg->response[0] = C_METAL_HOST_EMMC_STATUS_TRAN;
+			status |= C_SDHCI_INT_XFER_COMPLETE_MASK;
+			break;
+		case 8:
+			/** SEND_EXT_CSD */
+			err = metal_host_sdhci_dma(p_reg, host_emmc_ext_csd, sizeof(host_emmc_ext_csd), 0, sizeof(host_emmc_ext_csd));
+			p_reg->response[0] = C_METAL_HOST_EMMC_STATUS_TRAN;
+			status |= C_SDHCI_INT_XFER_COMPLETE_MASK;
+			break;
+		case 18:
+			/** READ_MULTIPLE_BLOCK : image is boot partition 1, user area is erased */
+			err = metal_host_sdhci_dma(p_reg,
+										p_host_emmc,
+										( 0x1 == ( host_emmc_ext_csd[179] & 0x7 ) ) ? host_emmc_size : 0,
+										(size_t)arg * C_METAL_HOST_EMMC_BLOCK_SIZE,
+										length);
+			p_reg->response[0] = C_METAL_HOST_EMMC_STATUS_TRAN;
+			status |= C_SDHCI_INT_XFER_COMPLETE_MASK;
+			break;
+		case 21:
+			/** SEND_TUNING_BLOCK : first sampling point is good */
+			p_reg->host_ctrl2 = ( p_reg->host_ctrl2 & ~C_SDHCI_HOST_CTRL2_EXEC_TUNING_MASK ) | C_SDHCI_HOST_CTRL2_SAMPLING_CLK_MASK;
+			status |= C_SDHCI_INT_BUF_READ_READY_MASK;
+			break;
+		default:
+			/** No answer : command timeout */
+			err = -1;
+			break;
+	}
+	if( err )
+	{
+		p_reg->err_int_status |= 0x1;
+		status |= C_SDHCI_INT_ERROR_MASK;
+	}
+	p_reg->norm_int_status |= status;
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+/** Register access done : side effects of a write */
+static void metal_host_sdhci_written(volatile t_reg_sdhci *p_reg, uintptr_t ofst)
+{
+	switch( ofst )
+	{
+		case offsetof(t_reg_sdhci, norm_int_status):
+			/** Write 1 to clear */
+			p_reg->norm_int_status = host_sdhci_before.norm_int_status & ~p_reg->norm_int_status;
+			break;
+		case offsetof(t_reg_sdhci, err_int_status):
+			p_reg->err_int_status = host_sdhci_before.err_int_status & ~p_reg->err_int_status;
+			break;
+		case offsetof(t_reg_sdhci, command):
+			metal_host_sdhci_command(p_reg);
+			break;
+		case offsetof(t_reg_sdhci, clock_ctrl):
+			/** Internal clock is stable as soon as it is enabled */
+			p_reg->clock_ctrl = ( p_reg->clock_ctrl & C_SDHCI_CLOCK_INT_EN_MASK ) ?
+								( p_reg->clock_ctrl | C_SDHCI_CLOCK_INT_STABLE_MASK ) :
+								( p_reg->clock_ctrl & ~C_SDHCI_CLOCK_INT_STABLE_MASK );
+			break;
+		case offsetof(t_reg_sdhci, sw_reset):
+			/** Everything but capabilities is back to reset value, at once */
+			memset((void*)p_reg, 0x00, offsetof(t_reg_sdhci, capabilities));
+			break;
+		default:
+			break;
+	}
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+/** Register page fault : let access run alone, with trap flag set */
+static void metal_host_sdhci_fault(uint8_t *p_addr, void *p_uctx)
+{
+#if defined(__x86_64__)
+	ucontext_t									*p_uc = (ucontext_t*)p_uctx;
+
+	host_sdhci_ofst = (uintptr_t)( p_addr - &__sdhci_start );
+	/** Page fault error code, bit 1 : write access */
+	host_sdhci_write = ( p_uc->uc_mcontext.gregs[REG_ERR] & 0x2 ) ? 1 : 0;
+	mprotect((void*)&__sdhci_start, (size_t)( &__sdhci_end - &__sdhci_start ), PROT_READ | PROT_WRITE);
+	memcpy(&host_sdhci_before, (const void*)&__sdhci_start, sizeof(t_reg_sdhci));
+	p_uc->uc_mcontext.gregs[REG_EFL] |= C_METAL_HOST_X86_TRAP_FLAG;
+#else
+	fprintf(stderr, "[host] SDHCI model needs x86-64\n");
+	_exit(C_METAL_HOST_EXIT_FAULT);
+#endif /* __x86_64__ */
+	/** End Of Function */
+	return;
+}
+
+/******************************************************************************/
+/** Single step is over : apply access side effects, then trap next access */
+static void metal_host_sdhci_step(int sig, siginfo_t *p_info, void *p_uctx)
+{
+#if defined(__x86_64__)
+	ucontext_t									*p_uc = (ucontext_t*)p_uctx;
+
+	p_uc->uc_mcontext.gregs[REG_EFL] &= ~C_METAL_HOST_X86_TRAP_FLAG;
+#endif /* __x86_64__ */
+	if( host_sdhci_write )
+	{
+		metal_host_sdhci_written(M_HOST_SDHCI, host_sdhci_ofst);
+	}
+	mprotect((void*)&__sdhci_start, (size_t)( &__sdhci_end - &__sdhci_start ), PROT_NONE);
+	/** End Of Function */
+	return;
+}
+#endif /* _WITH_SLBV_EMMC_ */
+
+/******************************************************************************/
+static void metal_host_signal(int sig, siginfo_t *p_info, void *p_uctx)
+{
+	uint8_t										*p_addr = (uint8_t*)p_info->si_addr;
+	int											code = C_METAL_HOST_EXIT_FAULT;
+
+#ifdef _WITH_SLBV_EMMC_
+	if( ( SIGSEGV == sig ) && metal_host_in(p_addr, &__sdhci_start, &__sdhci_end) )
+	{
+		/** Not a fault : access to SDHCI model */
+		metal_host_sdhci_fault(p_addr, p_uctx);
+		return;
+	}
+#endif /* _WITH_SLBV_EMMC_ */
+	if( SIGALRM == sig )
+	{
+		/** Stands for platform watchdog */
+		fprintf(stderr, "[host] watchdog\n");
+		code = C_METAL_HOST_EXIT_WATCHDOG;
+	}
+	else if( metal_host_in(p_addr, &__qspi_start, &__qspi_start + (uintptr_t)&__qspi_size) ||
+			metal_host_in(p_addr, &__iflash_start, &__iflash_end) ||
+			metal_host_in(p_addr, &__sbr_free_start_addr, &__sbr_free_end_addr) ||
+			metal_host_in(p_addr, &__emmc_stage_start_addr, &__emmc_stage_end_addr) )
+	{
+		/** Image areas are not executable : fetch fault is the jump into SLB/SFL */
+		fprintf(stderr, "[host] jump @ %p\n", (void*)p_addr);
+		code = C_METAL_HOST_EXIT_JUMP;
+	}
+	else
+	{
+		fprintf(stderr, "[host] signal %d @ %p\n", sig, (void*)p_addr);
+	}
+	metal_host_report();
+	/** End Of Function */
+	_exit(code);
+}
+
+/******************************************************************************/
+/** Runs before main() : platform state comes from environment */
+__attribute__((constructor)) static void metal_host_start(void)
+{
+	struct sigaction							action;
+	const char									*p_env;
+	uintptr_t									page = (uintptr_t)sysconf(_SC_PAGESIZE);
+	uintptr_t									start;
+	size_t										size;
+
+	/** OTP arrays are const : make emulated OTP writable, then optionally overwrite it */
+	start = (uintptr_t)&__otp_start & ~( page - 1 );
+	mprotect((void*)start, ( (uintptr_t)&__otp_start + (uintptr_t)&__fake_otp_size ) - start, PROT_READ | PROT_WRITE);
+	p_env = getenv(C_METAL_HOST_ENV_OTP);
+	if( p_env )
+	{
+		metal_host_load(p_env, &__otp_start, (size_t)(uintptr_t)&__fake_otp_size, &size);
+	}
+	/** Boot flash content, memory mapped */
+	memset((void*)&__qspi_start, C_PATTERN_VIRGIN_8BITS, (size_t)(uintptr_t)&__qspi_size);
+	p_env = getenv(C_METAL_HOST_ENV_QSPI);
+	if( p_env )
+	{
+		metal_host_load(p_env, &__qspi_start, (size_t)(uintptr_t)&__qspi_size, &size);
+	}
+	/** SUP input is read at once, SUP output is written as it comes */
+	p_env = getenv(C_METAL_HOST_ENV_UART_IN);
+	if( p_env )
+	{
+		p_host_uart_rx = metal_host_load(p_env, NULL, 0, &size);
+		host_uart_rx_size = (uint32_t)size;
+		/** Having some input means SUP session is requested */
+		host_msel = 1;
+	}
+	p_env = getenv(C_METAL_HOST_ENV_UART_OUT);
+	if( p_env )
+	{
+		host_uart_tx_fd = open(p_env, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	}
+	p_env = getenv(C_METAL_HOST_ENV_MSEL);
+	if( p_env )
+	{
+		host_msel = (uint32_t)strtoul(p_env, NULL, 0);
+	}
+#ifdef _WITH_SLBV_EMMC_
+	/** eMMC boot partition 1 content, read through SDHCI model */
+	p_env = getenv(C_METAL_HOST_ENV_EMMC);
+	if( p_env )
+	{
+		p_host_emmc = metal_host_load(p_env, NULL, 0, &host_emmc_size);
+		/** Having an image means boot device is eMMC */
+		*(volatile uint32_t*)C_OTP_BOOTDEV_OFST = ( *(volatile uint32_t*)C_OTP_BOOTDEV_OFST & ~C_OTP_BOOTDEV_PATTERN_MASK_NOOFST ) |
+													C_OTP_BOOTDEV_EMMC_NOOFST;
+	}
+	/** 8 bits bus, HS200 at 1.8V, boot partition 1 enabled for boot */
+	host_emmc_ext_csd[196] = 0x17;
+	host_emmc_ext_csd[179] = 0x08;
+	host_emmc_ext_csd[226] = C_METAL_HOST_EMMC_BOOT_SIZE_MULT;
+	M_HOST_SDHCI->capabilities[0] = C_SDHCI_CAPS0_ADMA2_MASK | ( 200 << C_SDHCI_CAPS0_BASE_CLK_OFST );
+	M_HOST_SDHCI->capabilities[1] = C_SDHCI_CAPS1_SDR104_MASK;
+	mprotect((void*)&__sdhci_start, (size_t)( &__sdhci_end - &__sdhci_start ), PROT_NONE);
+#endif /* _WITH_SLBV_EMMC_ */
+	/** Ends of boot flow */
+	memset(&action, 0, sizeof(action));
+	action.sa_sigaction = metal_host_signal;
+	action.sa_flags = SA_SIGINFO;
+	sigaction(SIGSEGV, &action, NULL);
+	sigaction(SIGBUS, &action, NULL);
+	sigaction(SIGILL, &action, NULL);
+	sigaction(SIGALRM, &action, NULL);
+#ifdef _WITH_SLBV_EMMC_
+	action.sa_sigaction = metal_host_sdhci_step;
+	sigaction(SIGTRAP, &action, NULL);
+#endif /* _WITH_SLBV_EMMC_ */
+	p_env = getenv(C_METAL_HOST_ENV_TIMEOUT);
+	alarm(p_env ? (unsigned int)strtoul(p_env, NULL, 0) : C_METAL_HOST_TIMEOUT_DEFAULT);
+	/** Cycle counter starts with boot flow */
+	clock_gettime(CLOCK_MONOTONIC, &host_start);
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &host_cpu_start);
+	/** End Of Function */
+	return;
+}
+
+/** Host services *************************************************************/
+uint64_t metal_host_csr_read(const char *p_name)
+{
+	uint64_t									value = 0;
+
+	if( !strcmp(p_name, "mcycle") )
+	{
+		/** 1 cycle = 1ns */
+		value = metal_host_ns(CLOCK_MONOTONIC, &host_start);
+	}
+	else if( !strcmp(p_name, "minstret") )
+	{
+		/** No instruction counter : process CPU time instead */
+		value = metal_host_ns(CLOCK_PROCESS_CPUTIME_ID, &host_cpu_start);
+	}
+	else if( !strcmp(p_name, "mcycleh") )
+	{
+		value = metal_host_ns(CLOCK_MONOTONIC, &host_start) >> 32;
+	}
+	else if( !strcmp(p_name, "minstreth") )
+	{
+		value = metal_host_ns(CLOCK_PROCESS_CPUTIME_ID, &host_cpu_start) >> 32;
+	}
+	else if( !strcmp(p_name, "misa") )
+	{
+		/** RV64IMAC */
+		value = ( (uint64_t)C_MISA_WIRI_ISA_WIDTH_64BITS << 62 ) |
+				( 1 << C_MISA_EXTENSION_BIT_ATOMIC_OFST ) |
+				( 1 << C_MISA_EXTENSION_BIT_COMPRESSED_OFST ) |
+				( 1 << C_MISA_EXTENSION_BIT_RVxxI_OFST ) |
+				( 1 << C_MISA_EXTENSION_BIT_INT_MULDIV_OFST );
+	}
+	/** mhartid and others read 0 */
+	/** End Of Function */
+	return value;
+}
+
+/******************************************************************************/
+void *metal_host_platform_addr(uint64_t addr)
+{
+	void										*p_reg = NULL;
+
+	if( 0x1000 == addr )
+	{
+		p_reg = (void*)&host_msel;
+	}
+	else if( C_REG_SCR_BASE_ADDRESS == addr )
+	{
+		p_reg = (void*)&host_scr;
+	}
+	else
+	{
+		fprintf(stderr, "[host] no register @ 0x%llx\n", (unsigned long long)addr);
+		metal_host_report();
+		exit(C_METAL_HOST_EXIT_FAULT);
+	}
+	/** End Of Function */
+	return p_reg;
+}
+
+/******************************************************************************/
+void metal_host_reset(void)
+{
+	fprintf(stderr, "[host] reset\n");
+	metal_host_report();
+	exit(C_METAL_HOST_EXIT_RESET);
+}
+
+/******************************************************************************/
+uint32_t metal_host_uart_rx(uint8_t **pp_data)
+{
+	uint32_t									size = host_uart_rx_size;
+
+	/** Input is given once */
+	*pp_data = p_host_uart_rx;
+	host_uart_rx_size = 0;
+	/** End Of Function */
+	return size;
+}
+
+/******************************************************************************/
+void metal_host_uart_tx(const uint8_t *p_data, uint32_t size)
+{
+	if( 0 <= host_uart_tx_fd )
+	{
+		/** Nothing to do on a short write, Host side reads what it gets */
+		(void)!write(host_uart_tx_fd, p_data, size);
+	}
+	/** End Of Function */
+	return;
+}
+
+/** freedom-metal *************************************************************/
+void metal_shutdown(int code)
+{
+	fprintf(stderr, "[host] shutdown %d\n", code);
+	metal_host_report();
+	exit(C_METAL_HOST_EXIT_SHUTDOWN);
+}
+
+/******************************************************************************/
+int metal_cpu_get_current_hartid(void)
+{
+	return 0;
+}
+
+/******************************************************************************/
+int metal_cpu_get_num_harts(void)
+{
+	return 1;
+}
+
+/******************************************************************************/
+struct metal_cpu *metal_cpu_get(unsigned int hartid)
+{
+	return hartid ? NULL : &host_cpu;
+}
+
+/******************************************************************************/
+struct metal_interrupt *metal_cpu_interrupt_controller(struct metal_cpu *cpu)
+{
+	return cpu ? &host_cpu_intr : NULL;
+}
+
+/******************************************************************************/
+void metal_interrupt_init(struct metal_interrupt *controller)
+{
+	return;
+}
+
+/******************************************************************************/
+int metal_interrupt_register_handler(struct metal_interrupt *controller, int id, metal_interrupt_handler_t handler, void *priv_data)
+{
+	/** Nothing raises interrupts : handler is never called */
+	return 0;
+}
+
+/******************************************************************************/
+int metal_interrupt_enable(struct metal_interrupt *controller, int id)
+{
+	controller->enabled = 1;
+	return 0;
+}
+
+/******************************************************************************/
+int metal_interrupt_disable(struct metal_interrupt *controller, int id)
+{
+	controller->enabled = 0;
+	return 0;
+}
+
+/******************************************************************************/
+struct metal_interrupt *metal_interrupt_get_controller(metal_intr_cntrl_type cntrl, int id)
+{
+	return ( METAL_PLIC_CONTROLLER == cntrl ) ? &host_plic : NULL;
+}
+
+/******************************************************************************/
+void metal_uart_init(struct metal_uart *uart, int baud_rate)
+{
+	return;
+}
+
+/******************************************************************************/
+struct metal_uart *metal_uart_get_device(unsigned int device_num)
+{
+	return device_num ? NULL : &host_uart0;
+}
+
+/******************************************************************************/
+struct metal_interrupt *metal_uart_interrupt_controller(struct metal_uart *uart)
+{
+	return &host_plic;
+}
+
+/******************************************************************************/
+int metal_uart_get_interrupt_id(struct metal_uart *uart)
+{
+	return 0;
+}
+
+/******************************************************************************/
+int metal_uart_receive_interrupt_enable(struct metal_uart *uart)
+{
+	return 0;
+}
+
+/******************************************************************************/
+int metal_uart_receive_interrupt_disable(struct metal_uart *uart)
+{
+	return 0;
+}
+
+/******************************************************************************/
+unsigned long __metal_driver_sifive_uart0_control_base(struct metal_uart *uart)
+{
+	return (unsigned long)uart->reg;
+}
+
+/******************************************************************************/
+int metal_gpio_disable_input(struct metal_gpio *gpio, long pin)
+{
+	return 0;
+}
+
+/******************************************************************************/
+int metal_gpio_enable_output(struct metal_gpio *gpio, long pin)
+{
+	return 0;
+}
+
+/******************************************************************************/
+int metal_gpio_set_pin(struct metal_gpio *gpio, int pin, int value)
+{
+	/** Pins state kept, nothing drives them */
+	gpio->pins = value ? ( gpio->pins | ( 1U << pin ) ) : ( gpio->pins & ~( 1U << pin ) );
+	return 0;
+}
+
+/******************************************************************************/
+struct metal_led *metal_led_get_rgb(char *label, char *color)
+{
+	struct metal_led							*p_led = NULL;
+
+	if( !strcmp(color, "red") )
+	{
+		p_led = &host_led[0];
+	}
+	else if( !strcmp(color, "green") )
+	{
+		p_led = &host_led[1];
+	}
+	else if( !strcmp(color, "blue") )
+	{
+		p_led = &host_led[2];
+	}
+	/** End Of Function */
+	return p_led;
+}
+
+/******************************************************************************/
+void metal_led_enable(struct metal_led *led)
+{
+	return;
+}
+
+/******************************************************************************/
+void metal_led_on(struct metal_led *led)
+{
+	led->on = 1;
+	return;
+}
+
+/******************************************************************************/
+void metal_led_off(struct metal_led *led)
+{
+	led->on = 0;
+	return;
+}
+
+/******************************************************************************/
+/* End Of File */
@@ -0,0 +1,51 @@
+/******************************************************************************
+ *
+ * Secure BootRom (SBR)
+ *
+ ******************************************************************************
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+
+/**
+ * @file cpu.h
+ * @brief Host build only - freedom-metal CPU API, backed by HAL stub layer
+ *
+ * @copyright Copyright (c) 2020 SiFive, Inc
+ * @copyright SPDX-License-Identifier: MIT
+ */
+
+#ifndef _METAL_HOST_CPU_H_
+#define _METAL_HOST_CPU_H_
+
+/** Global includes */
+#include <metal/interrupt.h>
+
+/** Structures ****************************************************************/
+struct metal_cpu;
+
+/** Functions *****************************************************************/
+int metal_cpu_get_current_hartid(void);
+int metal_cpu_get_num_harts(void);
+struct metal_cpu *metal_cpu_get(unsigned int hartid);
+struct metal_interrupt *metal_cpu_interrupt_controller(struct metal_cpu *cpu);
+
+#endif /* _METAL_HOST_CPU_H_ */
+
+/******************************************************************************/
+/* End Of File */
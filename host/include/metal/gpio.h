@@ -0,0 +1,47 @@
+/******************************************************************************
+ *
+ * Secure BootRom (SBR)
+ *
+ ******************************************************************************
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+
+/**
+ * @file gpio.h
+ * @brief Host build only - freedom-metal GPIO API, no-op in HAL stub layer
+ *
+ * @copyright Copyright (c) 2020 SiFive, Inc
+ * @copyright SPDX-License-Identifier: MIT
+ */
+
+#ifndef _METAL_HOST_GPIO_H_
+#define _METAL_HOST_GPIO_H_
+
+/** Structures ****************************************************************/
+struct metal_gpio;
+
+/** Functions *****************************************************************/
+int metal_gpio_disable_input(struct metal_gpio *gpio, long pin);
+int metal_gpio_enable_output(struct metal_gpio *gpio, long pin);
+int metal_gpio_set_pin(struct metal_gpio *gpio, int pin, int value);
+
+#endif /* _METAL_HOST_GPIO_H_ */
+
+/******************************************************************************/
+/* End Of File */
@@ -0,0 +1,79 @@
+/******************************************************************************
+ *
+ * Secure BootRom (SBR)
+ *
+ ******************************************************************************
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+
+/**
+ * @file host.h
+ * @brief Host build only - services of HAL stub layer which have no freedom-metal equivalent
+ *
+ * @copyright Copyright (c) 2020 SiFive, Inc
+ * @copyright SPDX-License-Identifier: MIT
+ */
+
+#ifndef _METAL_HOST_H_
+#define _METAL_HOST_H_
+
+/** Global includes */
+#include <stdint.h>
+
+/** Defines *******************************************************************/
+/** Process exit codes, one per way the boot flow can end */
+#define	C_METAL_HOST_EXIT_JUMP					0
+#define	C_METAL_HOST_EXIT_SHUTDOWN				1
+#define	C_METAL_HOST_EXIT_RESET					2
+#define	C_METAL_HOST_EXIT_WATCHDOG				3
+#define	C_METAL_HOST_EXIT_FAULT					4
+
+/** Environment variables read at start-up */
+#define	C_METAL_HOST_ENV_OTP					"SBR_HOST_OTP"
+#define	C_METAL_HOST_ENV_QSPI					"SBR_HOST_QSPI"
+#define	C_METAL_HOST_ENV_UART_IN				"SBR_HOST_UART_IN"
+#define	C_METAL_HOST_ENV_UART_OUT				"SBR_HOST_UART_OUT"
+#define	C_METAL_HOST_ENV_MSEL					"SBR_HOST_MSEL"
+#define	C_METAL_HOST_ENV_TIMEOUT				"SBR_HOST_TIMEOUT"
+#define	C_METAL_HOST_ENV_EMMC					"SBR_HOST_EMMC"
+
+/** Default watchdog, in seconds */
+#define	C_METAL_HOST_TIMEOUT_DEFAULT			10
+
+/** SDHCI and eMMC model */
+#define	C_METAL_HOST_X86_TRAP_FLAG				0x100
+#define	C_METAL_HOST_SDHCI_DESC_MAX				128
+#define	C_METAL_HOST_EMMC_BLOCK_SIZE			512
+#define	C_METAL_HOST_EMMC_BUSY_POLLS			3
+/** Boot partition size, in 128KiB units */
+#define	C_METAL_HOST_EMMC_BOOT_SIZE_MULT		16
+/** Card status : ready for data, transfer state */
+#define	C_METAL_HOST_EMMC_STATUS_TRAN			( ( 0x1 << 8 ) | ( 0x4 << 9 ) )
+
+/** Functions *****************************************************************/
+uint64_t metal_host_csr_read(const char *p_name);
+void *metal_host_platform_addr(uint64_t addr);
+void metal_host_reset(void) __attribute__((noreturn));
+uint32_t metal_host_uart_rx(uint8_t **pp_data);
+void metal_host_uart_tx(const uint8_t *p_data, uint32_t size);
+
+#endif /* _METAL_HOST_H_ */
+
+/******************************************************************************/
+/* End Of File */
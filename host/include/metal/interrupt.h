@@ -0,0 +1,62 @@
+/******************************************************************************
+ *
+ * Secure BootRom (SBR)
+ *
+ ******************************************************************************
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+
+/**
+ * @file interrupt.h
+ * @brief Host build only - freedom-metal interrupt API, backed by HAL stub layer
+ *
+ * @copyright Copyright (c) 2020 SiFive, Inc
+ * @copyright SPDX-License-Identifier: MIT
+ */
+
+#ifndef _METAL_HOST_INTERRUPT_H_
+#define _METAL_HOST_INTERRUPT_H_
+
+/** Enumerations **************************************************************/
+typedef enum metal_intr_cntrl_type_
+{
+	METAL_CPU_CONTROLLER = 0,
+	METAL_CLINT_CONTROLLER,
+	METAL_CLIC_CONTROLLER,
+	METAL_PLIC_CONTROLLER
+
+} metal_intr_cntrl_type;
+
+/** Types definition **********************************************************/
+typedef void (*metal_interrupt_handler_t)(int, void *);
+
+/** Structures ****************************************************************/
+struct metal_interrupt;
+
+/** Functions *****************************************************************/
+void metal_interrupt_init(struct metal_interrupt *controller);
+int metal_interrupt_register_handler(struct metal_interrupt *controller, int id, metal_interrupt_handler_t handler, void *priv_data);
+int metal_interrupt_enable(struct metal_interrupt *controller, int id);
+int metal_interrupt_disable(struct metal_interrupt *controller, int id);
+struct metal_interrupt *metal_interrupt_get_controller(metal_intr_cntrl_type cntrl, int id);
+
+#endif /* _METAL_HOST_INTERRUPT_H_ */
+
+/******************************************************************************/
+/* End Of File */
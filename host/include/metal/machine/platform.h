@@ -0,0 +1,52 @@
+/******************************************************************************
+ *
+ * Secure BootRom (SBR)
+ *
+ ******************************************************************************
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+
+/**
+ * @file platform.h
+ * @brief Host build only - platform description otherwise generated from Device Tree
+ *
+ * @copyright Copyright (c) 2020 SiFive, Inc
+ * @copyright SPDX-License-Identifier: MIT
+ */
+
+#ifndef _METAL_HOST_PLATFORM_H_
+#define _METAL_HOST_PLATFORM_H_
+
+/** Defines *******************************************************************/
+/** Interrupt controller expected by sbrm_init */
+#define	METAL_RISCV_PLIC0
+
+/** No HCA : SCL runs its software implementation */
+#define	METAL_SIFIVE_HCA_0_BASE_ADDRESS			0
+
+/** SDHCI register page, modelled by hal_stub.c - see host.ld */
+extern unsigned char __sdhci_start;
+#define	METAL_SDHCI_0_BASE_ADDRESS				( (unsigned long)&__sdhci_start )
+
+#define	METAL_REG(_base_, _offset_)				( ( (unsigned long)(_base_) + (_offset_) ) )
+
+#endif /* _METAL_HOST_PLATFORM_H_ */
+
+/******************************************************************************/
+/* End Of File */
@@ -0,0 +1,53 @@
+/******************************************************************************
+ *
+ * Secure BootRom (SBR)
+ *
+ ******************************************************************************
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+
+/**
+ * @file uart.h
+ * @brief Host build only - freedom-metal UART API, backed by HAL stub layer
+ *
+ * @copyright Copyright (c) 2020 SiFive, Inc
+ * @copyright SPDX-License-Identifier: MIT
+ */
+
+#ifndef _METAL_HOST_UART_H_
+#define _METAL_HOST_UART_H_
+
+/** Global includes */
+#include <metal/interrupt.h>
+
+/** Structures ****************************************************************/
+struct metal_uart;
+
+/** Functions *****************************************************************/
+void metal_uart_init(struct metal_uart *uart, int baud_rate);
+struct metal_uart *metal_uart_get_device(unsigned int device_num);
+struct metal_interrupt *metal_uart_interrupt_controller(struct metal_uart *uart);
+int metal_uart_get_interrupt_id(struct metal_uart *uart);
+int metal_uart_receive_interrupt_enable(struct metal_uart *uart);
+int metal_uart_receive_interrupt_disable(struct metal_uart *uart);
+
+#endif /* _METAL_HOST_UART_H_ */
+
+/******************************************************************************/
+/* End Of File */
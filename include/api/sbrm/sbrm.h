@@ -54,6 +54,37 @@
 /** Polynomial for CRC32 computation */
 #define	C_SIFIVE_POLYNOMIAL						0xedb88320
 
+#ifdef _WITH_SBRM_PROFILING_
+/** Boot-time profile, at a fixed RAM location known by FSBL */
+#define	C_SBRM_PROF_MAGIC						0x31465250UL
+/** Ring buffer depth, oldest marks are overwritten */
+#define	C_SBRM_PROF_ENTRY_NB					32
+#endif /* _WITH_SBRM_PROFILING_ */
+
+#ifdef _WITH_SBRM_BENCH_
+/** Microbenchmarks : samples per measure, for fast and slow primitives */
+#define	C_SBRM_BENCH_ITER_NB					32
+#define	C_SBRM_BENCH_ITER_SLOW_NB				8
+/** Buffer sizes, multiplied by 4 from 64B up to 64KiB */
+#define	C_SBRM_BENCH_BUF_SIZE_MIN				64
+#define	C_SBRM_BENCH_BUF_SIZE_MAX				( 64 * C_GENERIC_KILO )
+/** Boot image sizes, doubled from 64KiB up to 8MiB */
+#define	C_SBRM_BENCH_SLB_SIZE_MIN				( 64 * C_GENERIC_KILO )
+#define	C_SBRM_BENCH_SLB_SIZE_MAX				( 8 * C_GENERIC_MEGA )
+/** Number of keys used for signature verification : bench root, SSK, CSK */
+#define	C_SBRM_BENCH_SIGN_KEY_NB				3
+/** Length of benchmark public key chain */
+#define	C_SBRM_BENCH_PKCHAIN_NB					3
+/** Decimal digits of an unsigned 64 bits value, and terminating zero */
+#define	C_SBRM_BENCH_U64_DIGITS					21
+/** Unit of samples */
+#ifdef _HOST_NATIVE_
+#define	C_SBRM_BENCH_UNIT						"ns"
+#else
+#define	C_SBRM_BENCH_UNIT						"cycle"
+#endif /* _HOST_NATIVE_ */
+#endif /* _WITH_SBRM_BENCH_ */
+
 /** Enumerations **************************************************************/
 typedef enum
 {
@@ -77,7 +108,9 @@ typedef enum
 	N_SBRM_BUSID_UART = N_SBRM_BUSID_MIN,
 	N_SBRM_BUSID_SPI,
 	N_SBRM_BUSID_USB,
-	N_SBRM_BUSID_MAX = N_SBRM_BUSID_USB,
+	/** Host side memory loopback */
+	N_SBRM_BUSID_LOOPBACK,
+	N_SBRM_BUSID_MAX = N_SBRM_BUSID_LOOPBACK,
 	N_SBRM_BUSID_COUNT,
 	N_SBRM_BUSID_NOBUS = 0xff
 
@@ -85,7 +118,95 @@ typedef enum
 
 
 #define	C_SBRM_BUSID_DEFAULT					N_SBRM_BUSID_UART
+
+#ifdef _WITH_SBRM_PROFILING_
+typedef enum
+{
+	/** Entering main */
+	N_SBRM_PROF_RESET = 0,
+	/** Modules initialized */
+	N_SBRM_PROF_CONTEXT_INIT,
+	N_SBRM_PROF_SBRM_INIT,
+	N_SBRM_PROF_PPM_INIT,
+	N_SBRM_PROF_SP_INIT,
+	N_SBRM_PROF_KM_INIT,
+	N_SBRM_PROF_SLBV_INIT,
+	N_SBRM_PROF_SELFTEST,
+	/** Key check */
+	N_SBRM_PROF_KM_CHECK_KEY,
+	N_SBRM_PROF_KM_CHECK_KEY_END,
+	/** Application header check */
+	N_SBRM_PROF_HEADER_CHECK,
+	/** Image hash */
+	N_SBRM_PROF_SHA,
+	N_SBRM_PROF_SHA_END,
+	/** Signature verification */
+	N_SBRM_PROF_ECDSA,
+	N_SBRM_PROF_ECDSA_END,
+	/** Image installation */
+	N_SBRM_PROF_COPY,
+	N_SBRM_PROF_COPY_END,
+	/** Jump into FSBL */
+	N_SBRM_PROF_JUMP,
+	/** Jump into FSBL, warm reset path */
+	N_SBRM_PROF_WARM_JUMP,
+	/** SUP packet received, then answered */
+	N_SBRM_PROF_SUP_PACKET,
+	N_SBRM_PROF_SUP_PACKET_END
+
+} e_sbrm_prof_stage;
+#endif /* _WITH_SBRM_PROFILING_ */
+
 /** Structures ****************************************************************/
+#ifdef _WITH_SBRM_PROFILING_
+/** Not packed : fields are naturally aligned, so that ring counter can be updated atomically */
+typedef struct
+{
+	/** e_sbrm_prof_stage */
+	uint32_t									stage;
+	/** Hart that made the mark */
+	uint32_t									hartid;
+	/** Cycles since reset */
+	uint64_t									mcycle;
+	/** Instructions retired since reset */
+	uint64_t									minstret;
+
+} t_sbrm_prof_entry;
+
+typedef struct
+{
+	/** C_SBRM_PROF_MAGIC */
+	uint32_t									magic;
+	/** Number of entries in ring */
+	uint32_t									nb_entries;
+	/** Number of marks since reset, next entry is 'count % nb_entries' */
+	uint32_t									count;
+	/** Reserved */
+	uint32_t									reserved;
+	/** Marks */
+	t_sbrm_prof_entry							entry[C_SBRM_PROF_ENTRY_NB];
+
+} t_sbrm_prof_ring;
+#endif /* _WITH_SBRM_PROFILING_ */
+
+#ifdef _WITH_SBRM_BENCH_
+typedef struct
+{
+	/** Primitive name */
+	const char									*p_name;
+	/** Variant : key, chain length ... */
+	const char									*p_variant;
+	/** Bytes processed per call, zero if not relevant */
+	uint32_t									size;
+	/** Number of samples */
+	uint32_t									nb;
+	/** Value returned by last call */
+	int_pltfrm									err;
+	/** Samples, sorted when reported */
+	uint64_t									sample[C_SBRM_BENCH_ITER_NB];
+
+} t_sbrm_bench_measure;
+#endif /* _WITH_SBRM_BENCH_ */
 
 typedef struct
 {
@@ -117,6 +238,16 @@ int_pltfrm sbrm_get_uid(t_context *p_ctx, uint8_t *p_uid);
 void sbrm_erase_contexts(t_context *p_ctx);
 void sbrm_platform_reset(t_context *p_ctx);
 void sbrm_platform_shutdown(t_context *p_ctx);
+#ifdef _WITH_SBRM_PROFILING_
+/** Profiling */
+void sbrm_prof_init(void);
+void sbrm_prof_mark(e_sbrm_prof_stage stage);
+volatile t_sbrm_prof_ring *sbrm_prof_get_ring(void);
+#endif /* _WITH_SBRM_PROFILING_ */
+#ifdef _WITH_SBRM_BENCH_
+/** Microbenchmarks */
+int_pltfrm sbrm_bench_run(t_context *p_ctx);
+#endif /* _WITH_SBRM_BENCH_ */
 
 /** Macros ********************************************************************/
 
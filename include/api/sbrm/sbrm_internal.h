@@ -41,6 +41,7 @@
 #include <metal/cpu.h>
 /** Other includes */
 /** Local includes */
+#include <sbrm.h>
 
 /** External declarations */
 /** Local declarations */
@@ -57,6 +58,21 @@
 void sbrm_set_power_mode(uint32_t power_mode);
 int_pltfrm sbrm_selftest(t_context *p_ctx);
 int_pltfrm sbrm_compute_crc(uint32_t *p_crc, uint8_t *p_data, uint32_t size);
+#ifdef _WITH_SBRM_BENCH_
+/** Microbenchmarks */
+uint64_t sbrm_bench_now(void);
+void sbrm_bench_init(t_sbrm_bench_measure *p_measure, const char *p_name, const char *p_variant, uint32_t size);
+void sbrm_bench_add(t_sbrm_bench_measure *p_measure, uint64_t start, uint64_t stop);
+uint64_t sbrm_bench_percentile(t_sbrm_bench_measure *p_measure, uint32_t percent);
+char *sbrm_bench_u64_to_str(uint64_t value, char *p_str);
+void sbrm_bench_report(t_sbrm_bench_measure *p_measure);
+int_pltfrm sbrm_bench_crc(t_context *p_ctx);
+int_pltfrm sbrm_bench_hash(t_context *p_ctx);
+int_pltfrm sbrm_bench_signature(t_context *p_ctx);
+int_pltfrm sbrm_bench_pkchain(t_context *p_ctx);
+int_pltfrm sbrm_bench_slb(t_context *p_ctx);
+int_pltfrm sbrm_bench_sup_rx(t_context *p_ctx);
+#endif /* _WITH_SBRM_BENCH_ */
 
 /** Macros ********************************************************************/
 
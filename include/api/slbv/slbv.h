@@ -39,6 +39,12 @@
 /** Other includes */
 #include <common.h>
 #include <errors.h>
+#if defined(_WITH_SLBV_QSPI_PERF_) || defined(_WITH_SLBV_EMMC_)
+#include <metal/machine/platform.h>
+#endif /* _WITH_SLBV_QSPI_PERF_ || _WITH_SLBV_EMMC_ */
+#ifdef _WITH_SLBV_QSPI_PERF_
+#include <metal/qspi.h>
+#endif /* _WITH_SLBV_QSPI_PERF_ */
 /** Local includes */
 
 /** External declarations */
@@ -58,10 +64,303 @@
 #define	C_SLBV_QSPI_PORT_ID						0x1
 #define	C_SLBV_QSPI_BAUDRATE					100000
 
+#ifdef _WITH_SLBV_QSPI_PERF_
+/** Control registers of QSPI port C_SLBV_QSPI_PORT_ID - given by platform device tree */
+#ifndef METAL_SIFIVE_SPI0_1_BASE_ADDRESS
+#error "Boot QSPI controller is not declared in platform device tree"
+#endif /* METAL_SIFIVE_SPI0_1_BASE_ADDRESS */
+#define	C_SLBV_QSPI_CTRL_BASE_ADDR				METAL_SIFIVE_SPI0_1_BASE_ADDRESS
+/** Clock divisors tried during calibration, fastest first */
+#define	C_SLBV_QSPI_SCKDIV_MIN					0x0
+#define	C_SLBV_QSPI_SCKDIV_SAFE					0x3
+/** Reads of calibration pattern needed to validate a setting */
+#define	C_SLBV_QSPI_CALIB_NB_READS				8
+/** FIFO polling */
+#define	C_SLBV_QSPI_TIMEOUT						0x10000
+/** Flash commands */
+#define	C_SLBV_QSPI_CMD_READ_JEDEC_ID			0x9f
+#define	C_SLBV_QSPI_CMD_READ_STATUS				0x05
+#define	C_SLBV_QSPI_CMD_READ_STATUS2			0x35
+#define	C_SLBV_QSPI_CMD_READ					0x03
+#define	C_SLBV_QSPI_CMD_FAST_READ				0x0b
+#define	C_SLBV_QSPI_CMD_DUAL_OUT_READ			0x3b
+#define	C_SLBV_QSPI_CMD_QUAD_OUT_READ			0x6b
+/** Dummy cycles of fast read commands */
+#define	C_SLBV_QSPI_FAST_READ_DUMMY				8
+/** JEDEC manufacturer identifiers */
+#define	C_SLBV_QSPI_JEDEC_MICRON				0x20
+#define	C_SLBV_QSPI_JEDEC_MACRONIX				0xc2
+#define	C_SLBV_QSPI_JEDEC_ISSI					0x9d
+#define	C_SLBV_QSPI_JEDEC_WINBOND				0xef
+/** Quad enable bits */
+#define	C_SLBV_QSPI_SR_QE_MASK					( 0x1 << 6 )
+#define	C_SLBV_QSPI_SR2_QE_MASK					( 0x1 << 1 )
+#endif /* _WITH_SLBV_QSPI_PERF_ */
+
 #define	C_SLBV_EMMC_PORT_ID						0x0
 
+#ifdef _WITH_SLBV_EMMC_
+/** SDHCI controller base address - given by platform device tree */
+#ifndef METAL_SDHCI_0_BASE_ADDRESS
+#error "eMMC controller is not declared in platform device tree"
+#endif /* METAL_SDHCI_0_BASE_ADDRESS */
+#define	C_SLBV_EMMC_CTRL_BASE_ADDR				METAL_SDHCI_0_BASE_ADDRESS
+/** ADMA2 descriptors hold 32 bits addresses */
+#define	C_SLBV_EMMC_ADMA2_ADDR_LIMIT			0x100000000ULL
+/** Board supplies 1.8V I/O to eMMC, needed for HS200 */
+#ifndef C_SLBV_EMMC_VCCQ_1V8
+#define	C_SLBV_EMMC_VCCQ_1V8					TRUE
+#endif /* C_SLBV_EMMC_VCCQ_1V8 */
+/** Bus clocks in kHz */
+#define	C_SLBV_EMMC_CLK_IDENT_KHZ				400
+#define	C_SLBV_EMMC_CLK_HS_KHZ					52000
+#define	C_SLBV_EMMC_CLK_HS200_KHZ				200000
+/** Polling loops */
+#define	C_SLBV_EMMC_TIMEOUT						0x100000
+#define	C_SLBV_EMMC_OCR_RETRIES					1000
+#define	C_SLBV_EMMC_TUNING_RETRIES				40
+#define	C_SLBV_EMMC_BLOCK_SIZE					512
+/** Tuning block size on 8 bits bus */
+#define	C_SLBV_EMMC_TUNING_BLOCK_SIZE			128
+/** Descriptors in one ADMA2 chain, each moves up to C_SDHCI_ADMA2_LENGTH_MAX */
+#define	C_SLBV_EMMC_ADMA2_DESC_NB				32
+/** Relative card address given to the device */
+#define	C_SLBV_EMMC_RCA							0x0001
+/** Commands */
+#define	C_SLBV_EMMC_CMD_GO_IDLE					0
+#define	C_SLBV_EMMC_CMD_SEND_OP_COND			1
+#define	C_SLBV_EMMC_CMD_ALL_SEND_CID			2
+#define	C_SLBV_EMMC_CMD_SET_RCA					3
+#define	C_SLBV_EMMC_CMD_SWITCH					6
+#define	C_SLBV_EMMC_CMD_SELECT					7
+#define	C_SLBV_EMMC_CMD_SEND_EXT_CSD			8
+#define	C_SLBV_EMMC_CMD_SEND_STATUS				13
+#define	C_SLBV_EMMC_CMD_READ_MULTIPLE			18
+#define	C_SLBV_EMMC_CMD_SEND_TUNING				21
+/** Response types */
+#define	C_SLBV_EMMC_RESP_NONE					C_SDHCI_CMD_RESP_NONE
+#define	C_SLBV_EMMC_RESP_R1						( C_SDHCI_CMD_RESP_48 | C_SDHCI_CMD_CRC_CHECK_MASK | C_SDHCI_CMD_INDEX_CHECK_MASK )
+#define	C_SLBV_EMMC_RESP_R1B					( C_SDHCI_CMD_RESP_48_BUSY | C_SDHCI_CMD_CRC_CHECK_MASK | C_SDHCI_CMD_INDEX_CHECK_MASK )
+#define	C_SLBV_EMMC_RESP_R2						( C_SDHCI_CMD_RESP_136 | C_SDHCI_CMD_CRC_CHECK_MASK )
+#define	C_SLBV_EMMC_RESP_R3						C_SDHCI_CMD_RESP_48
+/** Card status bits */
+#define	C_SLBV_EMMC_STATUS_SWITCH_ERROR_MASK	( 0x1UL << 7 )
+#define	C_SLBV_EMMC_STATUS_READY_MASK			( 0x1UL << 8 )
+/** Sector addressing, 1.7-1.95V and 2.7-3.6V */
+#define	C_SLBV_EMMC_OCR_ARG						0x40ff8080UL
+#define	C_SLBV_EMMC_OCR_READY_MASK				( 0x1UL << 31 )
+/** SWITCH command, write byte access */
+#define	M_SLBV_EMMC_SWITCH_ARG(_index_, _value_)	( ( 0x3UL << 24 ) | ( (uint32_t)(_index_) << 16 ) | ( (uint32_t)(_value_) << 8 ) )
+/** EXT_CSD fields */
+#define	C_SLBV_EMMC_EXT_CSD_PARTITION_CONFIG	179
+#define	C_SLBV_EMMC_EXT_CSD_BUS_WIDTH			183
+#define	C_SLBV_EMMC_EXT_CSD_HS_TIMING			185
+#define	C_SLBV_EMMC_EXT_CSD_DEVICE_TYPE			196
+#define	C_SLBV_EMMC_EXT_CSD_BOOT_SIZE_MULT		226
+#define	C_SLBV_EMMC_BUS_WIDTH_8					2
+#define	C_SLBV_EMMC_HS_TIMING_HS				1
+#define	C_SLBV_EMMC_HS_TIMING_HS200				2
+#define	C_SLBV_EMMC_DEVICE_TYPE_HS200_1V8		( 0x1 << 4 )
+#define	C_SLBV_EMMC_BOOT_SIZE_UNIT				( 128 * C_GENERIC_KILO )
+/** PARTITION_CONFIG : enabled boot partition and partition access */
+#define	C_SLBV_EMMC_PART_CFG_ACCESS_MASK		0x7
+#define	C_SLBV_EMMC_PART_CFG_ENABLE_OFST			3
+#define	C_SLBV_EMMC_PART_CFG_ENABLE_MASK_NOOFST	0x7
+#define	C_SLBV_EMMC_PART_CFG_ENABLE_USER		0x7
+#endif /* _WITH_SLBV_EMMC_ */
+
 #define	GPT_GUID_SIZE							16
 
+#ifdef _WITH_SLBV_CHUNKED_IMAGE_
+/** Chunked (v2) image descriptor, placed right after secure header */
+#define	C_SLBV_CHUNK_DESC_MAGIC					0x32b4c7e1UL
+/** Leaf hash is SHA-384 */
+#define	C_SLBV_CHUNK_HASH_SIZE					SHA384_BYTE_HASHSIZE
+/** Chunk size boundaries : 512 Bytes to 64 KBytes, 4 KBytes expected */
+#define	C_SLBV_CHUNK_SIZE_LOG2_MIN				9
+#define	C_SLBV_CHUNK_SIZE_LOG2_MAX				16
+#define	C_SLBV_CHUNK_SIZE_LOG2_DEFAULT			12
+/** Maximum number of leaves in chunk table */
+#define	C_SLBV_CHUNK_NB_MAX						1024
+#endif /* _WITH_SLBV_CHUNKED_IMAGE_ */
+
+#ifdef _WITH_SLBV_COMPRESSED_IMAGE_
+/** Compressed image descriptor, at beginning of binary */
+#define	C_SLBV_COMP_DESC_MAGIC					0x7a4c5a34UL
+/** Block header : stored flag and size of block data, zero size ends stream */
+#define	C_SLBV_COMP_BLOCK_SIZE_OFST				0
+#define	C_SLBV_COMP_BLOCK_SIZE_MASK_NOOFST		0x7fffffffUL
+#define	C_SLBV_COMP_BLOCK_SIZE_MASK				( C_SLBV_COMP_BLOCK_SIZE_MASK_NOOFST << C_SLBV_COMP_BLOCK_SIZE_OFST )
+
+#define	C_SLBV_COMP_BLOCK_STORED_OFST			31
+#define	C_SLBV_COMP_BLOCK_STORED_MASK_NOOFST	0x1UL
+#define	C_SLBV_COMP_BLOCK_STORED_MASK			( C_SLBV_COMP_BLOCK_STORED_MASK_NOOFST << C_SLBV_COMP_BLOCK_STORED_OFST )
+/** Maximum block size, as LZ4 frame format */
+#define	C_SLBV_COMP_BLOCK_SIZE_MAX				( 4 * 1024 * 1024 )
+/** LZ4 sequence token */
+#define	C_SLBV_LZ4_TOKEN_LITERAL_OFST			4
+#define	C_SLBV_LZ4_TOKEN_LENGTH_MASK			0xf
+#define	C_SLBV_LZ4_MIN_MATCH					4
+#endif /* _WITH_SLBV_COMPRESSED_IMAGE_ */
+
+#ifdef _WITH_SLBV_ENCRYPTED_IMAGE_
+/** Encrypted image descriptor, at beginning of binary */
+#define	C_SLBV_ENC_DESC_MAGIC					0x3e1c5a7dUL
+/** Copy, hash and decryption are done on chunks of this size */
+#define	C_SLBV_ENC_CHUNK_SIZE					( 4 * C_GENERIC_KILO )
+/** AES block and round keys */
+#define	C_SLBV_AES_BLOCK_SIZE					0x10
+#define	C_SLBV_AES_NB_ROUNDS_128				10
+#define	C_SLBV_AES_NB_ROUNDS_256				14
+#define	C_SLBV_AES_RK_NB_WORDS					( 4 * ( C_SLBV_AES_NB_ROUNDS_256 + 1 ) )
+#endif /* _WITH_SLBV_ENCRYPTED_IMAGE_ */
+
+#ifdef _WITH_SLBV_MANIFEST_
+/** Manifest, placed right after secure header */
+#define	C_SLBV_MANIFEST_MAGIC					0x6d4e4631UL
+/** Maximum number of load segments */
+#define	C_SLBV_MANIFEST_SEG_MAX					8
+#endif /* _WITH_SLBV_MANIFEST_ */
+
+#ifdef _WITH_SLBV_BOOT_PROBE_
+/** Flash reset and read mode setup rely on QSPI direct mode helpers */
+#ifndef _WITH_SLBV_QSPI_PERF_
+#error "Boot device probing needs _WITH_SLBV_QSPI_PERF_"
+#endif /* _WITH_SLBV_QSPI_PERF_ */
+/** Nothing to run in parallel with a single boot device */
+#ifndef _WITH_SLBV_EMMC_
+#error "Boot device probing needs more than one boot device : _WITH_SLBV_EMMC_"
+#endif /* _WITH_SLBV_EMMC_ */
+/** Boot devices started together, at most one per BOOTDEV pattern */
+#define	C_SLBV_PROBE_DEVICE_MAX					C_OTP_BOOT_ORDER_ENTRY_NB
+/** Per device budgets, in mcycle ticks, from device start up to valid header */
+#ifndef C_SLBV_PROBE_QSPI_BUDGET
+#define	C_SLBV_PROBE_QSPI_BUDGET				0x00400000UL
+#endif /* C_SLBV_PROBE_QSPI_BUDGET */
+#ifndef C_SLBV_PROBE_EMMC_BUDGET
+#define	C_SLBV_PROBE_EMMC_BUDGET				0x10000000UL
+#endif /* C_SLBV_PROBE_EMMC_BUDGET */
+/** Flash software reset recovery time (tRST), in mcycle ticks */
+#define	C_SLBV_PROBE_QSPI_RESET_CYCLES			0x00010000UL
+/** Flash software reset and status commands */
+#define	C_SLBV_QSPI_CMD_RESET_ENABLE			0x66
+#define	C_SLBV_QSPI_CMD_RESET					0x99
+#define	C_SLBV_QSPI_SR_WIP_MASK					0x1
+#endif /* _WITH_SLBV_BOOT_PROBE_ */
+
+#ifdef _WITH_SLBV_HEADER_V2_
+/** Header v2 segment table, placed right after signature(s) */
+#define	C_SLBV_V2_MAGIC							0x32524448UL
+/** Maximum number of segments */
+#define	C_SLBV_V2_SEG_MAX						16
+/** Segment flags */
+#define	C_SLBV_V2_SEG_FLAG_ZERO_FILL			0x1
+#define	C_SLBV_V2_SEG_FLAG_XIP					0x2
+#define	C_SLBV_V2_SEG_FLAG_COMPRESSED			0x4
+#define	C_SLBV_V2_SEG_FLAGS_ALL					( C_SLBV_V2_SEG_FLAG_ZERO_FILL | C_SLBV_V2_SEG_FLAG_XIP | C_SLBV_V2_SEG_FLAG_COMPRESSED )
+/** Stored segments are copied then hashed by blocks of this size */
+#define	C_SLBV_V2_COPY_BLOCK_SIZE				( 4 * C_GENERIC_KILO )
+#endif /* _WITH_SLBV_HEADER_V2_ */
+
+#ifdef _WITH_SLBV_AB_SLOTS_
+/** Number of image slots on boot device */
+#define	C_SLBV_AB_SLOT_NB						2
+#define	C_SLBV_AB_SLOT_A						0
+#define	C_SLBV_AB_SLOT_B						1
+/** Slot size, slot 'n' starts at boot address + ( n * C_SLBV_AB_SLOT_SIZE ) - boot flash layout, may be set at build time */
+#ifndef C_SLBV_AB_SLOT_SIZE
+#define	C_SLBV_AB_SLOT_SIZE						( 8 * C_GENERIC_MEGA )
+#endif /* C_SLBV_AB_SLOT_SIZE */
+/** Boot record, right after last slot : slots are only used when boot flash holds it */
+#define	C_SLBV_AB_RECORD_OFST					( C_SLBV_AB_SLOT_NB * C_SLBV_AB_SLOT_SIZE )
+#define	C_SLBV_AB_RECORD_MAGIC					0x31524241UL
+#endif /* _WITH_SLBV_AB_SLOTS_ */
+
+#ifdef _WITH_SLBV_LAZY_XIP_
+#ifndef _WITH_SLBV_CHUNKED_IMAGE_
+#error [_WITH_SLBV_LAZY_XIP_] Deferred verification applies to chunked images only
+#endif /* _WITH_SLBV_CHUNKED_IMAGE_ */
+/** Leaves are copied in RAM for deferred checks, bigger images are verified upfront */
+#define	C_SLBV_LAZY_CHUNK_NB_MAX				64
+/** PMP entries owned by ROM while armed : verified windows, then TOR deny rule on XiP image */
+#define	C_SLBV_LAZY_PMP_WINDOW_NB				6
+#define	C_SLBV_LAZY_PMP_BOTTOM					6
+#define	C_SLBV_LAZY_PMP_DENY					7
+/** PMP configuration byte */
+#define	C_SLBV_PMP_CFG_R						0x01
+#define	C_SLBV_PMP_CFG_W						0x02
+#define	C_SLBV_PMP_CFG_X						0x04
+#define	C_SLBV_PMP_CFG_A_OFF					0x00
+#define	C_SLBV_PMP_CFG_A_TOR					0x08
+#define	C_SLBV_PMP_CFG_A_NAPOT					0x18
+#define	C_SLBV_PMP_CFG_L						0x80
+/** Smepmp mseccfg CSR : Rule Locking Bypass lets ROM open windows in locked rules */
+#define	C_SLBV_CSR_MSECCFG						0x747
+#define	C_SLBV_MSECCFG_RLB_MASK					( 0x1UL << 2 )
+/** mcause values handled by ROM */
+#define	C_SLBV_MCAUSE_INSTR_ACCESS_FAULT		1
+#define	C_SLBV_MCAUSE_LOAD_ACCESS_FAULT			5
+/** Registers saved by trap entry : ra, t0-t6, a0-a7 */
+#if __riscv_xlen == 64
+#define	M_SLBV_LAZY_SAVE(_reg_, _idx_)			"sd " #_reg_ ", " #_idx_ "*8(sp)\n"
+#define	M_SLBV_LAZY_RESTORE(_reg_, _idx_)		"ld " #_reg_ ", " #_idx_ "*8(sp)\n"
+#define	M_SLBV_LAZY_FRAME_SIZE					"128"
+#else
+#define	M_SLBV_LAZY_SAVE(_reg_, _idx_)			"sw " #_reg_ ", " #_idx_ "*4(sp)\n"
+#define	M_SLBV_LAZY_RESTORE(_reg_, _idx_)		"lw " #_reg_ ", " #_idx_ "*4(sp)\n"
+#define	M_SLBV_LAZY_FRAME_SIZE					"64"
+#endif /* __riscv_xlen */
+#endif /* _WITH_SLBV_LAZY_XIP_ */
+
+#ifdef _WITH_SLBV_INCREMENTAL_
+#ifndef _WITH_SLBV_CHUNKED_IMAGE_
+#error [_WITH_SLBV_INCREMENTAL_] Re-verification works on chunks of image
+#endif /* _WITH_SLBV_CHUNKED_IMAGE_ */
+/** Record of installed chunks, kept in retention RAM across resets */
+#define	C_SLBV_INC_RECORD_MAGIC					0x31434e49UL
+/** Record MAC prefix, chunk tags use ( session << 32 | chunk index ) */
+#define	C_SLBV_INC_RECORD_PREFIX				0xffffffffUL
+#endif /* _WITH_SLBV_INCREMENTAL_ */
+
+#ifdef _WITH_SLBV_WARM_RESET_
+/** Verified boot state, at end of retention RAM */
+#define	C_SLBV_WARM_RECORD_MAGIC				0x4d524157UL
+#define	C_SLBV_WARM_RECORD_PREFIX				0xfffffffeUL
+/** Consecutive warm boots before a cold path is forced, giving SUP a chance */
+#define	C_SLBV_WARM_BOOT_MAX					16
+#endif /* _WITH_SLBV_WARM_RESET_ */
+
+#if defined(_WITH_SLBV_INCREMENTAL_) || defined(_WITH_SLBV_WARM_RESET_)
+/** Boot-session MAC : SipHash-2-4, 128 bits key, 64 bits tag */
+#define	C_SLBV_MAC_KEY_SIZE						0x10
+#define	C_SLBV_SIPHASH_C_ROUNDS					2
+#define	C_SLBV_SIPHASH_D_ROUNDS					4
+#endif /* _WITH_SLBV_INCREMENTAL_ || _WITH_SLBV_WARM_RESET_ */
+
+#if defined(_WITH_SLBV_COMPRESSED_IMAGE_) || defined(_WITH_SLBV_ENCRYPTED_IMAGE_)
+/** Binary is installed at destination while hashed */
+#define	_WITH_SLBV_STREAMED_INSTALL_
+#endif /* _WITH_SLBV_COMPRESSED_IMAGE_ || _WITH_SLBV_ENCRYPTED_IMAGE_ */
+
+#ifdef _WITH_SLBV_MULTI_HART_
+#ifndef _WITH_SLBV_CHUNKED_IMAGE_
+#error [_WITH_SLBV_MULTI_HART_] Work distribution applies to chunked images only
+#endif /* _WITH_SLBV_CHUNKED_IMAGE_ */
+/** Hart running Secure Boot ROM main flow (monitor core) */
+#define	C_SLBV_BOOT_HARTID						0
+/** Harts handled by work distribution layer : monitor core + 4 application cores */
+#define	C_SLBV_HART_NB_MAX						5
+/** Loop count main hart waits for a parked hart to take its work descriptor */
+#define	C_SLBV_HART_PICKUP_TIMEOUT				0x10000
+/** mcycle budget per byte of share once a parked hart took it : software SHA reading boot flash, with margin */
+#define	C_SLBV_HART_WORK_CYCLES_PER_BYTE		0x400
+/** CLINT software interrupt pending registers */
+#define	C_SLBV_CLINT_BASE_ADDR					0x02000000UL
+#define	C_SLBV_CLINT_MSIP(_hart_)				( *( (volatile uint32_t*)( C_SLBV_CLINT_BASE_ADDR + ( (_hart_) * sizeof(uint32_t) ) ) ) )
+/** mie.MSIE */
+#define	C_SLBV_MIE_MSIE_MASK					( 0x1UL << 3 )
+#endif /* _WITH_SLBV_MULTI_HART_ */
+
 /** Enumerations **************************************************************/
 typedef enum
 {
@@ -100,12 +399,82 @@ typedef enum
 	N_SLBV_ERR_GPT_PARTITION_NOT_FOUND,
 	N_SLBV_ERR_GPT_INVALID_PARTITION,
 	N_SLBV_ERR_INTERFACE_NOT_INITIALIZED,
+	N_SLBV_ERR_CHUNK_DESC_INVALID,
+	N_SLBV_ERR_CHUNK_ROOT_MISMATCH,
+	N_SLBV_ERR_CHUNK_HASH_MISMATCH,
+	N_SLBV_ERR_HART_TIMEOUT,
+	N_SLBV_ERR_DECOMPRESSION_FAILURE,
+	N_SLBV_ERR_DECRYPTION_FAILURE,
+	N_SLBV_ERR_NO_DECRYPTION_KEY,
+	N_SLBV_ERR_MANIFEST_INVALID,
+	N_SLBV_ERR_MANIFEST_SEGMENT_MISMATCH,
+	N_SLBV_ERR_MANIFEST_NO_BOOT_SEGMENT,
+	N_SLBV_ERR_AB_NO_VALID_SLOT,
+	N_SLBV_ERR_OTP_WRITE_FAILURE,
+	N_SLBV_ERR_WARM_RECORD_INVALID,
+	N_SLBV_ERR_WARM_STATE_MISMATCH,
+	N_SLBV_ERR_V2_SEGMENT_INVALID,
+	N_SLBV_ERR_V2_SEGMENT_MISMATCH,
+	N_SLBV_ERR_PROBE_TIMEOUT,
+	N_SLBV_ERR_PROBE_NO_DEVICE,
 	N_SLBV_ERR_,
 	N_SLBV_ERR_MAX = N_SLBV_ERR_,
 	N_SLBV_ERR_COUNT
 
 } e_slbv_error;
 
+#ifdef _WITH_SLBV_STREAMED_INSTALL_
+typedef enum
+{
+	/** Binary copied verbatim after verification */
+	N_SLBV_STREAM_NONE = 0,
+	/** LZ4 blocks */
+	N_SLBV_STREAM_LZ4,
+	/** AES-CTR ciphertext */
+	N_SLBV_STREAM_AES_CTR
+
+} e_slbv_stream_type;
+#endif /* _WITH_SLBV_STREAMED_INSTALL_ */
+
+#ifdef _WITH_SLBV_BOOT_PROBE_
+typedef enum
+{
+	/** Not a candidate, or not started yet */
+	N_SLBV_PROBE_IDLE = 0,
+	/** Started, not answering yet */
+	N_SLBV_PROBE_PENDING,
+	/** Valid header found */
+	N_SLBV_PROBE_READY,
+	/** Absent, broken, blank or too slow */
+	N_SLBV_PROBE_FAILED
+
+} e_slbv_probe_state;
+#endif /* _WITH_SLBV_BOOT_PROBE_ */
+
+#ifdef _WITH_SLBV_MULTI_HART_
+typedef enum
+{
+	/** No work, or work given back to main hart */
+	N_SLBV_HART_WORK_IDLE = 0,
+	/** Posted by main hart */
+	N_SLBV_HART_WORK_POSTED,
+	/** Taken by parked hart */
+	N_SLBV_HART_WORK_BUSY,
+	/** Result available */
+	N_SLBV_HART_WORK_DONE
+
+} e_slbv_hart_work_state;
+
+typedef enum
+{
+	/** Check range of chunks */
+	N_SLBV_HART_JOB_CHUNKS = 0,
+	/** Jump to entry point */
+	N_SLBV_HART_JOB_JUMP
+
+} e_slbv_hart_job;
+#endif /* _WITH_SLBV_MULTI_HART_ */
+
 typedef enum
 {
 	/**  */
@@ -123,6 +492,241 @@ typedef int_pltfrm (*__fct_ptr_enrty64)(void);
 typedef intmax_t (*__fct_ptr_enrty128)(void);
 #endif /* _WITH_128BITS_ADDRESSING_ */
 
+#ifdef _WITH_SLBV_CHUNKED_IMAGE_
+typedef struct __attribute__((packed))
+{
+	/** Descriptor magic word */
+	uint32_t									magic;
+	/** Chunk size, as power of 2 */
+	uint8_t										chunk_size_log2;
+	/** Reserved, must be zero */
+	uint8_t										reserved[3];
+	/** Number of chunks (leaves) covering raw binary */
+	uint32_t									nb_chunks;
+	/** Root of the chunk hash tree : SHA-384 over leaf hashes */
+	uint8_t										root[C_SLBV_CHUNK_HASH_SIZE];
+
+} t_slbv_chunk_desc;
+#endif /* _WITH_SLBV_CHUNKED_IMAGE_ */
+
+#ifdef _WITH_SLBV_COMPRESSED_IMAGE_
+typedef struct __attribute__((packed))
+{
+	/** Descriptor magic word */
+	uint32_t									magic;
+	/** Size of decompressed binary */
+	uint32_t									uncompressed_size;
+
+} t_slbv_comp_desc;
+#endif /* _WITH_SLBV_COMPRESSED_IMAGE_ */
+
+#ifdef _WITH_SLBV_AB_SLOTS_
+/** Boot record, written by update agent only : ROM keeps boot attempts outcome in RAM, so an
+ * active slot failing verification is verified again on next boot, until update agent switches it */
+typedef struct __attribute__((packed))
+{
+	/** Record magic word */
+	uint32_t									magic;
+	/** Slot to try first */
+	uint8_t										active_slot;
+	/** Reserved, must be zero */
+	uint8_t										reserved[3];
+	/** Record update counter, for update agent's own use */
+	uint32_t									sequence;
+	/** CRC32 of fields above */
+	uint32_t									crc;
+
+} t_slbv_ab_record;
+#endif /* _WITH_SLBV_AB_SLOTS_ */
+
+#ifdef _WITH_SLBV_MANIFEST_
+typedef struct __attribute__((packed))
+{
+	/** Target core - e_slbv_slb_id */
+	uint8_t										slb_id;
+	/** Reserved, must be zero */
+	uint8_t										reserved[3];
+	/** Harts to start on this segment, once main hart jumps */
+	uint32_t									hart_mask;
+	/** Segment offset from beginning of secure header */
+	uint32_t									offset;
+	/** Segment size */
+	uint32_t									size;
+	/** Copy Address, virgin for XiP */
+	uint32_t									copy_address[( C_ADDRESS_SIZE_MAX / sizeof(uint32_t) )];
+	/** Execution Address */
+	uint32_t									execution_address[( C_ADDRESS_SIZE_MAX / sizeof(uint32_t) )];
+	/** SHA-384 of segment */
+	uint8_t										digest[SHA384_BYTE_HASHSIZE];
+
+} t_slbv_manifest_seg;
+
+typedef struct __attribute__((packed))
+{
+	/** Manifest magic word */
+	uint32_t									magic;
+	/** Number of segments */
+	uint32_t									nb_segments;
+	/** Segments, only 'nb_segments' ones are present and signed */
+	t_slbv_manifest_seg							segment[C_SLBV_MANIFEST_SEG_MAX];
+
+} t_slbv_manifest;
+#endif /* _WITH_SLBV_MANIFEST_ */
+
+#ifdef _WITH_SLBV_INCREMENTAL_
+/** Installed image record, in retention RAM */
+typedef struct
+{
+	/** Record magic word */
+	uint32_t									magic;
+	/** Boot session, MAC key is derived from it */
+	uint32_t									session;
+	/** Destination area of installed binary */
+	uint64_t									dst;
+	/** Raw binary size */
+	uint32_t									raw_size;
+	/** Number of chunks */
+	uint32_t									nb_chunks;
+	/** Hash of leaves table, matched against signed root */
+	uint8_t										leaves_digest[C_SLBV_CHUNK_HASH_SIZE];
+	/** Per chunk tags, computed on installed chunk once verified */
+	uint64_t									tag[C_SLBV_CHUNK_NB_MAX];
+	/** MAC of fields above */
+	uint64_t									mac;
+
+} t_slbv_inc_record;
+#endif /* _WITH_SLBV_INCREMENTAL_ */
+
+#ifdef _WITH_SLBV_WARM_RESET_
+/** Verified boot state, in retention RAM */
+typedef struct
+{
+	/** Record magic word */
+	uint32_t									magic;
+	/** Warm boots since record has been sealed by a cold boot */
+	uint32_t									nb_warm;
+	/** Random number drawn by sealing cold boot, MAC key is derived from it */
+	uint64_t									nonce;
+	/** Life cycle pattern */
+	uint32_t									lcp;
+	/** CSK slot used, and hash of its OTP area */
+	uint32_t									csk_slot;
+	uint8_t										csk_digest[SHA384_BYTE_HASHSIZE];
+	/** Range holding executed binary, and its hash */
+	uint64_t									image_addr;
+	uint32_t									image_size;
+	/** Firmware version from verified header, checked against anti-rollback counter */
+	uint32_t									firmware_version;
+	uint8_t										image_digest[SHA384_BYTE_HASHSIZE];
+	/** Jump address */
+	uint64_t									jump_addr;
+	/** MAC of fields above */
+	uint64_t									mac;
+
+} t_slbv_warm_record;
+#endif /* _WITH_SLBV_WARM_RESET_ */
+
+#ifdef _WITH_SLBV_HEADER_V2_
+typedef struct __attribute__((packed))
+{
+	/** Final address, ignored for XiP segment */
+	uint64_t									load_address;
+	/** Stored data offset from beginning of secure header */
+	uint64_t									offset;
+	/** Stored data size, compressed stream size if compressed, zero if zero-filled */
+	uint64_t									file_size;
+	/** Size at final address, tail beyond stored or decompressed data is zero-filled */
+	uint64_t									mem_size;
+	/** C_SLBV_V2_SEG_FLAG_* */
+	uint32_t									flags;
+	/** Reserved, must be zero */
+	uint32_t									reserved;
+	/** SHA-384 of stored data */
+	uint8_t										digest[SHA384_BYTE_HASHSIZE];
+
+} t_slbv_v2_seg;
+
+typedef struct __attribute__((packed))
+{
+	/** Segment table magic word */
+	uint32_t									magic;
+	/** Number of segments */
+	uint32_t									nb_segments;
+	/** Image size on boot device, 64 bits */
+	uint64_t									image_size;
+	/** Segments, only 'nb_segments' ones are present and signed */
+	t_slbv_v2_seg								segment[C_SLBV_V2_SEG_MAX];
+
+} t_slbv_v2_table;
+#endif /* _WITH_SLBV_HEADER_V2_ */
+
+#if defined(_WITH_SLBV_MANIFEST_) || defined(_WITH_SLBV_HEADER_V2_)
+/** Area written while installing a segment */
+typedef struct
+{
+	uint_pltfrm									dst;
+	uint_pltfrm									size;
+
+} t_slbv_installed_area;
+#endif /* _WITH_SLBV_MANIFEST_ || _WITH_SLBV_HEADER_V2_ */
+
+#ifdef _WITH_SLBV_ENCRYPTED_IMAGE_
+typedef struct __attribute__((packed))
+{
+	/** Descriptor magic word */
+	uint32_t									magic;
+	/** AES key size in bytes : 16 or 32 */
+	uint32_t									key_size;
+	/** Size of ciphertext following descriptor */
+	uint32_t									payload_size;
+	/** Reserved, must be zero */
+	uint32_t									reserved;
+	/** Initial counter block */
+	uint8_t										iv[C_SLBV_AES_BLOCK_SIZE];
+
+} t_slbv_enc_desc;
+
+typedef struct
+{
+	/** Raw key, used as is by HCA */
+	__attribute__((aligned(0x8))) uint8_t		key[C_AES256_SIZE];
+	/** Key size in bytes */
+	uint32_t									key_size;
+	/** Number of rounds */
+	uint32_t									nb_rounds;
+	/** Expanded round keys, for software kernel */
+	uint32_t									rk[C_SLBV_AES_RK_NB_WORDS];
+
+} t_slbv_aes_ctx;
+#endif /* _WITH_SLBV_ENCRYPTED_IMAGE_ */
+
+#ifdef _WITH_SLBV_MULTI_HART_
+typedef struct
+{
+	/** Work state - e_slbv_hart_work_state */
+	uint32_t									state;
+	/** Job type - e_slbv_hart_job */
+	uint32_t									type;
+	/** Entry point, for jump job */
+	uint_pltfrm									entry;
+	/** Global context */
+	t_context									*p_ctx;
+	/** First chunk index */
+	uint32_t									first;
+	/** Number of chunks */
+	uint32_t									count;
+	/** Raw binary source address */
+	uint_pltfrm									src;
+	/** Raw binary destination address */
+	uint_pltfrm									dst;
+	/** Raw binary size */
+	uint32_t									raw_binary_size;
+	/** Result of chunks verification */
+	int_pltfrm									result;
+
+} t_slbv_hart_work;
+#endif /* _WITH_SLBV_MULTI_HART_ */
+
 typedef struct
 {
 	/** Does application need decryption ? */
@@ -146,6 +750,212 @@ typedef struct
 		struct metal_emmc						*emmc;
 
 	} boot;
+#ifdef _WITH_SLBV_EMMC_
+	/** eMMC boot device */
+	struct
+	{
+		/** Controller registers */
+		volatile t_reg_sdhci					*p_reg;
+		/** Is card initialized and readable ? */
+		uint8_t									ready;
+		/** Has image been staged in RAM for this boot ? */
+		uint8_t									loaded;
+		/** Bus running in HS200 mode ? */
+		uint8_t									hs200;
+		/** Size of partition holding image */
+		uint32_t								partition_size;
+		/** Number of bytes staged */
+		uint32_t								size;
+
+	} emmc;
+#endif /* _WITH_SLBV_EMMC_ */
+#ifdef _WITH_SLBV_QSPI_PERF_
+	/** Boot flash read mode */
+	struct
+	{
+		/** Has read mode been set up for this boot ? */
+		uint8_t									done;
+		/** JEDEC identifier : manufacturer, type, capacity */
+		uint8_t									jedec_id[3];
+		/** Applied configuration - OTP QSPI_CFG format */
+		uint32_t								cfg;
+
+	} qspi_perf;
+#endif /* _WITH_SLBV_QSPI_PERF_ */
+#ifdef _WITH_SLBV_BOOT_PROBE_
+	/** Boot devices probing */
+	struct
+	{
+		/** Has probing been done for this boot ? */
+		uint8_t									done;
+		/** Number of candidates */
+		uint32_t								nb_devices;
+		/** Index of device in use */
+		uint32_t								selected;
+		/** Candidates, highest priority first */
+		struct
+		{
+			/** BOOTDEV pattern */
+			uint32_t							bootdev;
+			/** e_slbv_probe_state */
+			uint8_t								state;
+			/** Device specific step */
+			uint8_t								phase;
+			/** Cause of failure */
+			int_pltfrm							err;
+			/** mcycle when started */
+			uint_pltfrm							start;
+			/** mcycle ticks up to ready or failure */
+			uint_pltfrm							elapsed;
+
+		} device[C_SLBV_PROBE_DEVICE_MAX];
+
+	} probe;
+#endif /* _WITH_SLBV_BOOT_PROBE_ */
+#ifdef _WITH_SLBV_AB_SLOTS_
+	/** A/B slots information */
+	struct
+	{
+		/** Slot given by boot record */
+		uint32_t								active;
+		/** Slot size on boot device, whole device when there is no boot record, zero if unknown */
+		uint_pltfrm								slot_size;
+		/** Slot under verification */
+		uint32_t								current;
+		/** Slots passing pre-checks, in trial order */
+		uint32_t								candidate[C_SLBV_AB_SLOT_NB];
+		uint32_t								nb_candidates;
+		/** Boot attempt record : per slot outcome */
+		struct
+		{
+			/** Has full verification been performed ? */
+			uint8_t								tried;
+			/** Pre-check or verification result */
+			int_pltfrm							err;
+
+		} attempt[C_SLBV_AB_SLOT_NB];
+
+	} ab;
+#endif /* _WITH_SLBV_AB_SLOTS_ */
+#ifdef _WITH_SLBV_CHUNKED_IMAGE_
+	/** Chunked (v2) image information */
+	struct
+	{
+		/** Is application image chunked ? */
+		uint8_t									enabled;
+		/** Pointer on chunk descriptor (signed along with header) */
+		volatile t_slbv_chunk_desc				*p_desc;
+		/** Pointer on leaf hashes table */
+		volatile uint8_t						*p_leaves;
+		/** Chunk size in bytes */
+		uint32_t								size;
+
+	} chunk;
+#endif /* _WITH_SLBV_CHUNKED_IMAGE_ */
+#ifdef _WITH_SLBV_INCREMENTAL_
+	/** Incremental re-verification information */
+	struct
+	{
+		/** Boot-session MAC key, wiped once record is written */
+		__attribute__((aligned(0x8))) uint8_t	key[C_SLBV_MAC_KEY_SIZE];
+		/** Was record from previous boot usable ? */
+		uint8_t									reused;
+		/** Number of chunks copied and hashed again */
+		uint32_t								nb_rehashed;
+
+	} inc;
+#endif /* _WITH_SLBV_INCREMENTAL_ */
+#ifdef _WITH_SLBV_WARM_RESET_
+	/** Range holding binary jumped to, zero size if warm path does not apply */
+	struct
+	{
+		uint_pltfrm								image_addr;
+		uint32_t								image_size;
+		uint32_t								firmware_version;
+
+	} warm;
+#endif /* _WITH_SLBV_WARM_RESET_ */
+#ifdef _WITH_SLBV_LAZY_XIP_
+	/** Deferred XiP verification information */
+	struct
+	{
+		/** XiP chunked image eligible, PMP is armed right before jump */
+		uint8_t									pending;
+		/** Deny rule in place, trap handler active */
+		uint8_t									armed;
+		/** Context given back to trap handler */
+		t_context								*p_ctx;
+		/** Trap vector in place before arming */
+		uint_pltfrm								prev_mtvec;
+		/** XiP raw binary */
+		uint_pltfrm								base;
+		uint32_t								size;
+		uint32_t								nb_chunks;
+		/** Verified chunks bitmap */
+		uint32_t								nb_verified;
+		uint32_t								verified[C_SLBV_LAZY_CHUNK_NB_MAX / 32];
+		/** Opened PMP windows, naturally aligned groups of verified chunks */
+		uint32_t								nb_windows;
+		struct
+		{
+			uint32_t							first;
+			uint32_t							size_log2;
+
+		} window[C_SLBV_LAZY_PMP_WINDOW_NB];
+		/** Leaves table copy, so that flash is not trusted after signature check */
+		uint8_t									leaves[C_SLBV_LAZY_CHUNK_NB_MAX * C_SLBV_CHUNK_HASH_SIZE] __attribute__((aligned(0x10)));
+
+	} lazy;
+#endif /* _WITH_SLBV_LAZY_XIP_ */
+#ifdef _WITH_SLBV_MANIFEST_
+	/** Multi-image manifest information */
+	struct
+	{
+		/** Is application image a manifest ? */
+		uint8_t									enabled;
+		/** Manifest copy, taken before it is checked and signed along with header */
+		t_slbv_manifest							table;
+		/** End of manifest on boot device */
+		uint_pltfrm								table_end;
+		/** Entry point of each segment */
+		uint_pltfrm								entry[C_SLBV_MANIFEST_SEG_MAX];
+		/** Segments copied so far, wiped on failure */
+		uint32_t								nb_installed;
+		t_slbv_installed_area					installed[C_SLBV_MANIFEST_SEG_MAX];
+
+	} manifest;
+#endif /* _WITH_SLBV_MANIFEST_ */
+#ifdef _WITH_SLBV_HEADER_V2_
+	/** Header v2 information */
+	struct
+	{
+		/** Does image carry a segment table ? */
+		uint8_t									enabled;
+		/** Segment table copy, taken before it is checked and signed along with header */
+		t_slbv_v2_table							table;
+		/** End of segment table on boot device */
+		uint_pltfrm								table_end;
+		/** Areas written so far, wiped on failure */
+		uint32_t								nb_installed;
+		t_slbv_installed_area					installed[C_SLBV_V2_SEG_MAX];
+
+	} v2;
+#endif /* _WITH_SLBV_HEADER_V2_ */
+#ifdef _WITH_SLBV_STREAMED_INSTALL_
+	/** Compressed or encrypted image information */
+	struct
+	{
+		/** Stream type - e_slbv_stream_type */
+		uint8_t									type;
+		/** Has destination area been written ? */
+		uint8_t									installed;
+		/** Destination area */
+		uint_pltfrm								dst;
+		/** Installed size */
+		uint32_t								size;
+
+	} stream;
+#endif /* _WITH_SLBV_STREAMED_INSTALL_ */
 
 } t_slbv_context;
 
@@ -155,7 +965,25 @@ int_pltfrm slbv_shutdown(void *p_ctx);
 int_pltfrm slbv_process(t_context *p_ctx);
 int_pltfrm slbv_get_boot_address(t_context *p_ctx, uint_pltfrm *p_addr);
 int_pltfrm slbv_get_application_version(t_context *p_ctx, uint32_t *p_version);
+int_pltfrm slbv_set_application_version(t_context *p_ctx, uint32_t version);
 int_pltfrm slbv_check_slb(t_context *p_ctx, e_slbv_slb_id slb_id);
+#ifdef _WITH_SLBV_ENCRYPTED_IMAGE_
+int_pltfrm slbv_aes_benchmark(t_context *p_ctx, uint32_t length, uint32_t core_freq_hz, uint64_t *p_cycles, uint32_t *p_mbps_x100);
+#ifndef _WITHOUT_SELFTESTS_
+int_pltfrm slbv_aes_selftest(t_context *p_ctx);
+#endif /* _WITHOUT_SELFTESTS_ */
+#endif /* _WITH_SLBV_ENCRYPTED_IMAGE_ */
+#ifdef _WITH_SLBV_WARM_RESET_
+int_pltfrm slbv_warm_boot(t_context *p_ctx);
+#endif /* _WITH_SLBV_WARM_RESET_ */
+#ifdef _WITH_SLBV_LAZY_XIP_
+/** Trap vector installed while XiP image is partially verified, it runs on ROM data.
+ * Until every chunk has been fetched or loaded once, FSBL must :
+ * - keep mtvec on it, or forward instruction/load access faults to it with registers untouched
+ * - leave ROM .bss/.data (verification context, hash context) and PMP entries 0 to 7 alone
+ * - leave room on its stack for a chunk check, the handler runs on interrupted code stack */
+__attribute__((naked, aligned(4))) void slbv_lazy_trap_entry(void);
+#endif /* _WITH_SLBV_LAZY_XIP_ */
 
 /** Macros ********************************************************************/
 
@@ -56,6 +56,12 @@
 #define GPT_GUID_SIZE 16
 #define GPT_HEADER_LBA 1
 #define GPT_HEADER_BYTES 92
+// "EFI PART"
+#define GPT_HEADER_SIGNATURE 0x5452415020494645ULL
+// Partition array is burst-read at once, standard array is 128 entries of 128 bytes
+#define GPT_PARTITION_ARRAY_MAX_BYTES (128 * 128)
+// Partitions kept in RAM map, empty entries are skipped
+#define GPT_CACHE_MAX_ENTRIES 16
 
 #define MICRON_SPI_FLASH_CMD_RESET_ENABLE        0x66
 #define MICRON_SPI_FLASH_CMD_MEMORY_RESET        0x99
@@ -103,6 +109,8 @@
 #define ERROR_CODE_SD_CARD_CMD18 0xa
 #define ERROR_CODE_SD_CARD_CMD18_CRC 0xb
 #define ERROR_CODE_SD_CARD_UNEXPECTED_ERROR 0xc
+#define ERROR_CODE_GPT_HEADER_INVALID 0xd
+#define ERROR_CODE_GPT_ARRAY_CRC 0xe
 
 // We are assuming that an error LED is connected to the GPIO pin
 #define UX00BOOT_ERROR_LED_GPIO_PIN 15
@@ -124,6 +132,10 @@ typedef enum
 	N_SLBV_APP_TYPE_MIN = 0,
 	N_SLBV_APP_TYPE_REGULAR,
 	N_SLBV_APP_TYPE_ENCRYPTED = 0x0fd4,
+	N_SLBV_APP_TYPE_CHUNKED = 0x2c4b,
+	N_SLBV_APP_TYPE_COMPRESSED = 0x7c31,
+	N_SLBV_APP_TYPE_MANIFEST = 0x4d31,
+	N_SLBV_APP_TYPE_V2 = 0x5632,
 	N_SLBV_APP_TYPE_MAX
 
 } e_application_type;
@@ -175,12 +187,83 @@ typedef struct
   uint16_t name[36];  // UTF-16
 } gpt_partition_entry;
 _ASSERT_SIZEOF(gpt_partition_entry, 128);
+
+typedef struct
+{
+  gpt_guid partition_type_guid;
+  gpt_partition_range range;
+} gpt_cache_entry;
+
+// Partition map of last parsed device, so that looking up another GUID
+// on the same device costs no device I/O.
+typedef struct
+{
+  uintptr_t device;  // Controller the map was read from, 0 if map is empty
+  uint32_t num_entries;
+  gpt_cache_entry entries[GPT_CACHE_MAX_ENTRIES];
+} gpt_partition_cache;
 #endif /* _WITH_GPT_ */
 
 
 /** Functions *****************************************************************/
+#if defined(_WITH_SLBV_CHUNKED_IMAGE_) || defined(_WITH_SLBV_MANIFEST_) || defined(_WITH_SLBV_WARM_RESET_) || defined(_WITH_SLBV_HEADER_V2_)
+int_pltfrm slbv_hash(t_context *p_ctx,
+						metal_scl_t *p_scl,
+						scl_sha_ctx_t *p_sha_ctx,
+						const uint8_t *p_data,
+						uint32_t size,
+						uint8_t *p_digest);
+#endif /* _WITH_SLBV_CHUNKED_IMAGE_ || _WITH_SLBV_MANIFEST_ || _WITH_SLBV_WARM_RESET_ || _WITH_SLBV_HEADER_V2_ */
+#ifdef _WITH_SLBV_CHUNKED_IMAGE_
+int_pltfrm slbv_chunk_check_table(t_context *p_ctx, uint_pltfrm desc_addr, uint_pltfrm leaves_end, uint32_t raw_binary_size);
+int_pltfrm slbv_chunk_check(t_context *p_ctx,
+							metal_scl_t *p_scl,
+							scl_sha_ctx_t *p_sha_ctx,
+							uint32_t index,
+							uint_pltfrm src,
+							uint_pltfrm dst,
+							uint32_t size);
+int_pltfrm slbv_chunk_range(t_context *p_ctx,
+							metal_scl_t *p_scl,
+							scl_sha_ctx_t *p_sha_ctx,
+							uint32_t first,
+							uint32_t count,
+							uint_pltfrm src,
+							uint_pltfrm dst,
+							uint32_t raw_binary_size);
+int_pltfrm slbv_chunk_process(t_context *p_ctx, uint_pltfrm src, uint_pltfrm dst, uint32_t raw_binary_size, uint8_t token_xip);
+#ifdef _WITH_SLBV_MULTI_HART_
+int_pltfrm slbv_hart_dispatch(t_context *p_ctx, uint_pltfrm src, uint_pltfrm dst, uint32_t raw_binary_size);
+#endif /* _WITH_SLBV_MULTI_HART_ */
+#if defined(_WITH_SLBV_INCREMENTAL_) || defined(_WITH_SLBV_WARM_RESET_)
+uint64_t slbv_siphash(const uint8_t *p_key, uint64_t prefix, const uint8_t *p_data, uint32_t length);
+int_pltfrm slbv_mac_derive_key(t_context *p_ctx, uint64_t session, uint8_t *p_key);
+#endif /* _WITH_SLBV_INCREMENTAL_ || _WITH_SLBV_WARM_RESET_ */
+#ifdef _WITH_SLBV_INCREMENTAL_
+int_pltfrm slbv_inc_process(t_context *p_ctx, uint_pltfrm src, uint_pltfrm dst, uint32_t raw_binary_size);
+#endif /* _WITH_SLBV_INCREMENTAL_ */
+#ifdef _WITH_SLBV_WARM_RESET_
+int_pltfrm slbv_warm_csk_digest(t_context *p_ctx, uint32_t slot, uint8_t *p_digest);
+int_pltfrm slbv_warm_nonce(t_context *p_ctx, uint64_t *p_nonce);
+void slbv_warm_seal(t_context *p_ctx);
+#endif /* _WITH_SLBV_WARM_RESET_ */
+#ifdef _WITH_SLBV_LAZY_XIP_
+void slbv_pmp_set(uint32_t entry, uint_pltfrm addr, uint8_t cfg);
+__attribute__((naked, aligned(4))) void slbv_lazy_probe_trap(void);
+uint8_t slbv_lazy_rlb_available(void);
+int_pltfrm slbv_lazy_prepare(t_context *p_ctx, uint_pltfrm base, uint32_t raw_binary_size);
+void slbv_lazy_arm(t_context *p_ctx);
+void slbv_lazy_disarm(void);
+void slbv_lazy_open_window(uint32_t index);
+uint_pltfrm slbv_lazy_trap_handler(uint_pltfrm mcause, uint_pltfrm mtval);
+#endif /* _WITH_SLBV_LAZY_XIP_ */
+#endif /* _WITH_SLBV_CHUNKED_IMAGE_ */
 #ifdef _WITH_GPT_
 gpt_partition_range gpt_find_partition_by_guid(const void* entries, const gpt_guid* guid, uint32_t num_entries);
+int32_t gpt_check_header(gpt_header* header);
+int32_t gpt_cache_fill(uintptr_t device, const void* entries, const gpt_header* header);
+gpt_partition_range gpt_cache_lookup(uintptr_t device, const gpt_guid* guid);
+uint64_t gpt_image_size(const void* first_block, gpt_partition_range range);
 
 static inline gpt_partition_range gpt_invalid_partition_range()
 {
@@ -192,7 +275,82 @@ static inline int gpt_is_valid_partition_range(gpt_partition_range range)
   return range.first_lba != 0 && range.last_lba != 0;
 }
 #endif /* _WITH_GPT_ */
+#ifdef _WITH_SLBV_COMPRESSED_IMAGE_
+int_pltfrm slbv_lz4_decode_block(const uint8_t *p_in, uint32_t in_len, uint8_t *p_out, uint32_t *p_pos, uint32_t out_max);
+int_pltfrm slbv_comp_hash_install(t_context *p_ctx, uint_pltfrm src, uint_pltfrm src_end, uint_pltfrm dst, uint32_t dst_size);
+#endif /* _WITH_SLBV_COMPRESSED_IMAGE_ */
+#ifdef _WITH_SLBV_QSPI_PERF_
+volatile t_reg_qspi *slbv_qspi_get_regs(void);
+int_pltfrm slbv_qspi_xfer(volatile t_reg_qspi *p_reg, uint8_t tx, uint8_t *p_rx);
+int_pltfrm slbv_qspi_probe(t_context *p_ctx, volatile t_reg_qspi *p_reg, uint32_t *p_cfg);
+void slbv_qspi_apply(volatile t_reg_qspi *p_reg, uint32_t cfg);
+int_pltfrm slbv_qspi_check_pattern(uint_pltfrm boot_addr);
+int_pltfrm slbv_qspi_setup(t_context *p_ctx, uint_pltfrm boot_addr);
+#endif /* _WITH_SLBV_QSPI_PERF_ */
+#ifdef _WITH_SLBV_EMMC_
+int_pltfrm slbv_emmc_wait_int(volatile t_reg_sdhci *p_reg, uint16_t mask);
+int_pltfrm slbv_emmc_cmd(volatile t_reg_sdhci *p_reg, uint32_t index, uint32_t arg, uint16_t flags, uint32_t *p_resp);
+int_pltfrm slbv_emmc_set_clock(volatile t_reg_sdhci *p_reg, uint32_t khz);
+int_pltfrm slbv_emmc_switch(volatile t_reg_sdhci *p_reg, uint32_t index, uint32_t value);
+int_pltfrm slbv_emmc_read(volatile t_reg_sdhci *p_reg, uint32_t lba, uint32_t nb_blocks, uint_pltfrm dst, uint16_t cmd_index);
+int_pltfrm slbv_emmc_tune(volatile t_reg_sdhci *p_reg);
+int_pltfrm slbv_emmc_init_start(t_context *p_ctx);
+int_pltfrm slbv_emmc_init_poll(t_context *p_ctx, uint8_t *p_ready);
+int_pltfrm slbv_emmc_init_finish(t_context *p_ctx);
+int_pltfrm slbv_emmc_init(t_context *p_ctx);
+int_pltfrm slbv_emmc_load(t_context *p_ctx, uint_pltfrm dst, uint32_t dst_size);
+#endif /* _WITH_SLBV_EMMC_ */
+#ifdef _WITH_SLBV_BOOT_PROBE_
+uint_pltfrm slbv_probe_cycles(void);
+int_pltfrm slbv_probe_order(t_context *p_ctx);
+int_pltfrm slbv_probe_start(t_context *p_ctx, uint32_t index);
+int_pltfrm slbv_probe_step(t_context *p_ctx, uint32_t index);
+int_pltfrm slbv_probe_boot_devices(t_context *p_ctx);
+#endif /* _WITH_SLBV_BOOT_PROBE_ */
+int_pltfrm slbv_find_last_refv_slot(t_context *p_ctx, int32_t *p_slot, uint32_t *p_version);
+#ifdef _WITH_SLBV_AB_SLOTS_
+int_pltfrm slbv_ab_precheck_slot(t_context *p_ctx, uint_pltfrm slot_addr, uint_pltfrm slot_size);
+int_pltfrm slbv_ab_select(t_context *p_ctx);
+#endif /* _WITH_SLBV_AB_SLOTS_ */
+#if defined(_WITH_SLBV_MANIFEST_) || defined(_WITH_SLBV_HEADER_V2_)
+uint8_t slbv_area_overlaps(uint_pltfrm dst, uint_pltfrm size, const t_slbv_installed_area *p_area, uint32_t nb_area);
+#endif /* _WITH_SLBV_MANIFEST_ || _WITH_SLBV_HEADER_V2_ */
+#ifdef _WITH_SLBV_MANIFEST_
+int_pltfrm slbv_manifest_process(t_context *p_ctx, e_slbv_slb_id slb_id);
+#ifdef _WITH_SLBV_MULTI_HART_
+int_pltfrm slbv_manifest_release_harts(t_context *p_ctx);
+#endif /* _WITH_SLBV_MULTI_HART_ */
+#endif /* _WITH_SLBV_MANIFEST_ */
+#ifdef _WITH_SLBV_HEADER_V2_
+int_pltfrm slbv_v2_process(t_context *p_ctx);
+#endif /* _WITH_SLBV_HEADER_V2_ */
+#ifdef _WITH_SLBV_ENCRYPTED_IMAGE_
+int_pltfrm slbv_enc_hash_install(t_context *p_ctx, uint_pltfrm src, uint_pltfrm src_end, uint_pltfrm dst, uint32_t dst_size);
+void slbv_aes_init_tables(void);
+int_pltfrm slbv_aes_setkey(t_slbv_aes_ctx *p_aes, const uint8_t *p_key, uint32_t key_size);
+void slbv_aes_encrypt_block(const t_slbv_aes_ctx *p_aes, const uint8_t *p_in, uint8_t *p_out);
+int_pltfrm slbv_aes_ctr_xcrypt(t_context *p_ctx,
+								t_slbv_aes_ctx *p_aes,
+								uint8_t *p_counter,
+								const uint8_t *p_in,
+								uint8_t *p_out,
+								uint32_t length);
+#endif /* _WITH_SLBV_ENCRYPTED_IMAGE_ */
 /** Macros ********************************************************************/
+#if defined(_WITH_SLBV_INCREMENTAL_) || defined(_WITH_SLBV_WARM_RESET_)
+#define	M_SLBV_ROTL64(_x_, _n_)					( ( (_x_) << (_n_) ) | ( (_x_) >> ( 64 - (_n_) ) ) )
+#define	M_SLBV_SIPROUND(_v0_, _v1_, _v2_, _v3_) \
+	do \
+	{ \
+		_v0_ += _v1_; _v1_ = M_SLBV_ROTL64(_v1_, 13); _v1_ ^= _v0_; _v0_ = M_SLBV_ROTL64(_v0_, 32); \
+		_v2_ += _v3_; _v3_ = M_SLBV_ROTL64(_v3_, 16); _v3_ ^= _v2_; \
+		_v0_ += _v3_; _v3_ = M_SLBV_ROTL64(_v3_, 21); _v3_ ^= _v0_; \
+		_v2_ += _v1_; _v1_ = M_SLBV_ROTL64(_v1_, 17); _v1_ ^= _v2_; _v2_ = M_SLBV_ROTL64(_v2_, 32); \
+	} while( 0 )
+#endif /* _WITH_SLBV_INCREMENTAL_ || _WITH_SLBV_WARM_RESET_ */
+#ifdef _WITH_SLBV_ENCRYPTED_IMAGE_
+#define	M_SLBV_ROR32(_x_, _n_)					( ( (_x_) >> (_n_) ) | ( (_x_) << ( 32 - (_n_) ) ) )
+#endif /* _WITH_SLBV_ENCRYPTED_IMAGE_ */
 #ifdef _WITH_GPT_
 /** _DBY_YG_ */
 #define _ASSERT_SIZEOF(type, size) \
@@ -51,6 +51,12 @@
 /** UART0 is the default UART ID */
 #define	C_SP_SUP_BUS_UART_ID					0
 
+/** ROM services table version : major (16bits) | minor (16bits)
+ * Minor is incremented when services are appended, major when table layout changes */
+#define	C_SP_ROM_SVC_VERSION_MAJOR				1
+#define	C_SP_ROM_SVC_VERSION_MINOR				1
+#define	C_SP_ROM_SVC_VERSION					( ( C_SP_ROM_SVC_VERSION_MAJOR << 16 ) | C_SP_ROM_SVC_VERSION_MINOR )
+
 /** Enumerations **************************************************************/
 /** SP errors list */
 typedef enum
@@ -144,6 +150,14 @@ typedef enum
 	N_SP_ERR_SUP_CMD_NOT_SUPPORTED,
 	/** Key verification failed before use at SUP session */
 	N_SP_ERR_SUP_KEY_VERIF_FAILED,
+	/** Batch command payload is malformed */
+	N_SP_ERR_SUP_BATCH_MALFORMED,
+	/** Batch combined response does not fit in response buffer */
+	N_SP_ERR_SUP_BATCH_RSP_OVERFLOW,
+	/** Requested applet is not in cache or its content changed */
+	N_SP_ERR_SUP_APPLET_NOT_CACHED,
+	/** Fragment is out of order or does not fit in reassembly arena */
+	N_SP_ERR_SUP_FRAG_SEQUENCE,
 	/** Platform reset expected */
 	N_SP_ERR_RESET_PLATFORM,
 	/** Platform shutdown expected */
@@ -185,6 +199,46 @@ typedef enum
 
 
 /** Structures ****************************************************************/
+/** ROM services table given to applets launched by SUP EXECUTE command.
+ * Applet prototype is :
+ * int_pltfrm applet(uint8_t *p_arg, uint32_t length, uint8_t **p_ret_data, uint32_t *p_ret_size, const t_sp_rom_services *p_svc)
+ * New services must only be appended at end of structure */
+typedef struct
+{
+	/** Table version */
+	uint32_t									version;
+	/** Table size in Bytes */
+	uint32_t									size;
+	/** Context to give back to services */
+	t_context									*p_ctx;
+	/** SHA384 on ROM hash context */
+	int_pltfrm (*sha_init)(t_context *p_ctx);
+	int_pltfrm (*sha_core)(t_context *p_ctx, const uint8_t *p_data, uint32_t length);
+	int_pltfrm (*sha_finish)(t_context *p_ctx, uint8_t *p_digest, uint32_t *p_length);
+	/** Key retrieval and signature verification */
+	int_pltfrm (*get_key)(t_context *p_ctx, e_km_keyid key_id, t_km_key *p_key, uint32_t *p_key_size);
+	int_pltfrm (*verify_signature)(t_context *p_ctx,
+									uint8_t *p_message,
+									uint32_t mess_length,
+									uint8_t *p_signature,
+									e_km_support_algos algo,
+									t_km_key key);
+	/** OTP read */
+	int_pltfrm (*read_otp)(t_context *p_ctx, uint_pltfrm offset, uint8_t *p_data, uint32_t length);
+	/** Send on SUP port, whatever the bus */
+	union
+	{
+		int_pltfrm (*com_send)(t_context *p_ctx, uint8_t *p_data, uint32_t size);
+		/** Former name, same entry - kept for applets built against 1.0 table */
+		int_pltfrm (*uart_send)(t_context *p_ctx, uint8_t *p_data, uint32_t size);
+	};
+	/** CRC32 */
+	int_pltfrm (*compute_crc)(uint32_t *p_crc, uint8_t *p_data, uint32_t size);
+	/** Anti-rollback counter - since 1.1 */
+	int_pltfrm (*get_application_version)(t_context *p_ctx, uint32_t *p_version);
+	int_pltfrm (*set_application_version)(t_context *p_ctx, uint32_t version);
+
+} t_sp_rom_services;
 
 
 /** Functions *****************************************************************/
@@ -36,6 +36,7 @@
 /** Global includes */
 #include <stdint.h>
 #include <metal/machine.h>
+#include <metal/machine/platform.h>
 #include <metal/cpu.h>
 #include <metal/uart.h>
 #include <metal/gpio.h>
@@ -122,6 +123,46 @@
 /** Signature total size : 3 * Signature element */
 #define	C_SP_SUP_MAX_SIGNATURE_TOTAL_SIZE				( C_SP_SUP_MAX_SIGNATURE_ELMNT_NB * C_SP_SUP_MAX_SIGNATURE_ELMNT_SIZE )
 
+/** Transport *****************************************************************/
+#ifdef _WITH_SUP_SPI_SLAVE_
+/** SPI slave controller base address - given by platform device tree */
+#ifndef METAL_SIFIVE_SPI_SLAVE_0_BASE_ADDRESS
+#error "SPI slave controller is not declared in platform device tree"
+#endif /* METAL_SIFIVE_SPI_SLAVE_0_BASE_ADDRESS */
+#define	C_SP_SPIS_BASE_ADDR								METAL_SIFIVE_SPI_SLAVE_0_BASE_ADDRESS
+/** SPI mode 0 : CPOL = 0, CPHA = 0 */
+#define	C_SP_SPIS_DEFAULT_MODE							0
+/** Number of polling loops without any Byte before reception is considered lost */
+#define	C_SP_SPIS_TIMEOUT_LOOP_NB						0x10000000UL
+#endif /* _WITH_SUP_SPI_SLAVE_ */
+
+#ifdef _WITH_SUP_LOOPBACK_
+/** Loopback TX capture buffer size */
+#define	C_SP_LOOPBACK_TX_BUFFER_SIZE					( 4 * C_GENERIC_KILO )
+#endif /* _WITH_SUP_LOOPBACK_ */
+
+#ifdef _WITH_SUP_BATCH_
+/** Batch command *************************************************************/
+/** Batch payload buffer size : sub-commands headers and their payloads */
+#define	C_SP_SUP_BATCH_BUFFER_SIZE						( 2 * C_GENERIC_KILO )
+/** Batch combined response buffer size */
+#define	C_SP_SUP_BATCH_RSP_BUFFER_SIZE					( 1 * C_GENERIC_KILO )
+/** Maximum number of sub-commands in one batch */
+#define	C_SP_SUP_BATCH_MAX_CMD_NB						8
+#endif /* _WITH_SUP_BATCH_ */
+
+#ifdef _WITH_SUP_FRAGMENTATION_
+/** Fragmentation *************************************************************/
+/** Reassembly arena size, located at the end of free RAM */
+#define	C_SP_SUP_FRAG_ARENA_SIZE						( 8 * C_GENERIC_KILO )
+#endif /* _WITH_SUP_FRAGMENTATION_ */
+
+#ifdef _WITH_SUP_APPLET_CACHE_
+/** Applet cache **************************************************************/
+/** Number of applet areas kept in cache */
+#define	C_SP_APPLET_CACHE_NB							4
+#endif /* _WITH_SUP_APPLET_CACHE_ */
+
 /** Stimulus parameters *******************************************************/
 #define	C_SP_STIM_GPIO_PIN_OFST							0
 #define	C_SP_STIM_GPIO_PIN_MASK_NOOFST					0xff
@@ -195,6 +236,20 @@ typedef enum
 	N_SP_SUP_SEGMENT_TYPE_WRITECUK = 0xc95e3db4UL,
 	/* 0xf96e6df4 */
 	N_SP_SUP_SEGMENT_TYPE_WRITEPMUSK = 0xf96e6df4UL,
+#ifdef _WITH_SUP_BATCH_
+	/* 0x6b3ad4e2 */
+	N_SP_SUP_SEGMENT_TYPE_BATCH = 0x6b3ad4e2UL,
+#endif /* _WITH_SUP_BATCH_ */
+#ifdef _WITH_SUP_APPLET_CACHE_
+	/* 0x5c0e7a19 */
+	N_SP_SUP_SEGMENT_TYPE_EXECUTE_CACHED = 0x5c0e7a19UL,
+#endif /* _WITH_SUP_APPLET_CACHE_ */
+#ifdef _WITH_SUP_FRAGMENTATION_
+	/* 0x2d9f41c7 */
+	N_SP_SUP_SEGMENT_TYPE_FRAGMENT = 0x2d9f41c7UL,
+	/* 0xd260be38 */
+	N_SP_SUP_SEGMENT_TYPE_FRAGMENT_END = 0xd260be38UL,
+#endif /* _WITH_SUP_FRAGMENTATION_ */
 //	/* 0x68234fbaUL */
 //	N_SP_SUP_SEGMENT_TYPE_UPDATECSK = 0x68234fbaUL,
 	N_SP_SUP_SEGMENT_TYPE_MAX = N_SP_SUP_SEGMENT_TYPE_WRITEPMUSK
@@ -271,6 +326,75 @@ typedef struct __attribute__((packed))
 
 } t_sp_sup_tx_pckt_hdr;
 
+#ifdef _WITH_SUP_BATCH_
+/** SUP batch sub-command header - 'address' field is always present, even
+ * when 'command_length' is null (e.g. GETINFO) */
+typedef struct __attribute__((packed))
+{
+	/** Sub-command type - 4 Bytes */
+	uint32_t									command_type;
+	/** Sub-command length, 'address' field included - 4 Bytes */
+	uint32_t									command_length;
+	/** Sub-command address - 4 Bytes */
+	uint32_t									address;
+
+} t_sp_sup_batch_cmd_hdr;
+
+/** SUP batch sub-command response header, followed by 'data_length' Bytes */
+typedef struct __attribute__((packed))
+{
+	/** Sub-command type - 4 Bytes */
+	uint32_t									command_type;
+	/** Sub-command error code - 4 Bytes */
+	int32_t										ret_error;
+	/** Sub-command data length - 4 Bytes */
+	uint32_t									data_length;
+
+} t_sp_sup_batch_rsp_hdr;
+#endif /* _WITH_SUP_BATCH_ */
+
+#ifdef _WITH_SUP_FRAGMENTATION_
+/** FRAGMENT-END payload : header of reassembled command, stored at the beginning
+ * of reassembly arena, right before fragments data */
+typedef struct __attribute__((packed))
+{
+	/** Reassembled command type - 4 Bytes */
+	uint32_t									command_type;
+	/** Reassembled command length, 'address' field included - 4 Bytes */
+	uint32_t									command_length;
+	/** Reassembled command address - 4 Bytes */
+	uint32_t									address;
+
+} t_sp_sup_frag_hdr;
+#endif /* _WITH_SUP_FRAGMENTATION_ */
+
+#ifdef _WITH_SUP_APPLET_CACHE_
+/** EXECUTE-CACHED payload, followed by applet arguments */
+typedef struct __attribute__((packed))
+{
+	/** Digest of immutable part of applet load image */
+	uint8_t										digest[SHA384_BYTE_HASHSIZE];
+	/** Size of immutable part, from beginning of load image : code and
+	 * read-only data, applet must not write into it */
+	uint32_t									image_length;
+	/** Jump address, first word of arguments given to applet as for EXECUTE */
+	uint32_t									jump_addr;
+
+} t_sp_sup_cached_exec;
+
+/** Applet cache entry : load image area of an executed applet */
+typedef struct
+{
+	/** Entry is valid ? */
+	uint8_t										valid;
+	/** Applet load image start address in free RAM */
+	uint_pltfrm									address;
+	/** Applet load image size in Bytes */
+	uint32_t									length;
+
+} t_sp_applet_cache_entry;
+#endif /* _WITH_SUP_APPLET_CACHE_ */
+
 /******************************************************************************/
 typedef struct __attribute__((packed))
 {
@@ -326,10 +450,31 @@ typedef struct __attribute__((packed))
 	uint_pltfrm									applet_start;
 	/** Applet RAM end address */
 	uint_pltfrm									applet_end;
+#ifdef _WITH_SBRM_PROFILING_
+	/** Boot-time profile, as handed to FSBL */
+	t_sbrm_prof_ring							profile;
+#endif /* _WITH_SBRM_PROFILING_ */
 
 
 } t_getinfo_template;
 
+/******************************************************************************/
+/** SUP transport functions, one instance per bus */
+typedef struct
+{
+	/** Port initialization */
+	int_pltfrm (*initialize_fct)(t_context *p_ctx);
+	/** Blocking reception of '*p_size' Bytes */
+	int_pltfrm (*receive_fct)(t_context *p_ctx, uint8_t *p_data, uint32_t *p_size);
+	/** Blocking emission of 'size' Bytes */
+	int_pltfrm (*send_fct)(t_context *p_ctx, uint8_t *p_data, uint32_t size);
+	/** Stop reception after a packet */
+	void (*stop_rx_fct)(t_context *p_ctx);
+	/** Close port */
+	void (*close_fct)(t_context *p_ctx);
+
+} t_sp_transport;
+
 /******************************************************************************/
 /** SUP context structure */
 typedef struct
@@ -394,6 +539,8 @@ typedef struct
 	{
 		/** Bus Identifier */
 		e_sbrm_busid							bus_id;
+		/** Transport functions of selected bus */
+		const t_sp_transport					*p_transport;
 		/** Raw configuration parameters */
 		uint32_t								config[C_SP_SUP_PORT_CONF_SIZE_INTEGER];;
 		/**  */
@@ -409,6 +556,30 @@ typedef struct
 			uint32_t							uart0_irq;
 
 		} uart;
+#ifdef _WITH_SUP_SPI_SLAVE_
+		/**  */
+		struct
+		{
+			/** SPI slave registers */
+			volatile t_reg_spis					*reg_spis;
+
+		} spis;
+#endif /* _WITH_SUP_SPI_SLAVE_ */
+#ifdef _WITH_SUP_LOOPBACK_
+		/** Host loopback stand-in : RX is fed by Host, TX is captured */
+		struct
+		{
+			/** Data to be received */
+			uint8_t								*p_rx;
+			/** Number of Bytes lasting to be received */
+			uint32_t							rx_lasting;
+			/** Captured data */
+			uint8_t								tx_buf[C_SP_LOOPBACK_TX_BUFFER_SIZE];
+			/** Number of captured Bytes */
+			uint32_t							tx_size;
+
+		} loopback;
+#endif /* _WITH_SUP_LOOPBACK_ */
 
 	} port;
 	/** Communication context structure */
@@ -452,6 +623,31 @@ typedef struct
 	} security;
 	/** SUP context structure */
 	t_sp_sup_context							sup;
+#ifdef _WITH_SUP_FRAGMENTATION_
+	/** Reassembly of fragmented command */
+	struct
+	{
+		/** Reassembly arena : command header followed by fragments data */
+		uint8_t									*p_arena;
+		/** Number of Bytes of data already received */
+		uint32_t								fill;
+
+	} frag;
+#endif /* _WITH_SUP_FRAGMENTATION_ */
+#ifdef _WITH_SUP_APPLET_CACHE_
+	/** Applets already loaded and executed in free RAM */
+	struct
+	{
+		/** Contiguous area being written by COPY commands - load image */
+		uint_pltfrm								copy_start;
+		uint_pltfrm								copy_end;
+		/** Cache entries */
+		t_sp_applet_cache_entry					entry[C_SP_APPLET_CACHE_NB];
+		/** Next entry to be replaced */
+		uint8_t									next;
+
+	} cache;
+#endif /* _WITH_SUP_APPLET_CACHE_ */
 
 } t_sp_context;
 
@@ -464,6 +660,29 @@ void sp_uart_rx_isr(int32_t id, void *data);
 void sp_uart_tx_isr(int32_t id, void *data);
 int_pltfrm sp_uart_receive_buffer(t_context *p_ctx, uint8_t *p_data, uint32_t *p_size);
 int_pltfrm sp_uart_send_buffer(t_context *p_ctx, uint8_t *p_data, uint32_t size);
+int_pltfrm sp_uart_initialize(t_context *p_ctx);
+void sp_uart_stop_rx(t_context *p_ctx);
+void sp_uart_close(t_context *p_ctx);
+#ifdef _WITH_SUP_SPI_SLAVE_
+/** SPI slave */
+int_pltfrm sp_spis_initialize(t_context *p_ctx);
+int_pltfrm sp_spis_receive_buffer(t_context *p_ctx, uint8_t *p_data, uint32_t *p_size);
+int_pltfrm sp_spis_send_buffer(t_context *p_ctx, uint8_t *p_data, uint32_t size);
+void sp_spis_stop_rx(t_context *p_ctx);
+void sp_spis_close(t_context *p_ctx);
+#endif /* _WITH_SUP_SPI_SLAVE_ */
+#ifdef _WITH_SUP_LOOPBACK_
+/** Host loopback */
+int_pltfrm sp_loopback_initialize(t_context *p_ctx);
+int_pltfrm sp_loopback_receive_buffer(t_context *p_ctx, uint8_t *p_data, uint32_t *p_size);
+int_pltfrm sp_loopback_send_buffer(t_context *p_ctx, uint8_t *p_data, uint32_t size);
+void sp_loopback_stop_rx(t_context *p_ctx);
+void sp_loopback_close(t_context *p_ctx);
+int_pltfrm sp_loopback_feed(uint8_t *p_data, uint32_t size);
+int_pltfrm sp_loopback_get_tx(uint8_t **p_data, uint32_t *p_size);
+#endif /* _WITH_SUP_LOOPBACK_ */
+/** Transport */
+int_pltfrm sp_sup_transport_send(t_context *p_ctx, uint8_t *p_data, uint32_t size);
 /**  */
 int_pltfrm sp_check_stimulus(t_context *p_ctx);
 int_pltfrm sp_sup_get_port_id(t_context *p_ctx);
@@ -476,6 +695,16 @@ void sp_sup_close_communication(t_context *p_ctx);
 int_pltfrm sp_treat_copy(t_context *p_ctx, uint_pltfrm address, uint_pltfrm length, uint8_t *p_data);
 int_pltfrm sp_treat_writekey(t_context *p_ctx, e_km_keyid key_id, uint8_t *p_data, uint32_t length);
 int_pltfrm sp_treat_execute(t_context *p_ctx, uint_pltfrm jump_addr, uint8_t *p_arg, uint32_t length, uint8_t **p_data, uint32_t *p_length);
+#ifdef _WITH_SUP_APPLET_CACHE_
+int_pltfrm sp_treat_execute_cached(t_context *p_ctx, uint8_t *p_payload, uint32_t length, uint8_t **p_data, uint32_t *p_length);
+int_pltfrm sp_applet_cache_hash(t_context *p_ctx, uint_pltfrm address, uint32_t length, uint8_t *p_digest);
+void sp_applet_cache_track_copy(uint_pltfrm address, uint32_t length);
+int_pltfrm sp_applet_cache_record(uint_pltfrm jump_addr);
+#endif /* _WITH_SUP_APPLET_CACHE_ */
+int_pltfrm sp_svc_sha_init(t_context *p_ctx);
+int_pltfrm sp_svc_sha_core(t_context *p_ctx, const uint8_t *p_data, uint32_t length);
+int_pltfrm sp_svc_sha_finish(t_context *p_ctx, uint8_t *p_digest, uint32_t *p_length);
+void sp_rom_services_init(t_context *p_ctx);
 int_pltfrm sp_treat_getinfo(t_context *p_ctx, uint8_t** p_data, uint32_t *p_length);
 int_pltfrm sp_sup_pkt_fields(uint8_t **p_data, uint32_t *p_size);
 int_pltfrm sp_sup_cmd_hdr(uint8_t **p_data, uint32_t *p_size);
@@ -492,6 +721,19 @@ int_pltfrm sp_sup_packet_response(t_context *p_ctx,
 int_pltfrm sp_sup_check_pkchain(t_context *p_ctx, uint8_t *p_pkchain, uint32_t nb_certs, t_km_key *p_key_cert);
 int_pltfrm sp_sup_check_security(t_context *p_ctx);
 int_pltfrm sp_sup_process_cmd(t_context *p_ctx, uint8_t **p_data, uint32_t *p_length);
+int_pltfrm sp_sup_dispatch_cmd(t_context *p_ctx,
+								uint32_t command_type,
+								uint32_t address,
+								uint8_t *p_payload,
+								uint32_t payload_length,
+								uint8_t **p_data,
+								uint32_t *p_length);
+#ifdef _WITH_SUP_BATCH_
+int_pltfrm sp_sup_process_batch(t_context *p_ctx, uint8_t **p_data, uint32_t *p_length);
+#endif /* _WITH_SUP_BATCH_ */
+#ifdef _WITH_SUP_FRAGMENTATION_
+int_pltfrm sp_sup_process_fragments(t_context *p_ctx, uint8_t **p_data, uint32_t *p_length);
+#endif /* _WITH_SUP_FRAGMENTATION_ */
 int_pltfrm sp_sup_send_response(t_context *p_ctx, uint8_t *p_data, uint32_t length);
 
 /** Macros ********************************************************************/
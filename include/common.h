@@ -43,6 +43,9 @@
 #ifdef _WITH_GPIO_CHARAC_
 #include <metal/led.h>
 #endif /* _WITH_GPIO_CHARAC_ */
+#ifdef _HOST_NATIVE_
+#include <metal/host.h>
+#endif /* _HOST_NATIVE_ */
 /** Other includes */
 #include <api/scl_api.h>
 #include <api/hardware/scl_hca.h>
@@ -337,6 +340,275 @@ typedef struct
 
 } t_reg_uart;
 
+/** SPI slave *****************************************************************/
+/** TX data register */
+#define	C_SPIS_TXDATA_DATA_OFST					0
+#define	C_SPIS_TXDATA_DATA_MASK_NOOFST			0xff
+#define	C_SPIS_TXDATA_DATA_MASK					( C_SPIS_TXDATA_DATA_MASK_NOOFST << C_SPIS_TXDATA_DATA_OFST )
+
+#define	C_SPIS_TXDATA_FULL_OFST					31
+#define	C_SPIS_TXDATA_FULL_MASK_NOOFST			0x1
+#define	C_SPIS_TXDATA_FULL_MASK					( C_SPIS_TXDATA_FULL_MASK_NOOFST << C_SPIS_TXDATA_FULL_OFST )
+/** RX data register */
+#define	C_SPIS_RXDATA_DATA_OFST					0
+#define	C_SPIS_RXDATA_DATA_MASK_NOOFST			0xff
+#define	C_SPIS_RXDATA_DATA_MASK					( C_SPIS_RXDATA_DATA_MASK_NOOFST << C_SPIS_RXDATA_DATA_OFST )
+
+#define	C_SPIS_RXDATA_EMPTY_OFST				31
+#define	C_SPIS_RXDATA_EMPTY_MASK_NOOFST			0x1
+#define	C_SPIS_RXDATA_EMPTY_MASK				( C_SPIS_RXDATA_EMPTY_MASK_NOOFST << C_SPIS_RXDATA_EMPTY_OFST )
+/** Control register */
+#define	C_SPIS_CTRL_EN_OFST						0
+#define	C_SPIS_CTRL_EN_MASK_NOOFST				0x1
+#define	C_SPIS_CTRL_EN_MASK						( C_SPIS_CTRL_EN_MASK_NOOFST << C_SPIS_CTRL_EN_OFST )
+/** SPI mode (CPOL/CPHA) */
+#define	C_SPIS_CTRL_MODE_OFST					1
+#define	C_SPIS_CTRL_MODE_MASK_NOOFST			0x3
+#define	C_SPIS_CTRL_MODE_MASK					( C_SPIS_CTRL_MODE_MASK_NOOFST << C_SPIS_CTRL_MODE_OFST )
+/** Ready line toggled toward Host when data is available in TX FIFO */
+#define	C_SPIS_CTRL_READY_OFST					3
+#define	C_SPIS_CTRL_READY_MASK_NOOFST			0x1
+#define	C_SPIS_CTRL_READY_MASK					( C_SPIS_CTRL_READY_MASK_NOOFST << C_SPIS_CTRL_READY_OFST )
+
+typedef struct
+{
+	/** Offset 0x00000000 - TX data register */
+	uint32_t									tx;
+	/** Offset 0x00000004 - RX data register */
+	uint32_t									rx;
+	/** Offset 0x00000008 - Control register */
+	uint32_t									ctrl;
+	/** Offset 0x0000000c - Status register */
+	uint32_t									status;
+
+} t_reg_spis;
+
+/** QSPI master (boot flash) **************************************************/
+/** Serial clock divisor : Fsck = Fin / ( 2 * ( div + 1 ) ) */
+#define	C_QSPI_SCKDIV_DIV_OFST					0
+#define	C_QSPI_SCKDIV_DIV_MASK_NOOFST			0xfff
+#define	C_QSPI_SCKDIV_DIV_MASK					( C_QSPI_SCKDIV_DIV_MASK_NOOFST << C_QSPI_SCKDIV_DIV_OFST )
+/** Chip select mode */
+#define	C_QSPI_CSMODE_AUTO						0x0
+#define	C_QSPI_CSMODE_HOLD						0x2
+/** Frame format register */
+#define	C_QSPI_FMT_PROTO_OFST					0
+#define	C_QSPI_FMT_PROTO_MASK_NOOFST			0x3
+#define	C_QSPI_FMT_PROTO_MASK					( C_QSPI_FMT_PROTO_MASK_NOOFST << C_QSPI_FMT_PROTO_OFST )
+
+#define	C_QSPI_FMT_DIR_OFST						3
+#define	C_QSPI_FMT_DIR_MASK_NOOFST				0x1
+#define	C_QSPI_FMT_DIR_MASK						( C_QSPI_FMT_DIR_MASK_NOOFST << C_QSPI_FMT_DIR_OFST )
+
+#define	C_QSPI_FMT_LEN_OFST						16
+#define	C_QSPI_FMT_LEN_MASK_NOOFST				0xf
+#define	C_QSPI_FMT_LEN_MASK						( C_QSPI_FMT_LEN_MASK_NOOFST << C_QSPI_FMT_LEN_OFST )
+/** Protocols */
+#define	C_QSPI_PROTO_SINGLE						0x0
+#define	C_QSPI_PROTO_DUAL						0x1
+#define	C_QSPI_PROTO_QUAD						0x2
+/** TX data register */
+#define	C_QSPI_TXDATA_FULL_OFST					31
+#define	C_QSPI_TXDATA_FULL_MASK_NOOFST			0x1
+#define	C_QSPI_TXDATA_FULL_MASK					( C_QSPI_TXDATA_FULL_MASK_NOOFST << C_QSPI_TXDATA_FULL_OFST )
+/** RX data register */
+#define	C_QSPI_RXDATA_DATA_OFST					0
+#define	C_QSPI_RXDATA_DATA_MASK_NOOFST			0xff
+#define	C_QSPI_RXDATA_DATA_MASK					( C_QSPI_RXDATA_DATA_MASK_NOOFST << C_QSPI_RXDATA_DATA_OFST )
+
+#define	C_QSPI_RXDATA_EMPTY_OFST				31
+#define	C_QSPI_RXDATA_EMPTY_MASK_NOOFST			0x1
+#define	C_QSPI_RXDATA_EMPTY_MASK				( C_QSPI_RXDATA_EMPTY_MASK_NOOFST << C_QSPI_RXDATA_EMPTY_OFST )
+/** Flash interface control register */
+#define	C_QSPI_FCTRL_EN_OFST					0
+#define	C_QSPI_FCTRL_EN_MASK_NOOFST				0x1
+#define	C_QSPI_FCTRL_EN_MASK					( C_QSPI_FCTRL_EN_MASK_NOOFST << C_QSPI_FCTRL_EN_OFST )
+/** Flash instruction format register */
+#define	C_QSPI_FFMT_CMD_EN_OFST					0
+#define	C_QSPI_FFMT_CMD_EN_MASK_NOOFST			0x1
+#define	C_QSPI_FFMT_CMD_EN_MASK					( C_QSPI_FFMT_CMD_EN_MASK_NOOFST << C_QSPI_FFMT_CMD_EN_OFST )
+
+#define	C_QSPI_FFMT_ADDR_LEN_OFST				1
+#define	C_QSPI_FFMT_ADDR_LEN_MASK_NOOFST		0x7
+#define	C_QSPI_FFMT_ADDR_LEN_MASK				( C_QSPI_FFMT_ADDR_LEN_MASK_NOOFST << C_QSPI_FFMT_ADDR_LEN_OFST )
+
+#define	C_QSPI_FFMT_PAD_CNT_OFST				4
+#define	C_QSPI_FFMT_PAD_CNT_MASK_NOOFST			0xf
+#define	C_QSPI_FFMT_PAD_CNT_MASK				( C_QSPI_FFMT_PAD_CNT_MASK_NOOFST << C_QSPI_FFMT_PAD_CNT_OFST )
+
+#define	C_QSPI_FFMT_CMD_PROTO_OFST				8
+#define	C_QSPI_FFMT_ADDR_PROTO_OFST				10
+#define	C_QSPI_FFMT_DATA_PROTO_OFST				12
+#define	C_QSPI_FFMT_PROTO_MASK_NOOFST			0x3
+
+#define	C_QSPI_FFMT_CMD_CODE_OFST				16
+#define	C_QSPI_FFMT_CMD_CODE_MASK_NOOFST		0xff
+#define	C_QSPI_FFMT_CMD_CODE_MASK				( C_QSPI_FFMT_CMD_CODE_MASK_NOOFST << C_QSPI_FFMT_CMD_CODE_OFST )
+
+typedef struct
+{
+	/** Offset 0x00000000 - Serial clock divisor */
+	uint32_t									sckdiv;
+	/** Offset 0x00000004 - Serial clock mode */
+	uint32_t									sckmode;
+	uint32_t									reserved0[2];
+	/** Offset 0x00000010 - Chip select ID */
+	uint32_t									csid;
+	/** Offset 0x00000014 - Chip select default */
+	uint32_t									csdef;
+	/** Offset 0x00000018 - Chip select mode */
+	uint32_t									csmode;
+	uint32_t									reserved1[3];
+	/** Offset 0x00000028 - Delay control */
+	uint32_t									delay0;
+	uint32_t									delay1;
+	uint32_t									reserved2[4];
+	/** Offset 0x00000040 - Frame format */
+	uint32_t									fmt;
+	uint32_t									reserved3;
+	/** Offset 0x00000048 - TX data register */
+	uint32_t									txdata;
+	/** Offset 0x0000004c - RX data register */
+	uint32_t									rxdata;
+	/** Offset 0x00000050 - Watermarks */
+	uint32_t									txmark;
+	uint32_t									rxmark;
+	uint32_t									reserved4[2];
+	/** Offset 0x00000060 - Flash interface control */
+	uint32_t									fctrl;
+	/** Offset 0x00000064 - Flash instruction format */
+	uint32_t									ffmt;
+	uint32_t									reserved5[2];
+	/** Offset 0x00000070 - Interrupts */
+	uint32_t									ie;
+	uint32_t									ip;
+
+} t_reg_qspi;
+
+/** SD Host Controller (eMMC) *************************************************/
+/** Command register */
+#define	C_SDHCI_CMD_RESP_NONE					0x0
+#define	C_SDHCI_CMD_RESP_136					0x1
+#define	C_SDHCI_CMD_RESP_48						0x2
+#define	C_SDHCI_CMD_RESP_48_BUSY				0x3
+#define	C_SDHCI_CMD_CRC_CHECK_MASK				( 0x1 << 3 )
+#define	C_SDHCI_CMD_INDEX_CHECK_MASK			( 0x1 << 4 )
+#define	C_SDHCI_CMD_DATA_PRESENT_MASK			( 0x1 << 5 )
+#define	C_SDHCI_CMD_INDEX_OFST					8
+/** Transfer mode register */
+#define	C_SDHCI_XFER_DMA_EN_MASK				( 0x1 << 0 )
+#define	C_SDHCI_XFER_BLKCNT_EN_MASK				( 0x1 << 1 )
+#define	C_SDHCI_XFER_AUTO_CMD12_MASK			( 0x1 << 2 )
+#define	C_SDHCI_XFER_READ_MASK					( 0x1 << 4 )
+#define	C_SDHCI_XFER_MULTI_BLOCK_MASK			( 0x1 << 5 )
+/** Present state register */
+#define	C_SDHCI_PRESENT_CMD_INHIBIT_MASK		( 0x1 << 0 )
+#define	C_SDHCI_PRESENT_DAT_INHIBIT_MASK		( 0x1 << 1 )
+/** Host control 1 register */
+#define	C_SDHCI_HOST_CTRL1_HIGH_SPEED_MASK		( 0x1 << 2 )
+#define	C_SDHCI_HOST_CTRL1_DMA_OFST				3
+#define	C_SDHCI_HOST_CTRL1_DMA_MASK_NOOFST		0x3
+#define	C_SDHCI_HOST_CTRL1_DMA_MASK				( C_SDHCI_HOST_CTRL1_DMA_MASK_NOOFST << C_SDHCI_HOST_CTRL1_DMA_OFST )
+#define	C_SDHCI_HOST_CTRL1_DMA_ADMA2_32			0x2
+#define	C_SDHCI_HOST_CTRL1_8BIT_MASK			( 0x1 << 5 )
+/** Power control register : 3.3V and bus power on */
+#define	C_SDHCI_POWER_3V3_ON					0x0f
+/** Clock control register */
+#define	C_SDHCI_CLOCK_INT_EN_MASK				( 0x1 << 0 )
+#define	C_SDHCI_CLOCK_INT_STABLE_MASK			( 0x1 << 1 )
+#define	C_SDHCI_CLOCK_SD_EN_MASK				( 0x1 << 2 )
+#define	C_SDHCI_CLOCK_DIV_LOW_OFST				8
+#define	C_SDHCI_CLOCK_DIV_HIGH_OFST				6
+#define	C_SDHCI_CLOCK_DIV_MAX					0x3ff
+/** Software reset register */
+#define	C_SDHCI_RESET_ALL_MASK					( 0x1 << 0 )
+/** Normal interrupt status register */
+#define	C_SDHCI_INT_CMD_COMPLETE_MASK			( 0x1 << 0 )
+#define	C_SDHCI_INT_XFER_COMPLETE_MASK			( 0x1 << 1 )
+#define	C_SDHCI_INT_BUF_READ_READY_MASK			( 0x1 << 5 )
+#define	C_SDHCI_INT_ERROR_MASK					( 0x1 << 15 )
+/** Host control 2 register */
+#define	C_SDHCI_HOST_CTRL2_UHS_MASK				0x7
+#define	C_SDHCI_HOST_CTRL2_UHS_SDR104			0x3
+#define	C_SDHCI_HOST_CTRL2_1V8_MASK				( 0x1 << 3 )
+#define	C_SDHCI_HOST_CTRL2_EXEC_TUNING_MASK		( 0x1 << 6 )
+#define	C_SDHCI_HOST_CTRL2_SAMPLING_CLK_MASK	( 0x1 << 7 )
+/** Capabilities registers */
+#define	C_SDHCI_CAPS0_BASE_CLK_OFST				8
+#define	C_SDHCI_CAPS0_BASE_CLK_MASK_NOOFST		0xff
+#define	C_SDHCI_CAPS0_BASE_CLK_MASK				( C_SDHCI_CAPS0_BASE_CLK_MASK_NOOFST << C_SDHCI_CAPS0_BASE_CLK_OFST )
+#define	C_SDHCI_CAPS0_ADMA2_MASK				( 0x1 << 19 )
+#define	C_SDHCI_CAPS1_SDR104_MASK				( 0x1 << 1 )
+/** ADMA2 descriptor attributes */
+#define	C_SDHCI_ADMA2_VALID						( 0x1 << 0 )
+#define	C_SDHCI_ADMA2_END						( 0x1 << 1 )
+#define	C_SDHCI_ADMA2_ACT_TRAN					( 0x2 << 4 )
+/** Largest length of one descriptor, block multiple */
+#define	C_SDHCI_ADMA2_LENGTH_MAX				0xfe00
+
+typedef struct
+{
+	/** Offset 0x00000000 - SDMA address / argument 2 */
+	uint32_t									sdma_addr;
+	/** Offset 0x00000004 - Block size and count */
+	uint16_t									blksize;
+	uint16_t									blkcnt;
+	/** Offset 0x00000008 - Argument */
+	uint32_t									argument;
+	/** Offset 0x0000000c - Transfer mode and command */
+	uint16_t									xfer_mode;
+	uint16_t									command;
+	/** Offset 0x00000010 - Responses */
+	uint32_t									response[4];
+	/** Offset 0x00000020 - Buffer data port */
+	uint32_t									buffer;
+	/** Offset 0x00000024 - Present state */
+	uint32_t									present_state;
+	/** Offset 0x00000028 - Host control 1, power, block gap, wakeup */
+	uint8_t										host_ctrl1;
+	uint8_t										power_ctrl;
+	uint8_t										block_gap_ctrl;
+	uint8_t										wakeup_ctrl;
+	/** Offset 0x0000002c - Clock, timeout, software reset */
+	uint16_t									clock_ctrl;
+	uint8_t										timeout_ctrl;
+	uint8_t										sw_reset;
+	/** Offset 0x00000030 - Interrupt status */
+	uint16_t									norm_int_status;
+	uint16_t									err_int_status;
+	/** Offset 0x00000034 - Interrupt status enable */
+	uint16_t									norm_int_status_en;
+	uint16_t									err_int_status_en;
+	/** Offset 0x00000038 - Interrupt signal enable */
+	uint16_t									norm_int_signal_en;
+	uint16_t									err_int_signal_en;
+	/** Offset 0x0000003c - Auto CMD error status, host control 2 */
+	uint16_t									auto_cmd_err;
+	uint16_t									host_ctrl2;
+	/** Offset 0x00000040 - Capabilities */
+	uint32_t									capabilities[2];
+	/** Offset 0x00000048 - Maximum current capabilities */
+	uint32_t									max_current[2];
+	/** Offset 0x00000050 - Force event */
+	uint16_t									force_auto_cmd_err;
+	uint16_t									force_err;
+	/** Offset 0x00000054 - ADMA error status */
+	uint32_t									adma_err_status;
+	/** Offset 0x00000058 - ADMA system address */
+	uint32_t									adma_addr_lo;
+	uint32_t									adma_addr_hi;
+
+} t_reg_sdhci;
+
+/** ADMA2 32 bits addressing descriptor */
+typedef struct __attribute__((packed))
+{
+	uint16_t									attr;
+	uint16_t									length;
+	uint32_t									address;
+
+} t_sdhci_adma2_desc;
+
 
 /** Security Descriptor */
 typedef struct __attribute__((packed))
@@ -468,6 +740,21 @@ int_pltfrm context_initialization(t_context *p_ctx);
 #define	M_WHOIS_MAX(_a_, _b_)				(( _a_ < _b_ ) ? _b_ : _a_)
 #define	M_WHOIS_MIN(_a_, _b_)				(( _a_ < _b_ ) ? _a_ : _b_)
 
+/** Core specific instructions, emulated by HAL stub layer in Host build */
+#ifdef _HOST_NATIVE_
+#define	M_CSR_READ(_csr_, _var_)			( (_var_) = metal_host_csr_read(#_csr_) )
+#define	M_FENCE_IO()						__sync_synchronize()
+#define	M_FENCE_RW()						__sync_synchronize()
+#define	M_NAKED
+#define	M_PLATFORM_ADDR(_addr_)				metal_host_platform_addr((uint64_t)(_addr_))
+#else
+#define	M_CSR_READ(_csr_, _var_)			__asm__ volatile("csrr %0, " #_csr_ : "=r"(_var_))
+#define	M_FENCE_IO()						__asm__ __volatile__ ("fence io, io")
+#define	M_FENCE_RW()						__asm__ __volatile__ ("fence rw, rw")
+#define	M_NAKED								__attribute__((naked))
+#define	M_PLATFORM_ADDR(_addr_)				(_addr_)
+#endif /* _HOST_NATIVE_ */
+
 #endif /* INCLUDE_COMMON_H_ */
 
 /******************************************************************************/
@@ -263,35 +263,104 @@ extern const uint32_t otp_private[];
 #define	C_OTP_APP_REFV_AREA_OFST				C_OTP_CSK_END_OFST
 #define	C_OTP_APP_REFV_ELMNT_SIZE				C_OTP_BASIC_ELMNT_SIZE
 
-/**  Offset 0x09ec */
+/**  Offset 0x09e8 */
 #define	C_OTP_APP_REFV1_OFST					C_OTP_APP_REFV_AREA_OFST
 #define	C_OTP_APP_REFV1_SIZE					C_OTP_APP_REFV_ELMNT_SIZE
 #define	C_OTP_APP_REFV1_END_OFST				( C_OTP_APP_REFV1_OFST + C_OTP_APP_REFV1_SIZE )
-/**  Offset 0x09f0 */
+/**  Offset 0x09ec */
 #define	C_OTP_APP_REFV2_OFST					C_OTP_APP_REFV1_END_OFST
 #define	C_OTP_APP_REFV2_SIZE					C_OTP_APP_REFV_ELMNT_SIZE
 #define	C_OTP_APP_REFV2_END_OFST				( C_OTP_APP_REFV2_OFST + C_OTP_APP_REFV2_SIZE )
-/**  Offset 0x09f4 */
+/**  Offset 0x09f0 */
 #define	C_OTP_APP_REFV3_OFST					C_OTP_APP_REFV2_END_OFST
 #define	C_OTP_APP_REFV3_SIZE					C_OTP_APP_REFV_ELMNT_SIZE
 #define	C_OTP_APP_REFV3_END_OFST				( C_OTP_APP_REFV3_OFST + C_OTP_APP_REFV3_SIZE )
-/**  Offset 0x09f8 */
+/**  Offset 0x09f4 */
 #define	C_OTP_APP_REFV4_OFST					C_OTP_APP_REFV3_END_OFST
 #define	C_OTP_APP_REFV4_SIZE					C_OTP_APP_REFV_ELMNT_SIZE
 #define	C_OTP_APP_REFV4_END_OFST				( C_OTP_APP_REFV4_OFST + C_OTP_APP_REFV4_SIZE )
-/**  Offset 0x09fc */
+/**  Offset 0x09f8 */
 #define	C_OTP_APP_REFV5_OFST					C_OTP_APP_REFV4_END_OFST
 #define	C_OTP_APP_REFV5_SIZE					C_OTP_APP_REFV_ELMNT_SIZE
 #define	C_OTP_APP_REFV5_END_OFST				( C_OTP_APP_REFV5_OFST + C_OTP_APP_REFV5_SIZE )
-/**  Offset 0x0a00 */
+/**  Offset 0x09fc */
 #define	C_OTP_APP_REFV6_OFST					C_OTP_APP_REFV5_END_OFST
 #define	C_OTP_APP_REFV6_SIZE					C_OTP_APP_REFV_ELMNT_SIZE
 #define	C_OTP_APP_REFV6_END_OFST				( C_OTP_APP_REFV6_OFST + C_OTP_APP_REFV6_SIZE )
 
 #define	C_OTP_APP_REFV_END_OFST					C_OTP_APP_REFV6_END_OFST
-
-#define	C_OTP_LAST_APP_REFV_OFST				( C_OTP_APP_REFV_END_OFST - C_OTP_APP_REFV_ELMNT_SIZE )
-#define C_OTP_NB_APP_REFV_SLOTS					( ( C_OTP_APP_REFV_END_OFST - C_OTP_APP_REFV_AREA_OFST ) / C_OTP_APP_REFV_ELMNT_SIZE )
+#define C_OTP_NB_APP_REFV_BASE_SLOTS			( ( C_OTP_APP_REFV_END_OFST - C_OTP_APP_REFV_AREA_OFST ) / C_OTP_APP_REFV_ELMNT_SIZE )
+
+/** SUP bus selection - 0x0a00 ************************************************/
+#define	C_OTP_SUP_BUS_OFST						C_OTP_APP_REFV_END_OFST
+#define	C_OTP_SUP_BUS_SIZE						C_OTP_BASIC_ELMNT_SIZE
+#define	C_OTP_SUP_BUS_END_OFST					( C_OTP_SUP_BUS_OFST + C_OTP_SUP_BUS_SIZE )
+/** Offset in bits : UART is used unless whole word holds SPI pattern */
+#define	C_OTP_SUP_BUS_SPI_NOOFST				0x5a0000a5UL
+
+/** Image decryption key - AES-128 uses first half - 0x0a04 ******************/
+#define	C_OTP_IMG_KEY_OFST						C_OTP_SUP_BUS_END_OFST
+#define	C_OTP_IMG_KEY_SIZE						C_AES256_SIZE
+#define	C_OTP_IMG_KEY_END_OFST					( C_OTP_IMG_KEY_OFST + C_OTP_IMG_KEY_SIZE )
+
+/** Boot flash read mode hint, written at provisioning only - 0x0a24 *********/
+#define	C_OTP_QSPI_CFG_OFST						C_OTP_IMG_KEY_END_OFST
+#define	C_OTP_QSPI_CFG_SIZE						C_OTP_BASIC_ELMNT_SIZE
+#define	C_OTP_QSPI_CFG_END_OFST					( C_OTP_QSPI_CFG_OFST + C_OTP_QSPI_CFG_SIZE )
+/** Offset in bits */
+#define	C_OTP_QSPI_CFG_CMD_OFST					0
+#define	C_OTP_QSPI_CFG_CMD_MASK_NOOFST			0xff
+#define	C_OTP_QSPI_CFG_CMD_MASK					( C_OTP_QSPI_CFG_CMD_MASK_NOOFST << C_OTP_QSPI_CFG_CMD_OFST )
+
+#define	C_OTP_QSPI_CFG_PAD_CNT_OFST				8
+#define	C_OTP_QSPI_CFG_PAD_CNT_MASK_NOOFST		0xf
+#define	C_OTP_QSPI_CFG_PAD_CNT_MASK				( C_OTP_QSPI_CFG_PAD_CNT_MASK_NOOFST << C_OTP_QSPI_CFG_PAD_CNT_OFST )
+
+#define	C_OTP_QSPI_CFG_PROTO_OFST				12
+#define	C_OTP_QSPI_CFG_PROTO_MASK_NOOFST		0x3
+#define	C_OTP_QSPI_CFG_PROTO_MASK				( C_OTP_QSPI_CFG_PROTO_MASK_NOOFST << C_OTP_QSPI_CFG_PROTO_OFST )
+
+#define	C_OTP_QSPI_CFG_SCKDIV_OFST				16
+#define	C_OTP_QSPI_CFG_SCKDIV_MASK_NOOFST		0xfff
+#define	C_OTP_QSPI_CFG_SCKDIV_MASK				( C_OTP_QSPI_CFG_SCKDIV_MASK_NOOFST << C_OTP_QSPI_CFG_SCKDIV_OFST )
+
+#define	C_OTP_QSPI_CFG_VALID_OFST				28
+#define	C_OTP_QSPI_CFG_VALID_MASK_NOOFST		0xf
+#define	C_OTP_QSPI_CFG_VALID_MASK				( C_OTP_QSPI_CFG_VALID_MASK_NOOFST << C_OTP_QSPI_CFG_VALID_OFST )
+#define	C_OTP_QSPI_CFG_VALID_NOOFST				0x5
+
+/** Seed of boot-session MAC keys - 0x0a28 ************************************/
+/** Not protected by ROM : platform must block reads of this field once ROM is done */
+#define	C_OTP_BOOT_MAC_SEED_OFST				C_OTP_QSPI_CFG_END_OFST
+#define	C_OTP_BOOT_MAC_SEED_SIZE				0x20
+#define	C_OTP_BOOT_MAC_SEED_END_OFST			( C_OTP_BOOT_MAC_SEED_OFST + C_OTP_BOOT_MAC_SEED_SIZE )
+
+/** Boot devices probing order - 0x0a48 ***************************************/
+#define	C_OTP_BOOT_ORDER_OFST					C_OTP_BOOT_MAC_SEED_END_OFST
+#define	C_OTP_BOOT_ORDER_SIZE					C_OTP_BASIC_ELMNT_SIZE
+#define	C_OTP_BOOT_ORDER_END_OFST				( C_OTP_BOOT_ORDER_OFST + C_OTP_BOOT_ORDER_SIZE )
+/** Offset in bits : one BOOTDEV pattern per entry, highest priority first, RFU0 ends list */
+#define	C_OTP_BOOT_ORDER_ENTRY_NB				4
+#define	C_OTP_BOOT_ORDER_ENTRY_WIDTH			2
+#define	C_OTP_BOOT_ORDER_ENTRY_MASK_NOOFST		C_OTP_BOOTDEV_PATTERN_MASK_NOOFST
+
+#define	C_OTP_BOOT_ORDER_VALID_OFST				28
+#define	C_OTP_BOOT_ORDER_VALID_MASK_NOOFST		0xf
+#define	C_OTP_BOOT_ORDER_VALID_MASK				( C_OTP_BOOT_ORDER_VALID_MASK_NOOFST << C_OTP_BOOT_ORDER_VALID_OFST )
+#define	C_OTP_BOOT_ORDER_VALID_NOOFST			0x5
+
+#ifdef _WITH_SLBV_REFV_EXTENDED_AREA_
+/** Extended Application's Reference Version area - 0x0a4c ********************/
+/** Slots following the six ones above, at the end of the map so that no other
+ * field moves */
+#define	C_OTP_APP_REFV_EXT_OFST					C_OTP_BOOT_ORDER_END_OFST
+#define	C_OTP_APP_REFV_EXT_NB_SLOTS				250
+#define	C_OTP_APP_REFV_EXT_END_OFST				( C_OTP_APP_REFV_EXT_OFST + ( C_OTP_APP_REFV_EXT_NB_SLOTS * C_OTP_APP_REFV_ELMNT_SIZE ) )
+
+#define C_OTP_NB_APP_REFV_SLOTS					( C_OTP_NB_APP_REFV_BASE_SLOTS + C_OTP_APP_REFV_EXT_NB_SLOTS )
+#else
+#define C_OTP_NB_APP_REFV_SLOTS					C_OTP_NB_APP_REFV_BASE_SLOTS
+#endif /* _WITH_SLBV_REFV_EXTENDED_AREA_ */
 
 #define C_OTP_APP_REFV_SLOT_MAX					( C_OTP_NB_APP_REFV_SLOTS - 1 )
 
@@ -307,6 +376,14 @@ extern const uint32_t otp_private[];
 /** Functions *****************************************************************/
 
 /** Macros ********************************************************************/
+/** OTP offset of Application's Reference Version slot */
+#ifdef _WITH_SLBV_REFV_EXTENDED_AREA_
+#define	M_OTP_APP_REFV_SLOT_OFST(_slot_)		( ( (uint_pltfrm)(_slot_) < C_OTP_NB_APP_REFV_BASE_SLOTS ) ? \
+													( C_OTP_APP_REFV_AREA_OFST + ( (uint_pltfrm)(_slot_) * C_OTP_APP_REFV_ELMNT_SIZE ) ) : \
+													( C_OTP_APP_REFV_EXT_OFST + ( ( (uint_pltfrm)(_slot_) - C_OTP_NB_APP_REFV_BASE_SLOTS ) * C_OTP_APP_REFV_ELMNT_SIZE ) ) )
+#else
+#define	M_OTP_APP_REFV_SLOT_OFST(_slot_)		( C_OTP_APP_REFV_AREA_OFST + ( (uint_pltfrm)(_slot_) * C_OTP_APP_REFV_ELMNT_SIZE ) )
+#endif /* _WITH_SLBV_REFV_EXTENDED_AREA_ */
 
 #endif /* _OTP_MAPPING_H_ */
 
@@ -19,6 +19,17 @@ __CLIST_DEFINITIONS = -D_FPGA_SPECIFIC_ \
 						-D_TEST_KEYS_ \
 						-D_WITHOUT_SELFTESTS_ \
 						-D_LIFE_CYCLE_PHASE1_ \
+						-D_WITH_SUP_BATCH_ \
+						-D_WITH_SUP_APPLET_CACHE_ \
+						-D_WITH_SUP_FRAGMENTATION_ \
+						-D_WITH_SLBV_CHUNKED_IMAGE_ \
+						-D_WITH_SLBV_MULTI_HART_ \
+						-D_WITH_SLBV_COMPRESSED_IMAGE_ \
+						-D_WITH_SLBV_ENCRYPTED_IMAGE_ \
+						-D_WITH_SLBV_MANIFEST_ \
+						-D_WITH_SLBV_REFV_EXTENDED_AREA_ \
+						-D_WITH_SLBV_QSPI_PERF_ \
+						-D_WITH_SLBV_HEADER_V2_ \
 						-DCOREIP_MEM_WIDTH=$(COREIP_MEM_WIDTH) \
 						-DMAJOR_VERSION=$(__MAJOR_VERSION) \
 						-DMINOR_VERSION=$(__MINOR_VERSION) \
@@ -34,6 +45,15 @@ __ALIST_DEFINITIONS =
 ## C code
 __CLIST_UNDEFINITIONS = -USCL_WORD32 \
 						-U_WITH_QEMU_ \
+						-U_WITH_SUP_LOOPBACK_ \
+						-U_WITH_SUP_SPI_SLAVE_ \
+						-U_WITH_SLBV_AB_SLOTS_ \
+						-U_WITH_SLBV_EMMC_ \
+						-U_WITH_SLBV_LAZY_XIP_ \
+						-U_WITH_SLBV_INCREMENTAL_ \
+						-U_WITH_SLBV_WARM_RESET_ \
+						-U_WITH_SLBV_BOOT_PROBE_ \
+						-U_WITH_SBRM_PROFILING_ \
 						-U_WITH_PATCH_MGNT_ \
 						-U_LIFE_CYCLE_PHASE2_ \
 						-U_WITH_RMA_MODE_ON_ \
@@ -41,7 +61,9 @@ __CLIST_UNDEFINITIONS = -USCL_WORD32 \
 						-U_WITH_128BITS_ADDRESSING_ \
 						-U_WITH_BOOT_ADDR_ \
 						-U_DBG_DEVEL_ \
-						-U_DBG_BEACON_
+						-U_DBG_BEACON_ \
+						-U_WITH_SBRM_BENCH_ \
+						-U_WITH_SBRM_SELFTEST_ONLY_
 ## Assembly code
 __ALIST_UNDEFINITIONS =
 
@@ -0,0 +1,482 @@
+#!/usr/bin/env python3
+# Copyright 2020 SiFive, Inc #
+# SPDX-License-Identifier: MIT #
+
+"""Boot-time regression harness : runs Secure BootRom under QEMU.
+
+ROM must be built with _WITH_QEMU_ and _WITH_SBRM_PROFILING_, for a QEMU
+machine memory map (sifive_e for 32 bits, sifive_u for 64 bits). QEMU runs
+with '-icount shift=0', so minstret values in boot profile ring are numbers
+of instructions retired. Ring is read through QEMU gdb stub.
+
+Two sessions, each one from reset :
+ - boot : OTP blob and QSPI image are loaded, boot flow must reach jump.
+ - sup  : SUP capture is written on UART through a pty, cost of each packet
+          is taken from SUP_PACKET / SUP_PACKET_END marks.
+
+Results are compared to a baseline file : exit status is 1 when a metric
+exceeds its baseline by more than tolerance or has no baseline, 2 when a
+session fails.
+"""
+
+import argparse
+import json
+import os
+import select
+import socket
+import struct
+import subprocess
+import sys
+import time
+import tty
+
+## Boot profile stages - e_sbrm_prof_stage, include/api/sbrm/sbrm.h
+STAGES = [
+	'RESET',
+	'CONTEXT_INIT',
+	'SBRM_INIT',
+	'PPM_INIT',
+	'SP_INIT',
+	'KM_INIT',
+	'SLBV_INIT',
+	'SELFTEST',
+	'KM_CHECK_KEY',
+	'KM_CHECK_KEY_END',
+	'HEADER_CHECK',
+	'SHA',
+	'SHA_END',
+	'ECDSA',
+	'ECDSA_END',
+	'COPY',
+	'COPY_END',
+	'JUMP',
+	'WARM_JUMP',
+	'SUP_PACKET',
+	'SUP_PACKET_END',
+]
+STAGE = {name: value for value, name in enumerate(STAGES)}
+
+## Boot profile ring - t_sbrm_prof_ring, packed, little endian
+PROF_MAGIC = 0x31465250
+PROF_HEADER = struct.Struct('<IIII')
+PROF_ENTRY = struct.Struct('<IIQQ')
+
+## MSEL register, read by ROM to select boot mode
+MSEL_ADDR = 0x1000
+
+## Metrics checked against baseline : instructions retired
+METRICS = ('boot_to_jump', 'sup_packet_mean', 'sup_packet_max')
+
+## Machine defaults, by ELF class
+MACHINES = {
+	32: {'qemu': 'qemu-system-riscv32', 'machine': 'sifive_e', 'smp': 1},
+	64: {'qemu': 'qemu-system-riscv64', 'machine': 'sifive_u', 'smp': 2},
+}
+
+
+class HarnessError(Exception):
+	pass
+
+
+def elf_read(path):
+	"""Return ELF class (32/64), entry point and symbol table."""
+	with open(path, 'rb') as f:
+		data = f.read()
+	if data[:4] != b'\x7fELF' or data[5] != 1:
+		raise HarnessError('%s : not a little endian ELF file' % path)
+	if data[4] == 2:
+		width = 64
+		entry, shoff = struct.unpack_from('<Q8xQ', data, 0x18)
+		shentsize, shnum = struct.unpack_from('<HH', data, 0x3a)
+		section = struct.Struct('<IIQQQQIIQQ')
+		symbol = struct.Struct('<IBBHQQ')
+	else:
+		width = 32
+		entry, shoff = struct.unpack_from('<I4xI', data, 0x18)
+		shentsize, shnum = struct.unpack_from('<HH', data, 0x2e)
+		section = struct.Struct('<IIIIIIIIII')
+		symbol = struct.Struct('<IIIBBH')
+	sections = [section.unpack_from(data, shoff + i * shentsize) for i in range(shnum)]
+	symbols = {}
+	for sh in sections:
+		## SHT_SYMTAB
+		if sh[1] != 2:
+			continue
+		strtab = sections[sh[6]]
+		str_offset = strtab[4]
+		for offset in range(sh[4], sh[4] + sh[5], symbol.size):
+			fields = symbol.unpack_from(data, offset)
+			if width == 64:
+				name, value = fields[0], fields[4]
+			else:
+				name, value = fields[0], fields[1]
+			if not name:
+				continue
+			end = data.index(b'\0', str_offset + name)
+			symbols[data[str_offset + name:end].decode()] = value
+	return width, entry, symbols
+
+
+class GdbRemote:
+	"""Minimal client of GDB remote serial protocol, as served by QEMU."""
+
+	def __init__(self, port, timeout):
+		deadline = time.time() + timeout
+		while True:
+			try:
+				self.sock = socket.create_connection(('127.0.0.1', port), timeout=timeout)
+				break
+			except OSError:
+				if time.time() > deadline:
+					raise HarnessError('gdb stub not reachable on port %d' % port)
+				time.sleep(0.1)
+		self.buffer = b''
+
+	def _read_byte(self):
+		if not self.buffer:
+			self.buffer = self.sock.recv(4096)
+			if not self.buffer:
+				raise HarnessError('gdb stub closed connection')
+		byte, self.buffer = self.buffer[:1], self.buffer[1:]
+		return byte
+
+	def _receive(self):
+		while self._read_byte() != b'$':
+			pass
+		payload = b''
+		while True:
+			byte = self._read_byte()
+			if byte == b'#':
+				break
+			if byte == b'}':
+				byte = bytes([self._read_byte()[0] ^ 0x20])
+			elif byte == b'*':
+				## Run length encoding : repeat previous character
+				payload += payload[-1:] * (self._read_byte()[0] - 29)
+				continue
+			payload += byte
+		self._read_byte()
+		self._read_byte()
+		self.sock.sendall(b'+')
+		return payload.decode('ascii')
+
+	def _send(self, payload):
+		data = payload.encode('ascii')
+		packet = b'$' + data + b'#%02x' % (sum(data) & 0xff)
+		while True:
+			self.sock.sendall(packet)
+			ack = self._read_byte()
+			while ack not in (b'+', b'-'):
+				ack = self._read_byte()
+			if ack == b'+':
+				return
+
+	def command(self, payload):
+		self._send(payload)
+		reply = self._receive()
+		if reply.startswith('E'):
+			raise HarnessError('gdb stub : %s -> %s' % (payload[:24], reply))
+		return reply
+
+	def read_memory(self, addr, size):
+		data = b''
+		while len(data) < size:
+			length = min(1024, size - len(data))
+			data += bytes.fromhex(self.command('m%x,%x' % (addr + len(data), length)))
+		return data
+
+	def write_memory(self, addr, data):
+		for offset in range(0, len(data), 1024):
+			chunk = data[offset:offset + 1024]
+			self.command('M%x,%x:%s' % (addr + offset, len(chunk), chunk.hex()))
+
+	def resume(self):
+		self._send('c')
+
+	def interrupt(self):
+		self.sock.sendall(b'\x03')
+		## Stop reply
+		return self._receive()
+
+	def close(self):
+		try:
+			self.sock.sendall(b'$k#6b')
+		except OSError:
+			pass
+		self.sock.close()
+
+
+class ProfileLog:
+	"""Boot profile marks, gathered across ring reads."""
+
+	def __init__(self, addr):
+		self.addr = addr
+		self.marks = {}
+
+	def update(self, gdb):
+		magic, nb_entries, count, _ = PROF_HEADER.unpack(gdb.read_memory(self.addr, PROF_HEADER.size))
+		if magic != PROF_MAGIC or not nb_entries:
+			return 0
+		data = gdb.read_memory(self.addr + PROF_HEADER.size, nb_entries * PROF_ENTRY.size)
+		new = 0
+		for seq in range(max(0, count - nb_entries), count):
+			if seq in self.marks:
+				continue
+			stage, hartid, mcycle, minstret = PROF_ENTRY.unpack_from(data, (seq % nb_entries) * PROF_ENTRY.size)
+			self.marks[seq] = (stage, hartid, mcycle, minstret)
+			new += 1
+		return new
+
+	def ordered(self):
+		return [self.marks[seq] for seq in sorted(self.marks)]
+
+	def has(self, *stages):
+		return any(mark[0] in stages for mark in self.marks.values())
+
+
+def free_port():
+	with socket.socket() as sock:
+		sock.bind(('127.0.0.1', 0))
+		return sock.getsockname()[1]
+
+
+def run_session(args, kind, entry, symbols):
+	"""Run one QEMU session, return profile marks and SUP output size."""
+	port = free_port()
+	master, slave = os.openpty()
+	tty.setraw(slave)
+	os.set_blocking(master, False)
+	qemu = [args.qemu,
+			'-M', args.machine,
+			'-smp', str(args.smp),
+			'-bios', 'none',
+			'-display', 'none',
+			'-monitor', 'none',
+			'-icount', 'shift=0,align=off,sleep=off',
+			'-chardev', 'serial,id=sup,path=%s' % os.ttyname(slave),
+			'-serial', 'chardev:sup',
+			'-device', 'loader,file=%s,cpu-num=0' % args.elf,
+			'-gdb', 'tcp:127.0.0.1:%d' % port,
+			'-S']
+	## Secondary harts start at ROM entry too, ROM parks them
+	for hart in range(1, args.smp):
+		qemu += ['-device', 'loader,addr=0x%x,cpu-num=%d' % (entry, hart)]
+	if kind == 'boot' and args.qspi:
+		qemu += ['-device', 'loader,file=%s,addr=0x%x,force-raw=on' % (args.qspi, symbols['__qspi_start'])]
+	if args.verbose:
+		print(' '.join(qemu), file=sys.stderr)
+	process = subprocess.Popen(qemu, stdin=subprocess.DEVNULL)
+	gdb = None
+	log = ProfileLog(symbols['__sbr_profile_start_addr'])
+	sup_rx = b''
+	try:
+		gdb = GdbRemote(port, args.timeout)
+		gdb.command('?')
+		## Platform state, ahead of first instruction
+		if args.otp:
+			with open(args.otp, 'rb') as f:
+				gdb.write_memory(symbols['__otp_start'], f.read())
+		if args.msel is not None:
+			gdb.write_memory(MSEL_ADDR, struct.pack('<I', args.msel))
+		pending = b''
+		if kind == 'sup':
+			with open(args.sup, 'rb') as f:
+				pending = f.read()
+		deadline = time.time() + args.timeout
+		idle_since = time.time()
+		gdb.resume()
+		while True:
+			## Feed SUP capture and drain answers, while target runs
+			stop = time.time() + args.poll
+			while time.time() < stop:
+				wlist = [master] if pending else []
+				readable, writable, _ = select.select([master], wlist, [], max(0.0, stop - time.time()))
+				if writable:
+					pending = pending[os.write(master, pending[:256]):]
+					idle_since = time.time()
+				if readable:
+					data = os.read(master, 4096)
+					sup_rx += data
+					idle_since = time.time()
+			gdb.interrupt()
+			if log.update(gdb):
+				idle_since = time.time()
+			if kind == 'boot' and log.has(STAGE['JUMP'], STAGE['WARM_JUMP']):
+				break
+			if kind == 'sup' and not pending and ( time.time() - idle_since ) > args.idle:
+				break
+			if process.poll() is not None:
+				raise HarnessError('QEMU exited with status %d' % process.returncode)
+			if time.time() > deadline:
+				raise HarnessError('%s session : timeout after %d s' % (kind, args.timeout))
+			gdb.resume()
+	finally:
+		if gdb:
+			gdb.close()
+		try:
+			process.wait(timeout=5)
+		except subprocess.TimeoutExpired:
+			process.kill()
+			process.wait()
+		os.close(master)
+		os.close(slave)
+	return log.ordered(), len(sup_rx)
+
+
+def stage_table(marks):
+	rows = []
+	previous = None
+	for stage, hartid, mcycle, minstret in marks:
+		name = STAGES[stage] if stage < len(STAGES) else 'STAGE_%d' % stage
+		delta = minstret - previous if previous is not None else 0
+		rows.append({'stage': name, 'hart': hartid, 'minstret': minstret, 'delta': delta})
+		previous = minstret
+	return rows
+
+
+def boot_metrics(marks):
+	start = next((m[3] for m in marks if m[0] == STAGE['RESET']), 0)
+	jump = next((m[3] for m in marks if m[0] in (STAGE['JUMP'], STAGE['WARM_JUMP'])), None)
+	if jump is None:
+		raise HarnessError('boot session : no jump mark in profile')
+	return {'boot_to_jump': jump - start}
+
+
+def sup_metrics(marks):
+	costs = []
+	begin = None
+	for stage, _, _, minstret in marks:
+		if stage == STAGE['SUP_PACKET']:
+			begin = minstret
+		elif stage == STAGE['SUP_PACKET_END'] and begin is not None:
+			costs.append(minstret - begin)
+			begin = None
+	if not costs:
+		raise HarnessError('sup session : no packet answered')
+	return {'sup_packets': len(costs),
+			'sup_packet_mean': sum(costs) // len(costs),
+			'sup_packet_max': max(costs)}
+
+
+def baseline_read(path, machine):
+	baseline = {}
+	if not os.path.exists(path):
+		return baseline
+	with open(path) as f:
+		for line in f:
+			fields = line.split('#', 1)[0].split()
+			if len(fields) == 3 and fields[0] == machine:
+				baseline[fields[1]] = int(fields[2])
+	return baseline
+
+
+def baseline_write(path, machine, metrics):
+	lines = []
+	if os.path.exists(path):
+		with open(path) as f:
+			for line in f:
+				fields = line.split('#', 1)[0].split()
+				## Measured values replace previous ones
+				if len(fields) == 3 and fields[0] == machine and fields[1] in metrics:
+					continue
+				lines.append(line)
+	for name in METRICS:
+		if name in metrics:
+			lines.append('%s %s %d\n' % (machine, name, metrics[name]))
+	with open(path, 'w') as f:
+		f.writelines(lines)
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+	parser.add_argument('elf', help='ROM ELF, built with _WITH_QEMU_ and _WITH_SBRM_PROFILING_')
+	parser.add_argument('--symbols', help='ELF holding symbols, <elf>_ori.elf by default when present')
+	parser.add_argument('--otp', help='OTP blob, written at __otp_start')
+	parser.add_argument('--qspi', help='boot flash image, loaded at __qspi_start : enables boot session')
+	parser.add_argument('--sup', help='SUP capture sent over UART : enables SUP session')
+	parser.add_argument('--msel', type=lambda v: int(v, 0), help='MSEL value')
+	parser.add_argument('--sup-msel', type=lambda v: int(v, 0), help='MSEL value for SUP session, --msel by default')
+	parser.add_argument('--qemu', help='QEMU binary, from ELF class by default')
+	parser.add_argument('--machine', help='QEMU machine, sifive_e or sifive_u from ELF class by default')
+	parser.add_argument('--smp', type=int, help='number of harts')
+	parser.add_argument('--baseline', default=os.path.join(os.path.dirname(os.path.abspath(__file__)), 'qemu_baseline.txt'))
+	parser.add_argument('--tolerance', type=float, default=2.0, help='allowed increase over baseline, in %% (default 2)')
+	parser.add_argument('--update', action='store_true', help='record measured values as baseline')
+	parser.add_argument('--json', help='write results to file')
+	parser.add_argument('--timeout', type=int, default=120, help='per session, in s')
+	parser.add_argument('--poll', type=float, default=0.2, help='profile ring read period, in s')
+	parser.add_argument('--idle', type=float, default=2.0, help='SUP session ends after this long without activity, in s')
+	parser.add_argument('--verbose', action='store_true')
+	args = parser.parse_args()
+
+	if not args.qspi and not args.sup:
+		parser.error('nothing to run : give --qspi and/or --sup')
+	if args.symbols is None:
+		args.symbols = args.elf + '_ori.elf' if os.path.exists(args.elf + '_ori.elf') else args.elf
+	try:
+		width, entry, _ = elf_read(args.elf)
+		_, _, symbols = elf_read(args.symbols)
+		for name in ('__otp_start', '__qspi_start', '__sbr_profile_start_addr'):
+			if name not in symbols:
+				raise HarnessError('%s : no symbol %s' % (args.symbols, name))
+		defaults = MACHINES[width]
+		args.qemu = args.qemu or defaults['qemu']
+		args.machine = args.machine or defaults['machine']
+		args.smp = args.smp or defaults['smp']
+
+		results = {'machine': args.machine, 'sessions': {}}
+		metrics = {}
+		if args.qspi:
+			marks, _ = run_session(args, 'boot', entry, symbols)
+			results['sessions']['boot'] = stage_table(marks)
+			metrics.update(boot_metrics(marks))
+		if args.sup:
+			if args.sup_msel is not None:
+				args.msel = args.sup_msel
+			marks, rx_size = run_session(args, 'sup', entry, symbols)
+			results['sessions']['sup'] = stage_table(marks)
+			results['sup_rx_size'] = rx_size
+			metrics.update(sup_metrics(marks))
+	except (HarnessError, OSError, KeyError) as e:
+		print('qemu-regress : %s' % e, file=sys.stderr)
+		return 2
+
+	for kind, rows in results['sessions'].items():
+		print('[%s] %-18s %4s %14s %12s' % (kind, 'stage', 'hart', 'minstret', 'delta'))
+		for row in rows:
+			print('[%s] %-18s %4d %14d %12d' % (kind, row['stage'], row['hart'], row['minstret'], row['delta']))
+
+	baseline = baseline_read(args.baseline, args.machine)
+	status = 0
+	results['metrics'] = {}
+	for name in METRICS:
+		if name not in metrics:
+			continue
+		value = metrics[name]
+		reference = baseline.get(name)
+		if not reference:
+			## Nothing to compare to is a failure, not a pass
+			verdict = 'NO BASELINE'
+			status = 1
+		else:
+			limit = reference * ( 1.0 + args.tolerance / 100.0 )
+			verdict = 'ok' if value <= limit else 'REGRESSION'
+			if value > limit:
+				status = 1
+		results['metrics'][name] = {'value': value, 'baseline': reference, 'verdict': verdict}
+		print('%-16s %12d  baseline %12s  %s' % (name, value, reference if reference else '-', verdict))
+	if 'sup_packets' in metrics:
+		print('%-16s %12d' % ('sup_packets', metrics['sup_packets']))
+
+	if args.json:
+		with open(args.json, 'w') as f:
+			json.dump(results, f, indent=1)
+	if args.update:
+		baseline_write(args.baseline, args.machine, metrics)
+		print('baseline updated : %s' % args.baseline)
+		status = 0
+	return status
+
+
+if __name__ == '__main__':
+	sys.exit(main())